@@ -0,0 +1 @@
+../../src/config_image.hpp
\ No newline at end of file
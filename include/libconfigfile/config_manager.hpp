@@ -0,0 +1 @@
+../../src/config_manager.hpp
\ No newline at end of file
@@ -0,0 +1 @@
+../../src/cow_node_ptr.hpp
\ No newline at end of file
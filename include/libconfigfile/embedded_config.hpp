@@ -0,0 +1 @@
+../../src/embedded_config.hpp
\ No newline at end of file
@@ -0,0 +1 @@
+../../src/event_parser.hpp
\ No newline at end of file
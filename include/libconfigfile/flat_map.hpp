@@ -0,0 +1 @@
+../../src/flat_map.hpp
\ No newline at end of file
@@ -0,0 +1 @@
+../../src/key_hash.hpp
\ No newline at end of file
@@ -0,0 +1 @@
+../../src/lazy_subtree.hpp
\ No newline at end of file
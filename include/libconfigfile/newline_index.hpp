@@ -0,0 +1 @@
+../../src/newline_index.hpp
\ No newline at end of file
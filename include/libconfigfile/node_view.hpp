@@ -0,0 +1 @@
+../../src/node_view.hpp
\ No newline at end of file
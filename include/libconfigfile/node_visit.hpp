@@ -0,0 +1 @@
+../../src/node_visit.hpp
\ No newline at end of file
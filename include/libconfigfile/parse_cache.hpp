@@ -0,0 +1 @@
+../../src/parse_cache.hpp
\ No newline at end of file
@@ -0,0 +1 @@
+../../src/parse_error.hpp
\ No newline at end of file
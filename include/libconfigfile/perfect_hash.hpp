@@ -0,0 +1 @@
+../../src/perfect_hash.hpp
\ No newline at end of file
@@ -0,0 +1 @@
+../../src/persistent_nodes.hpp
\ No newline at end of file
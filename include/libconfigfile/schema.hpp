@@ -0,0 +1 @@
+../../src/schema.hpp
\ No newline at end of file
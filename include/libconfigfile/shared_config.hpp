@@ -0,0 +1 @@
+../../src/shared_config.hpp
\ No newline at end of file
@@ -0,0 +1 @@
+../../src/source_map.hpp
\ No newline at end of file
@@ -0,0 +1 @@
+../../src/struct_decoder.hpp
\ No newline at end of file
@@ -0,0 +1 @@
+../../src/wire_format.hpp
\ No newline at end of file
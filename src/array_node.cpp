@@ -1,22 +1,34 @@
 #include "array_node.hpp"
 
 #include "character_constants.hpp"
+#include "lazy_subtree.hpp"
 #include "node.hpp"
 #include "node_ptr.hpp"
 #include "node_types.hpp"
 
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 libconfigfile::array_node::array_node() : base_t{} {}
 
 libconfigfile::array_node::array_node(const array_node &other)
-    : base_t{other} {}
+    : base_t{}, m_lazy{other.get_lazy_subtree()},
+      m_is_lazy{(m_lazy != nullptr)} {
+  if (m_lazy == nullptr) {
+    base_t::operator=(other);
+  }
+}
 
 libconfigfile::array_node::array_node(array_node &&other) noexcept(
     std::is_nothrow_move_constructible_v<base_t>)
-    : base_t{std::move(other)} {}
+    : base_t{std::move(other)} {
+  reset_lazy_subtree(std::move(other.m_lazy));
+  other.reset_lazy_subtree(nullptr);
+}
 
 libconfigfile::array_node::array_node(const base_t &other) : base_t{other} {}
 
@@ -41,7 +53,7 @@ libconfigfile::node_type libconfigfile::array_node::get_node_type() const {
 bool libconfigfile::array_node::polymorphic_value_compare(
     const node *other) const {
   if ((other->get_node_type()) == (node_type::Array)) {
-    return ((*(dynamic_cast<const array_node *>(other))) == (*this));
+    return ((*(static_cast<const array_node *>(other))) == (*this));
   } else {
     return false;
   }
@@ -52,7 +64,7 @@ std::string libconfigfile::array_node::serialize(
   std::string ret_val;
   ret_val += character_constants::k_array_opening_delimiter;
   for (auto p{this->begin()}; p != this->end(); ++p) {
-    ret_val += (*p)->serialize();
+    ret_val += node_serialize(**p);
 
     if ((p + 1) != this->end()) {
       ret_val += character_constants::k_array_element_separator;
@@ -70,41 +82,293 @@ std::ostream &libconfigfile::array_node::print(
   return out;
 }
 
+void libconfigfile::array_node::set_lazy_subtree(
+    std::shared_ptr<const lazy_subtree> lazy) {
+  base_t::clear();
+  reset_lazy_subtree(std::move(lazy));
+}
+
+bool libconfigfile::array_node::is_materialized() const {
+  return (m_is_lazy.load(std::memory_order_acquire) == false);
+}
+
+// The contents are parsed without holding the lock, so that it is never held
+// while other containers are accessed; if another thread finishes parsing them
+// first, its result is kept.
+void libconfigfile::array_node::materialize() const {
+  const std::shared_ptr<const lazy_subtree> lazy{get_lazy_subtree()};
+  if (lazy == nullptr) {
+    return;
+  }
+
+  array_node contents{};
+  lazy->materialize(contents);
+
+  const std::lock_guard<std::mutex> lock{impl::lazy_subtree_mutex(this)};
+  if (m_lazy != nullptr) {
+    const_cast<array_node &>(*this).base_t::operator=(
+        std::move(static_cast<base_t &>(contents)));
+    m_lazy = nullptr;
+    m_is_lazy.store(false, std::memory_order_release);
+  }
+}
+
+// Null once the contents have been parsed, after which they can be read
+// without the lock.
+std::shared_ptr<const libconfigfile::lazy_subtree>
+libconfigfile::array_node::get_lazy_subtree() const {
+  if (m_is_lazy.load(std::memory_order_acquire) == false) {
+    return nullptr;
+  }
+  const std::lock_guard<std::mutex> lock{impl::lazy_subtree_mutex(this)};
+  return m_lazy;
+}
+
+void libconfigfile::array_node::reset_lazy_subtree(
+    std::shared_ptr<const lazy_subtree> lazy) {
+  m_lazy = std::move(lazy);
+  m_is_lazy.store((m_lazy != nullptr), std::memory_order_release);
+}
+
+libconfigfile::array_node::iterator libconfigfile::array_node::begin() {
+  materialize();
+  return base_t::begin();
+}
+
+libconfigfile::array_node::const_iterator
+libconfigfile::array_node::begin() const {
+  materialize();
+  return base_t::begin();
+}
+
+libconfigfile::array_node::const_iterator
+libconfigfile::array_node::cbegin() const {
+  materialize();
+  return base_t::cbegin();
+}
+
+libconfigfile::array_node::iterator libconfigfile::array_node::end() {
+  materialize();
+  return base_t::end();
+}
+
+libconfigfile::array_node::const_iterator
+libconfigfile::array_node::end() const {
+  materialize();
+  return base_t::end();
+}
+
+libconfigfile::array_node::const_iterator
+libconfigfile::array_node::cend() const {
+  materialize();
+  return base_t::cend();
+}
+
+libconfigfile::array_node::reverse_iterator
+libconfigfile::array_node::rbegin() {
+  materialize();
+  return base_t::rbegin();
+}
+
+libconfigfile::array_node::const_reverse_iterator
+libconfigfile::array_node::rbegin() const {
+  materialize();
+  return base_t::rbegin();
+}
+
+libconfigfile::array_node::const_reverse_iterator
+libconfigfile::array_node::crbegin() const {
+  materialize();
+  return base_t::crbegin();
+}
+
+libconfigfile::array_node::reverse_iterator libconfigfile::array_node::rend() {
+  materialize();
+  return base_t::rend();
+}
+
+libconfigfile::array_node::const_reverse_iterator
+libconfigfile::array_node::rend() const {
+  materialize();
+  return base_t::rend();
+}
+
+libconfigfile::array_node::const_reverse_iterator
+libconfigfile::array_node::crend() const {
+  materialize();
+  return base_t::crend();
+}
+
+bool libconfigfile::array_node::empty() const {
+  materialize();
+  return base_t::empty();
+}
+
+libconfigfile::array_node::size_type libconfigfile::array_node::size() const {
+  materialize();
+  return base_t::size();
+}
+
+libconfigfile::array_node::reference
+libconfigfile::array_node::operator[](const size_type pos) {
+  materialize();
+  return base_t::operator[](pos);
+}
+
+libconfigfile::array_node::const_reference
+libconfigfile::array_node::operator[](const size_type pos) const {
+  materialize();
+  return base_t::operator[](pos);
+}
+
+libconfigfile::array_node::reference
+libconfigfile::array_node::at(const size_type pos) {
+  materialize();
+  return base_t::at(pos);
+}
+
+libconfigfile::array_node::const_reference
+libconfigfile::array_node::at(const size_type pos) const {
+  materialize();
+  return base_t::at(pos);
+}
+
+libconfigfile::array_node::reference libconfigfile::array_node::front() {
+  materialize();
+  return base_t::front();
+}
+
+libconfigfile::array_node::const_reference
+libconfigfile::array_node::front() const {
+  materialize();
+  return base_t::front();
+}
+
+libconfigfile::array_node::reference libconfigfile::array_node::back() {
+  materialize();
+  return base_t::back();
+}
+
+libconfigfile::array_node::const_reference
+libconfigfile::array_node::back() const {
+  materialize();
+  return base_t::back();
+}
+
+void libconfigfile::array_node::push_back(const value_type &value) {
+  materialize();
+  base_t::push_back(value);
+}
+
+void libconfigfile::array_node::push_back(value_type &&value) {
+  materialize();
+  base_t::push_back(std::move(value));
+}
+
+void libconfigfile::array_node::pop_back() {
+  materialize();
+  base_t::pop_back();
+}
+
+libconfigfile::array_node::iterator
+libconfigfile::array_node::insert(const_iterator pos, const value_type &value) {
+  materialize();
+  return base_t::insert(pos, value);
+}
+
+libconfigfile::array_node::iterator
+libconfigfile::array_node::insert(const_iterator pos, value_type &&value) {
+  materialize();
+  return base_t::insert(pos, std::move(value));
+}
+
+libconfigfile::array_node::iterator
+libconfigfile::array_node::erase(const_iterator pos) {
+  materialize();
+  return base_t::erase(pos);
+}
+
+libconfigfile::array_node::iterator
+libconfigfile::array_node::erase(const_iterator first, const_iterator last) {
+  materialize();
+  return base_t::erase(first, last);
+}
+
+void libconfigfile::array_node::resize(const size_type count) {
+  materialize();
+  base_t::resize(count);
+}
+
+void libconfigfile::array_node::clear() {
+  reset_lazy_subtree(nullptr);
+  base_t::clear();
+}
+
+void libconfigfile::array_node::swap(array_node &other) noexcept {
+  base_t::swap(other);
+  std::shared_ptr<const lazy_subtree> lazy{std::move(m_lazy)};
+  reset_lazy_subtree(std::move(other.m_lazy));
+  other.reset_lazy_subtree(std::move(lazy));
+}
+
 libconfigfile::array_node &
 libconfigfile::array_node::operator=(const array_node &other) {
-  base_t::operator=(other);
+  std::shared_ptr<const lazy_subtree> lazy{other.get_lazy_subtree()};
+  if (lazy == nullptr) {
+    base_t::operator=(other);
+  } else {
+    base_t::clear();
+  }
+  reset_lazy_subtree(std::move(lazy));
   return *this;
 }
 
 libconfigfile::array_node &libconfigfile::array_node::operator=(
     array_node &&other) noexcept(std::is_nothrow_move_assignable_v<base_t>) {
   base_t::operator=(std::move(other));
+  reset_lazy_subtree(std::move(other.m_lazy));
+  other.reset_lazy_subtree(nullptr);
   return *this;
 }
 
 libconfigfile::array_node &
 libconfigfile::array_node::operator=(const base_t &other) {
   base_t::operator=(other);
+  reset_lazy_subtree(nullptr);
   return *this;
 }
 
 libconfigfile::array_node &libconfigfile::array_node::operator=(
     base_t &&other) noexcept(std::is_nothrow_move_assignable_v<base_t>) {
   base_t::operator=(std::move(other));
+  reset_lazy_subtree(nullptr);
   return *this;
 }
 
+bool libconfigfile::operator==(const array_node &lhs, const array_node &rhs) {
+  lhs.materialize();
+  rhs.materialize();
+  return (static_cast<const array_node::base_t &>(lhs) ==
+          static_cast<const array_node::base_t &>(rhs));
+}
+
 std::ostream &libconfigfile::operator<<(std::ostream &out,
                                         const array_node &n) {
   return n.print(out);
 }
 
+void libconfigfile::swap(array_node &lhs, array_node &rhs) noexcept {
+  lhs.swap(rhs);
+}
+
 libconfigfile::array_node::base_t
 libconfigfile::node_to_base(const array_node &node) {
+  node.materialize();
   return array_node::base_t{node};
 }
 
 libconfigfile::array_node::base_t
 libconfigfile::node_to_base(array_node &&node) {
+  node.materialize();
   return array_node::base_t{std::move(node)};
 }
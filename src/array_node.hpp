@@ -1,12 +1,16 @@
 #ifndef LIBCONFIGFILE_ARRAY_NODE_HPP
 #define LIBCONFIGFILE_ARRAY_NODE_HPP
 
+#include "lazy_subtree.hpp"
 #include "node.hpp"
 #include "node_ptr.hpp"
 #include "node_types.hpp"
 
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace libconfigfile {
@@ -14,6 +18,14 @@ class array_node : public node, public std::vector<node_ptr<node, true>> {
 public:
   using base_t = std::vector<node_ptr<node, true>>;
 
+private:
+  // Set while the contents haven't been parsed yet; see lazy_subtree. Const
+  // members only access it with impl::lazy_subtree_mutex() held.
+  mutable std::shared_ptr<const lazy_subtree> m_lazy{};
+  // Whether m_lazy is set, so that once the array has been materialized its
+  // const members can be used concurrently without taking the lock.
+  mutable std::atomic<bool> m_is_lazy{false};
+
 public:
   using base_t::base_t;
   array_node();
@@ -36,6 +48,62 @@ public:
   print(std::ostream &out,
         [[maybe_unused]] const int indent_level = 0) const override;
 
+public:
+  void set_lazy_subtree(std::shared_ptr<const lazy_subtree> lazy);
+  bool is_materialized() const;
+  // Parses the contents if they haven't been yet. Throws syntax_error if they
+  // are malformed, which can only be found out here if they were deferred
+  // with parse_options::check_skipped_values set to false. Safe to call
+  // concurrently with itself and with the other const members.
+  void materialize() const;
+
+private:
+  std::shared_ptr<const lazy_subtree> get_lazy_subtree() const;
+  void reset_lazy_subtree(std::shared_ptr<const lazy_subtree> lazy);
+
+public:
+  // These hide the members of base_t so that they materialize the contents
+  // first, and so can throw syntax_error like materialize().
+  iterator begin();
+  const_iterator begin() const;
+  const_iterator cbegin() const;
+  iterator end();
+  const_iterator end() const;
+  const_iterator cend() const;
+  reverse_iterator rbegin();
+  const_reverse_iterator rbegin() const;
+  const_reverse_iterator crbegin() const;
+  reverse_iterator rend();
+  const_reverse_iterator rend() const;
+  const_reverse_iterator crend() const;
+
+  bool empty() const;
+  size_type size() const;
+
+  reference operator[](const size_type pos);
+  const_reference operator[](const size_type pos) const;
+  reference at(const size_type pos);
+  const_reference at(const size_type pos) const;
+  reference front();
+  const_reference front() const;
+  reference back();
+  const_reference back() const;
+
+  void push_back(const value_type &value);
+  void push_back(value_type &&value);
+  template <typename... t_args> reference emplace_back(t_args &&...args) {
+    materialize();
+    return base_t::emplace_back(std::forward<t_args>(args)...);
+  }
+  void pop_back();
+  iterator insert(const_iterator pos, const value_type &value);
+  iterator insert(const_iterator pos, value_type &&value);
+  iterator erase(const_iterator pos);
+  iterator erase(const_iterator first, const_iterator last);
+  void resize(const size_type count);
+  void clear();
+  void swap(array_node &other) noexcept;
+
 public:
   array_node &operator=(const array_node &other);
   array_node &operator=(array_node &&other) noexcept(
@@ -45,14 +113,22 @@ public:
   operator=(base_t &&other) noexcept(std::is_nothrow_move_assignable_v<base_t>);
 
 public:
+  friend bool operator==(const array_node &lhs, const array_node &rhs);
+
   friend std::ostream &operator<<(std::ostream &out, const array_node &n);
 
+  friend void swap(array_node &lhs, array_node &rhs) noexcept;
+
   friend array_node::base_t node_to_base(const array_node &node);
   friend array_node::base_t node_to_base(array_node &&node);
 };
 
+bool operator==(const array_node &lhs, const array_node &rhs);
+
 std::ostream &operator<<(std::ostream &out, const array_node &n);
 
+void swap(array_node &lhs, array_node &rhs) noexcept;
+
 array_node::base_t node_to_base(const array_node &node);
 array_node::base_t node_to_base(array_node &&node);
 } // namespace libconfigfile
@@ -25,6 +25,7 @@ static constexpr char k_key_value_assign{'='};
 static constexpr char k_key_value_terminate{';'};
 static const std::string k_valid_name_chars{
     "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-"};
+static constexpr char k_key_path_separator{'.'};
 
 static constexpr char k_directive_leader{'@'};
 static constexpr std::string k_version_directive_name{"version"};
@@ -0,0 +1,797 @@
+// libconfigfile-codegen: generates a C++ header with plain structs, and a
+// decoder straight into them, from a schema written in the config syntax.
+//
+// Usage: libconfigfile-codegen SCHEMA STRUCT [NAMESPACE] > HEADER
+//
+// The root map of the schema holds the fields of STRUCT. Each field is a map
+// holding:
+//   type = "string" | "integer" | "float" | "array" | "map";
+//   default = VALUE;       for strings, integers and floats
+//   required = 1;          to reject configs without the key
+//   element = { ... };     for arrays, the type of their elements
+//   fields = { ... };      for maps, their fields
+//   struct = "NAME";       for maps, the name of their struct
+// e.g.
+//   host = { type = "string"; required = 1; };
+//   port = { type = "integer"; default = 8080; };
+//   upstreams = { type = "array"; element = { type = "map";
+//       struct = "endpoint"; fields = { host = { type = "string"; }; }; }; };
+//
+// Integers are std::int64_t, floats are doubles and arrays are std::vectors.
+// Structs are named after the path to them (e.g. STRUCT_upstreams_element)
+// unless given a name. Dashes in keys become underscores in members.
+//
+// The generated STRUCT_decoder is a handler for libconfigfile's event parser
+// that dispatches on each key's length and characters and stores each value
+// as soon as it is read, so no nodes are built and nothing is looked up at
+// runtime; its own state is a fixed-size array as deep as the schema. It is
+// used through decode_STRUCT(), decode_STRUCT_file() and their try_
+// counterparts, which work like libconfigfile::decode().
+
+#include "map_node.hpp"
+#include "node_ptr.hpp"
+#include "node_types.hpp"
+#include "node_view.hpp"
+#include "parser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace libconfigfile {
+namespace codegen {
+struct schema_field;
+
+struct schema_type {
+  node_type type;
+  // For maps, their struct; for arrays, their frame in the decoder.
+  std::string name;
+  // For strings, integers and floats, the initializer of their default.
+  std::string initializer;
+  std::unique_ptr<schema_type> element;
+  std::vector<schema_field> fields;
+  std::uint64_t required_mask;
+};
+
+struct schema_field {
+  std::string key;
+  std::string member;
+  std::uint64_t required_bit;
+  schema_type type;
+};
+
+// Sorted, for binary_search().
+static constexpr std::array<std::string_view, 92> k_cpp_keywords{
+    "alignas",      "alignof",       "and",        "and_eq",
+    "asm",          "auto",          "bitand",     "bitor",
+    "bool",         "break",         "case",       "catch",
+    "char",         "char16_t",      "char32_t",   "char8_t",
+    "class",        "co_await",      "co_return",  "co_yield",
+    "compl",        "concept",       "const",      "const_cast",
+    "consteval",    "constexpr",     "constinit",  "continue",
+    "decltype",     "default",       "delete",     "do",
+    "double",       "dynamic_cast",  "else",       "enum",
+    "explicit",     "export",        "extern",     "false",
+    "final",        "float",         "for",        "friend",
+    "goto",         "if",            "import",     "inline",
+    "int",          "long",          "module",     "mutable",
+    "namespace",    "new",           "noexcept",   "not",
+    "not_eq",       "nullptr",       "operator",   "or",
+    "or_eq",        "override",      "private",    "protected",
+    "public",       "register",      "reinterpret_cast", "requires",
+    "return",       "short",         "signed",     "sizeof",
+    "static",       "static_assert", "static_cast", "struct",
+    "switch",       "template",      "this",       "thread_local",
+    "throw",        "true",          "try",        "typedef",
+    "typeid",       "typename",      "union",      "unsigned",
+    "using",        "virtual",       "void",       "volatile",
+};
+
+[[noreturn]] static void throw_schema_error(const std::string &path,
+                                            const std::string &what) {
+  throw std::runtime_error{
+      ((path.empty() == true) ? (std::string{"schema root"})
+                              : ("schema field \"" + path + "\"")) +
+      " " + what};
+}
+
+static bool is_identifier(const std::string_view name) {
+  if ((name.empty() == true) ||
+      ((name.front() >= '0') && (name.front() <= '9'))) {
+    return false;
+  }
+  for (const char ch : name) {
+    if ((((ch >= 'a') && (ch <= 'z')) || ((ch >= 'A') && (ch <= 'Z')) ||
+         ((ch >= '0') && (ch <= '9')) || (ch == '_')) == false) {
+      return false;
+    }
+  }
+  return (std::binary_search(k_cpp_keywords.begin(), k_cpp_keywords.end(),
+                             name) == false);
+}
+
+static std::string to_member_name(const std::string &key,
+                                  const std::string &path) {
+  std::string ret_val{key};
+  std::replace(ret_val.begin(), ret_val.end(), '-', '_');
+  if (std::binary_search(k_cpp_keywords.begin(), k_cpp_keywords.end(),
+                         ret_val) == true) {
+    ret_val += '_';
+  }
+  if (is_identifier(ret_val) == false) {
+    throw_schema_error(path, "does not make a valid C++ member name");
+  }
+  return ret_val;
+}
+
+static std::string string_literal(const std::string_view value) {
+  std::string ret_val{'"'};
+  for (const char ch : value) {
+    if ((ch == '"') || (ch == '\\')) {
+      ret_val += '\\';
+      ret_val += ch;
+    } else if ((ch >= 0x20) && (ch <= 0x7e)) {
+      ret_val += ch;
+    } else {
+      // Octal, because hexadecimal escapes don't end after two digits.
+      const unsigned char byte{static_cast<unsigned char>(ch)};
+      ret_val += '\\';
+      ret_val += static_cast<char>('0' + ((byte >> 6) & 0x7));
+      ret_val += static_cast<char>('0' + ((byte >> 3) & 0x7));
+      ret_val += static_cast<char>('0' + (byte & 0x7));
+    }
+  }
+  ret_val += '"';
+  return ret_val;
+}
+
+static std::string integer_literal(const std::int64_t value) {
+  if (value == std::numeric_limits<std::int64_t>::min()) {
+    return "(-9223372036854775807 - 1)";
+  }
+  return std::to_string(value);
+}
+
+static std::string float_literal(const double value) {
+  if (std::isnan(value) == true) {
+    return "std::numeric_limits<double>::quiet_NaN()";
+  } else if (std::isinf(value) == true) {
+    return (std::string{((value < 0) ? ("-") : (""))} +
+            "std::numeric_limits<double>::infinity()");
+  }
+  std::array<char, 32> buffer{};
+  const std::to_chars_result result{
+      std::to_chars(buffer.data(), buffer.data() + buffer.size(), value)};
+  std::string ret_val{buffer.data(), result.ptr};
+  if (ret_val.find_first_of(".e") == std::string::npos) {
+    ret_val += ".0";
+  }
+  return ret_val;
+}
+
+static void read_fields(const map_view fields, const std::string &path,
+                        schema_type &type, std::set<std::string> &names);
+
+static schema_type read_type(const map_view spec, const std::string &path,
+                             const std::string &name, const bool is_field,
+                             std::set<std::string> &names) {
+  for (const auto &member : spec) {
+    if ((member.first != "type") && (member.first != "element") &&
+        (member.first != "fields") && (member.first != "struct") &&
+        (((member.first != "default") && (member.first != "required")) ||
+         (is_field == false))) {
+      throw_schema_error(path, "has unknown property \"" + member.first +
+                                   "\"");
+    }
+  }
+
+  schema_type ret_val{node_type::Null, name, "{}", nullptr, {}, 0};
+  const std::optional<std::string_view> type_name{
+      spec["type"].try_get<std::string_view>()};
+  if (type_name.has_value() == false) {
+    throw_schema_error(path, "has no type");
+  } else if (type_name.value() == "string") {
+    ret_val.type = node_type::String;
+  } else if (type_name.value() == "integer") {
+    ret_val.type = node_type::Integer;
+  } else if (type_name.value() == "float") {
+    ret_val.type = node_type::Float;
+  } else if (type_name.value() == "array") {
+    ret_val.type = node_type::Array;
+  } else if (type_name.value() == "map") {
+    ret_val.type = node_type::Map;
+  } else {
+    throw_schema_error(path, "has unknown type \"" +
+                                 std::string{type_name.value()} + "\"");
+  }
+
+  if ((ret_val.type != node_type::Array) &&
+      (spec.contains("element") == true)) {
+    throw_schema_error(path, "has an element type but isn't an array");
+  } else if ((ret_val.type != node_type::Map) &&
+             ((spec.contains("fields") == true) ||
+              (spec.contains("struct") == true))) {
+    throw_schema_error(path, "has fields but isn't a map");
+  }
+
+  if (const node_view<node> default_value{spec["default"]}; default_value) {
+    if ((ret_val.type == node_type::Array) ||
+        (ret_val.type == node_type::Map)) {
+      throw_schema_error(path, "has a default but isn't a string, integer "
+                               "or float");
+    } else if (default_value.get_node_type() != ret_val.type) {
+      throw_schema_error(path, "has a default of the wrong type");
+    } else if (ret_val.type == node_type::String) {
+      ret_val.initializer =
+          "{" +
+          string_literal(default_value.try_get<std::string_view>().value()) +
+          "}";
+    } else if (ret_val.type == node_type::Integer) {
+      ret_val.initializer =
+          "{" +
+          integer_literal(
+              default_value.try_get<std::int64_t>().value()) +
+          "}";
+    } else {
+      ret_val.initializer =
+          "{" + float_literal(default_value.try_get<double>().value()) + "}";
+    }
+  }
+
+  if (ret_val.type == node_type::Array) {
+    const map_view element{spec["element"].as<map_node>()};
+    if (element.get() == nullptr) {
+      throw_schema_error(path, "is an array without an element type");
+    }
+    ret_val.element = std::make_unique<schema_type>(
+        read_type(element, path + "[]", name + "_element", false, names));
+  } else if (ret_val.type == node_type::Map) {
+    if (const node_view<node> struct_name{spec["struct"]}; struct_name) {
+      if ((struct_name.is<string_node>() == false) ||
+          (is_identifier(
+               struct_name.try_get<std::string_view>().value()) == false)) {
+        throw_schema_error(path, "has a struct name that isn't a valid C++ "
+                                 "name");
+      }
+      ret_val.name =
+          std::string{struct_name.try_get<std::string_view>().value()};
+    }
+    const node_view<node> fields{spec["fields"]};
+    if ((fields.get() != nullptr) && (fields.is<map_node>() == false)) {
+      throw_schema_error(path, "has fields that aren't a map");
+    }
+    read_fields(fields.as<map_node>(), path, ret_val, names);
+  }
+
+  if (((ret_val.type == node_type::Array) ||
+       (ret_val.type == node_type::Map)) &&
+      (names.insert(ret_val.name).second == false)) {
+    throw_schema_error(path, "needs the name \"" + ret_val.name +
+                                 "\", which is already taken");
+  }
+  return ret_val;
+}
+
+static void read_fields(const map_view fields, const std::string &path,
+                        schema_type &type, std::set<std::string> &names) {
+  if (fields.get() == nullptr) {
+    return;
+  }
+  std::vector<std::string> keys{};
+  for (const auto &member : fields) {
+    keys.push_back(member.first);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::set<std::string> members{};
+  std::size_t required_count{0};
+  for (const std::string &key : keys) {
+    const std::string field_path{((path.empty() == true) ? (key)
+                                                         : (path + "." + key))};
+    const map_view spec{fields[key].as<map_node>()};
+    if (spec.get() == nullptr) {
+      throw_schema_error(field_path, "isn't a map");
+    }
+    std::string member{to_member_name(key, field_path)};
+    if (members.insert(member).second == false) {
+      throw_schema_error(field_path, "has the same member name as another "
+                                     "field");
+    }
+
+    std::uint64_t required_bit{0};
+    if (const node_view<node> required{spec["required"]}; required) {
+      const std::optional<int> is_required{required.try_get<int>()};
+      if ((is_required.has_value() == false) ||
+          ((is_required.value() != 0) && (is_required.value() != 1))) {
+        throw_schema_error(field_path, "has a required property that isn't "
+                                       "0 or 1");
+      } else if (is_required.value() == 1) {
+        if (required_count == 64) {
+          throw_schema_error(path, "has more than 64 required fields");
+        }
+        required_bit = (std::uint64_t{1} << (required_count++));
+        type.required_mask |= required_bit;
+      }
+    }
+
+    schema_type field_type{read_type(spec, field_path,
+                                     type.name + "_" + member, true, names)};
+    type.fields.push_back(schema_field{key, std::move(member), required_bit,
+                                       std::move(field_type)});
+  }
+}
+
+static std::string cpp_type(const schema_type &type) {
+  switch (type.type) {
+  case node_type::String: {
+    return "std::string";
+  } break;
+  case node_type::Integer: {
+    return "std::int64_t";
+  } break;
+  case node_type::Float: {
+    return "double";
+  } break;
+  case node_type::Array: {
+    return "std::vector<" + cpp_type(*(type.element)) + ">";
+  } break;
+  default: {
+    return type.name;
+  } break;
+  }
+}
+
+static std::string node_type_name(const node_type type) {
+  switch (type) {
+  case node_type::String: {
+    return "libconfigfile::node_type::String";
+  } break;
+  case node_type::Integer: {
+    return "libconfigfile::node_type::Integer";
+  } break;
+  case node_type::Float: {
+    return "libconfigfile::node_type::Float";
+  } break;
+  case node_type::Array: {
+    return "libconfigfile::node_type::Array";
+  } break;
+  default: {
+    return "libconfigfile::node_type::Map";
+  } break;
+  }
+}
+
+// Maps and arrays, each after those it contains.
+static void collect_containers(const schema_type &type,
+                               std::vector<const schema_type *> &containers) {
+  if (type.type == node_type::Array) {
+    collect_containers(*(type.element), containers);
+  } else if (type.type == node_type::Map) {
+    for (const schema_field &field : type.fields) {
+      collect_containers(field.type, containers);
+    }
+  } else {
+    return;
+  }
+  containers.push_back(&type);
+}
+
+static std::size_t nesting_depth(const schema_type &type) {
+  std::size_t ret_val{0};
+  if (type.type == node_type::Array) {
+    ret_val = nesting_depth(*(type.element));
+  } else if (type.type == node_type::Map) {
+    for (const schema_field &field : type.fields) {
+      ret_val = std::max(ret_val, nesting_depth(field.type));
+    }
+  } else {
+    return 0;
+  }
+  return (ret_val + 1);
+}
+
+// Stores a value in `target`, or for a map or array, starts decoding into it.
+static void write_store(std::ostream &out, const schema_type &type,
+                        const std::string &target, const bool is_element,
+                        const std::string &indent) {
+  out << indent << "if (type != " << node_type_name(type.type) << ") {\n"
+      << indent
+      << "  return &libconfigfile::error_messages::err_msg_2_1_1;\n"
+      << indent << "}\n";
+  switch (type.type) {
+  case node_type::String: {
+    out << indent << target << ".assign(string);\n";
+  } break;
+  case node_type::Integer: {
+    out << indent << target << " = integer;\n";
+  } break;
+  case node_type::Float: {
+    out << indent << target << " = floating;\n";
+  } break;
+  case node_type::Array: {
+    if (is_element == false) {
+      out << indent << target << ".clear();\n";
+    }
+    out << indent << "return push(frame_type::" << type.name << ", &("
+        << target << "));\n";
+  } break;
+  default: {
+    out << indent << "return push(frame_type::" << type.name << ", &("
+        << target << "));\n";
+  } break;
+  }
+}
+
+static void write_select(std::ostream &out, const schema_type &type) {
+  if (type.fields.empty() == true) {
+    out << "  static int select_" << type.name
+        << "(const std::string_view /*key*/) { return -1; }\n";
+    return;
+  }
+
+  std::vector<std::pair<std::size_t, std::size_t /*field*/>> by_length{};
+  for (std::size_t i{0}; i < type.fields.size(); ++i) {
+    by_length.emplace_back(type.fields[i].key.size(), i);
+  }
+  std::sort(by_length.begin(), by_length.end());
+
+  out << "  static int select_" << type.name
+      << "(const std::string_view key) {\n"
+      << "    switch (key.size()) {\n";
+  for (std::size_t i{0}; i < by_length.size(); ++i) {
+    if ((i == 0) || (by_length[i].first != by_length[i - 1].first)) {
+      out << "    case " << by_length[i].first << ": {\n";
+    }
+    out << "      if (key == \"" << type.fields[by_length[i].second].key
+        << "\") {\n"
+        << "        return " << by_length[i].second << ";\n"
+        << "      }\n";
+    if (((i + 1) == by_length.size()) ||
+        (by_length[i + 1].first != by_length[i].first)) {
+      out << "    } break;\n";
+    }
+  }
+  out << "    }\n"
+      << "    return -1;\n"
+      << "  }\n";
+}
+
+static std::string generate_header(const schema_type &root,
+                                   const std::string &schema_path,
+                                   const std::string &name_space) {
+  std::vector<const schema_type *> containers{};
+  collect_containers(root, containers);
+
+  std::string guard{};
+  for (const char ch : (name_space + "::" + root.name + "_hpp")) {
+    if (ch != ':') {
+      guard += static_cast<char>(
+          std::toupper(static_cast<unsigned char>(ch)));
+    } else if ((guard.empty() == false) && (guard.back() != '_')) {
+      guard += '_';
+    }
+  }
+  const std::string error_message{
+      "const libconfigfile::error_messages::error_message *\n  "};
+
+  std::ostringstream out{};
+  out << "// Generated by libconfigfile-codegen from " << schema_path
+      << "; do not edit.\n\n"
+      << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+      << "#include <libconfigfile/error_messages.hpp>\n"
+      << "#include <libconfigfile/event_parser.hpp>\n"
+      << "#include <libconfigfile/node_types.hpp>\n"
+      << "#include <libconfigfile/numeral_system.hpp>\n"
+      << "#include <libconfigfile/parse_error.hpp>\n"
+      << "#include <libconfigfile/parser.hpp>\n\n"
+      << "#include <array>\n#include <cstddef>\n#include <cstdint>\n"
+      << "#include <expected>\n#include <filesystem>\n#include <fstream>\n"
+      << "#include <istream>\n#include <limits>\n#include <string>\n"
+      << "#include <string_view>\n#include <utility>\n#include <vector>\n\n";
+  if (name_space.empty() == false) {
+    out << "namespace " << name_space << " {\n";
+  }
+
+  for (const schema_type *type : containers) {
+    if (type->type != node_type::Map) {
+      continue;
+    }
+    if (type->fields.empty() == true) {
+      out << "struct " << type->name << " {};\n\n";
+      continue;
+    }
+    out << "struct " << type->name << " {\n";
+    for (const schema_field &field : type->fields) {
+      out << "  " << cpp_type(field.type) << " " << field.member
+          << field.type.initializer << ";\n";
+    }
+    out << "};\n\n";
+  }
+
+  const std::string &name{root.name};
+  out << "class " << name << "_decoder {\n"
+      << "private:\n"
+      << "  static constexpr std::size_t k_max_depth{" << nesting_depth(root)
+      << "};\n\n"
+      << "  enum class frame_type {\n";
+  for (const schema_type *type : containers) {
+    out << "    " << type->name << ",\n";
+  }
+  out << "  };\n\n"
+      << "  struct frame {\n"
+      << "    frame_type type;\n"
+      << "    void *object;\n"
+      << "    int field;\n"
+      << "    std::uint64_t seen;\n"
+      << "  };\n\n"
+      << "private:\n"
+      << "  " << name << " &m_result;\n"
+      << "  std::array<frame, k_max_depth> m_frames;\n"
+      << "  std::size_t m_depth;\n"
+      << "  // How deep the parser is in a value whose key has no field.\n"
+      << "  std::size_t m_skipped_depth;\n\n"
+      << "public:\n"
+      << "  explicit " << name << "_decoder(" << name << " &result)\n"
+      << "      : m_result{result}, m_frames{}, m_depth{0}, "
+         "m_skipped_depth{0} {}\n\n"
+      << "public:\n"
+      << "  " << error_message << "begin_map(const std::size_t /*offset*/) {\n"
+      << "    if (m_depth == 0) {\n"
+      << "      return push(frame_type::" << name << ", &m_result);\n"
+      << "    }\n"
+      << "    return store(libconfigfile::node_type::Map, {}, 0, 0.0);\n"
+      << "  }\n\n"
+      << "  " << error_message << "end_map(const std::size_t /*offset*/) {\n"
+      << "    if (m_skipped_depth > 0) {\n"
+      << "      --m_skipped_depth;\n"
+      << "      return nullptr;\n"
+      << "    }\n";
+  bool has_required_fields{false};
+  for (const schema_type *type : containers) {
+    has_required_fields |= (type->required_mask != 0);
+  }
+  if (has_required_fields == true) {
+    out << "    const frame &top{m_frames[--m_depth]};\n"
+        << "    switch (top.type) {\n";
+    for (const schema_type *type : containers) {
+      if (type->required_mask == 0) {
+        continue;
+      }
+      out << "    case frame_type::" << type->name << ": {\n"
+          << "      if ((top.seen & 0x" << std::hex << type->required_mask
+          << ") != 0x" << type->required_mask << std::dec << ") {\n"
+          << "        return &libconfigfile::error_messages::err_msg_2_3_1;\n"
+          << "      }\n"
+          << "    } break;\n";
+    }
+    out << "    default: {\n"
+        << "    } break;\n"
+        << "    }\n";
+  } else {
+    out << "    --m_depth;\n";
+  }
+  out << "    return nullptr;\n"
+      << "  }\n\n"
+      << "  " << error_message
+      << "begin_array(const std::size_t /*offset*/) {\n"
+      << "    return store(libconfigfile::node_type::Array, {}, 0, 0.0);\n"
+      << "  }\n\n"
+      << "  " << error_message << "end_array(const std::size_t /*offset*/) {\n"
+      << "    if (m_skipped_depth > 0) {\n"
+      << "      --m_skipped_depth;\n"
+      << "    } else {\n"
+      << "      --m_depth;\n"
+      << "    }\n"
+      << "    return nullptr;\n"
+      << "  }\n\n"
+      << "  " << error_message
+      << "key(const std::string_view key, const std::size_t /*offset*/) {\n"
+      << "    if (m_skipped_depth == 0) {\n"
+      << "      frame &top{m_frames[m_depth - 1]};\n"
+      << "      switch (top.type) {\n";
+  for (const schema_type *type : containers) {
+    if (type->type == node_type::Map) {
+      out << "      case frame_type::" << type->name << ": {\n"
+          << "        top.field = select_" << type->name << "(key);\n"
+          << "      } break;\n";
+    }
+  }
+  out << "      default: {\n"
+      << "      } break;\n"
+      << "      }\n"
+      << "    }\n"
+      << "    return nullptr;\n"
+      << "  }\n\n"
+      << "  " << error_message
+      << "string_value(const std::string_view value,\n"
+      << "               const std::size_t /*offset*/) {\n"
+      << "    return store(libconfigfile::node_type::String, value, 0, 0.0);\n"
+      << "  }\n\n"
+      << "  " << error_message
+      << "integer_value(const std::int64_t value,\n"
+      << "                const libconfigfile::numeral_system & /*num_sys*/,\n"
+      << "                const std::size_t /*offset*/) {\n"
+      << "    return store(libconfigfile::node_type::Integer, {}, value, "
+         "0.0);\n"
+      << "  }\n\n"
+      << "  " << error_message
+      << "float_value(const double value, const std::size_t /*offset*/) {\n"
+      << "    return store(libconfigfile::node_type::Float, {}, 0, value);\n"
+      << "  }\n\n"
+      << "private:\n"
+      << "  " << error_message
+      << "push(const frame_type type, void *object) {\n"
+      << "    m_frames[m_depth++] = frame{type, object, -1, 0};\n"
+      << "    return nullptr;\n"
+      << "  }\n\n"
+      << "  " << error_message
+      << "skip(const libconfigfile::node_type type) {\n"
+      << "    if ((type == libconfigfile::node_type::Map) ||\n"
+      << "        (type == libconfigfile::node_type::Array)) {\n"
+      << "      ++m_skipped_depth;\n"
+      << "    }\n"
+      << "    return nullptr;\n"
+      << "  }\n\n"
+      << "  " << error_message
+      << "store(const libconfigfile::node_type type,\n"
+      << "        [[maybe_unused]] const std::string_view string,\n"
+      << "        [[maybe_unused]] const std::int64_t integer,\n"
+      << "        [[maybe_unused]] const double floating) {\n"
+      << "    if (m_skipped_depth > 0) {\n"
+      << "      return skip(type);\n"
+      << "    }\n"
+      << "    frame &top{m_frames[m_depth - 1]};\n"
+      << "    switch (top.type) {\n";
+  for (const schema_type *type : containers) {
+    const std::string type_name{cpp_type(*type)};
+    out << "    case frame_type::" << type->name << ": {\n";
+    if (type->type == node_type::Map) {
+      if (type->fields.empty() == false) {
+        out << "      " << type_name << " &object{*static_cast<" << type_name
+            << " *>(top.object)};\n";
+      }
+      out << "      switch (top.field) {\n";
+      for (std::size_t i{0}; i < type->fields.size(); ++i) {
+        const schema_field &field{type->fields[i]};
+        out << "      case " << i << ": {\n";
+        if (field.required_bit != 0) {
+          out << "        top.seen |= 0x" << std::hex << field.required_bit
+              << std::dec << ";\n";
+        }
+        write_store(out, field.type, "object." + field.member, false,
+                    "        ");
+        out << "      } break;\n";
+      }
+      out << "      default: {\n"
+          << "        return skip(type);\n"
+          << "      } break;\n"
+          << "      }\n";
+    } else {
+      out << "      " << type_name << " &object{*static_cast<" << type_name
+          << " *>(top.object)};\n";
+      write_store(out, *(type->element), "object.emplace_back()", true,
+                  "      ");
+    }
+    out << "    } break;\n";
+  }
+  out << "    }\n"
+      << "    return nullptr;\n"
+      << "  }\n";
+  for (const schema_type *type : containers) {
+    if (type->type == node_type::Map) {
+      out << "\n";
+      write_select(out, *type);
+    }
+  }
+  out << "};\n\n"
+      << "inline std::expected<" << name << ", libconfigfile::parse_error>\n"
+      << "try_decode_" << name
+      << "(const std::string &identifier, std::istream &input_stream,\n"
+      << "    const bool identifier_is_file_path = false) {\n"
+      << "  " << name << " ret_val{};\n"
+      << "  " << name << "_decoder decoder{ret_val};\n"
+      << "  std::expected<void, libconfigfile::parse_error> result{\n"
+      << "      libconfigfile::impl::parse_events(\n"
+      << "          decoder, identifier, input_stream, "
+         "identifier_is_file_path,\n"
+      << "          libconfigfile::parse_options::"
+         "k_default_max_nesting_depth)};\n"
+      << "  if (result.has_value() == false) {\n"
+      << "    return std::unexpected{std::move(result.error())};\n"
+      << "  }\n"
+      << "  return ret_val;\n"
+      << "}\n\n"
+      << "inline std::expected<" << name << ", libconfigfile::parse_error>\n"
+      << "try_decode_" << name
+      << "_file(const std::filesystem::path &file_path) {\n"
+      << "  std::ifstream input_stream{file_path};\n"
+      << "  return try_decode_" << name
+      << "(file_path.string(), input_stream, true);\n"
+      << "}\n\n"
+      << "inline " << name << " decode_" << name
+      << "(const std::string &identifier, std::istream &input_stream,\n"
+      << "    const bool identifier_is_file_path = false) {\n"
+      << "  std::expected<" << name << ", libconfigfile::parse_error> result{\n"
+      << "      try_decode_" << name
+      << "(identifier, input_stream, identifier_is_file_path)};\n"
+      << "  if (result.has_value() == false) {\n"
+      << "    libconfigfile::parser::impl::throw_parse_error(\n"
+      << "        std::move(result.error()));\n"
+      << "  }\n"
+      << "  return std::move(result.value());\n"
+      << "}\n\n"
+      << "inline " << name << " decode_" << name
+      << "_file(const std::filesystem::path &file_path) {\n"
+      << "  std::expected<" << name << ", libconfigfile::parse_error> result{\n"
+      << "      try_decode_" << name << "_file(file_path)};\n"
+      << "  if (result.has_value() == false) {\n"
+      << "    libconfigfile::parser::impl::throw_parse_error(\n"
+      << "        std::move(result.error()));\n"
+      << "  }\n"
+      << "  return std::move(result.value());\n"
+      << "}\n";
+  if (name_space.empty() == false) {
+    out << "} // namespace " << name_space << "\n";
+  }
+  out << "\n#endif\n";
+  return out.str();
+}
+} // namespace codegen
+} // namespace libconfigfile
+
+int main(int argc, char *argv[]) {
+  using namespace libconfigfile;
+
+  if ((argc < 3) || (argc > 4)) {
+    std::cerr << "usage: " << argv[0] << " SCHEMA STRUCT [NAMESPACE]\n";
+    return 2;
+  }
+  const std::string schema_path{argv[1]};
+  const std::string struct_name{argv[2]};
+  const std::string name_space{((argc == 4) ? (argv[3]) : (""))};
+
+  try {
+    if (codegen::is_identifier(struct_name) == false) {
+      throw std::runtime_error{"\"" + struct_name +
+                               "\" is not a valid C++ name"};
+    }
+    for (std::size_t pos{0}; pos <= name_space.size();) {
+      const std::size_t end{
+          std::min(name_space.find("::", pos), name_space.size())};
+      if ((name_space.empty() == false) &&
+          (codegen::is_identifier(std::string_view{name_space}.substr(
+               pos, end - pos)) == false)) {
+        throw std::runtime_error{"\"" + name_space +
+                                 "\" is not a valid C++ namespace"};
+      }
+      pos = end + 2;
+    }
+
+    const node_ptr<map_node> schema{parse_file(schema_path)};
+    std::set<std::string> names{struct_name};
+    codegen::schema_type root{node_type::Map, struct_name, "{}", nullptr, {},
+                              0};
+    codegen::read_fields(map_view{schema}, "", root, names);
+    std::cout << codegen::generate_header(root, schema_path, name_space);
+  } catch (const std::exception &error) {
+    std::cerr << argv[0] << ": " << error.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,563 @@
+#include "config_image.hpp"
+
+#include "array_node.hpp"
+#include "float_node.hpp"
+#include "integer_node.hpp"
+#include "map_node.hpp"
+#include "node.hpp"
+#include "node_ptr.hpp"
+#include "node_types.hpp"
+#include "numeral_system.hpp"
+#include "string_node.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace libconfigfile {
+namespace impl {
+struct image_writer {
+  std::string bytes;
+  std::unordered_map<std::string_view, std::uint64_t> string_offsets;
+};
+
+template <typename t_value>
+static void image_append(std::string &bytes, const t_value &value) {
+  bytes.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void image_align(std::string &bytes) {
+  bytes.resize((bytes.size() + (alignof(std::uint64_t) - 1)) &
+                   (~(alignof(std::uint64_t) - 1)),
+               '\0');
+}
+
+static std::uint32_t image_length(const std::size_t length) {
+  if (length > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::length_error{"value is too large for a config image"};
+  }
+  return static_cast<std::uint32_t>(length);
+}
+
+static std::uint64_t image_append_string(image_writer &writer,
+                                         const std::string_view str) {
+  const auto [pos, inserted]{
+      writer.string_offsets.try_emplace(str, writer.bytes.size())};
+  if (inserted == true) {
+    writer.bytes.append(str);
+  }
+  return pos->second;
+}
+
+static image_format::slot image_write_value(image_writer &writer,
+                                            const node *value) {
+  image_format::slot ret_val{static_cast<std::uint8_t>(node_type::Null), 0, 0,
+                             0, 0};
+  if (value == nullptr) {
+    return ret_val;
+  }
+
+  ret_val.type = static_cast<std::uint8_t>(value->get_node_type());
+  switch (value->get_node_type()) {
+  case node_type::String: {
+    const std::string_view str{*(static_cast<const string_node *>(value))};
+    ret_val.length = image_length(str.size());
+    ret_val.payload = image_append_string(writer, str);
+  } break;
+
+  case node_type::Integer: {
+    const integer_node *integer{static_cast<const integer_node *>(value)};
+    ret_val.integer_base =
+        static_cast<std::uint8_t>(integer->get_num_sys()->base);
+    ret_val.payload = std::bit_cast<std::uint64_t>(integer->get());
+  } break;
+
+  case node_type::Float: {
+    ret_val.payload = std::bit_cast<std::uint64_t>(
+        static_cast<const float_node *>(value)->get());
+  } break;
+
+  case node_type::Array: {
+    const array_node &array{*(static_cast<const array_node *>(value))};
+    std::vector<image_format::slot> elements{};
+    elements.reserve(array.size());
+    for (const node_ptr<node, true> &element : array) {
+      elements.push_back(image_write_value(writer, element.get()));
+    }
+
+    image_align(writer.bytes);
+    ret_val.length = image_length(elements.size());
+    ret_val.payload = writer.bytes.size();
+    for (const image_format::slot &element : elements) {
+      image_append(writer.bytes, element);
+    }
+  } break;
+
+  case node_type::Map: {
+    const map_node &map{*(static_cast<const map_node *>(value))};
+    std::vector<const map_node::value_type *> members{};
+    members.reserve(map.size());
+    for (const map_node::value_type &member : map) {
+      members.push_back(&member);
+    }
+    std::sort(members.begin(), members.end(),
+              [](const map_node::value_type *lhs,
+                 const map_node::value_type *rhs) {
+                return (lhs->first < rhs->first);
+              });
+
+    std::vector<image_format::key_entry> keys{};
+    std::vector<image_format::slot> values{};
+    keys.reserve(members.size());
+    values.reserve(members.size());
+    for (const map_node::value_type *member : members) {
+      keys.push_back(image_format::key_entry{
+          image_append_string(writer, member->first),
+          image_length(member->first.size()), 0});
+      values.push_back(image_write_value(writer, member->second.get()));
+    }
+
+    image_align(writer.bytes);
+    ret_val.length = image_length(members.size());
+    ret_val.payload = writer.bytes.size();
+    for (const image_format::key_entry &key : keys) {
+      image_append(writer.bytes, key);
+    }
+    for (const image_format::slot &member_value : values) {
+      image_append(writer.bytes, member_value);
+    }
+  } break;
+
+  default: {
+    ret_val.type = static_cast<std::uint8_t>(node_type::Null);
+  } break;
+  }
+
+  return ret_val;
+}
+
+[[noreturn]] static void throw_malformed_image() {
+  throw std::runtime_error{"config image is malformed"};
+}
+
+static void image_check_range(const std::string_view image,
+                              const std::uint64_t offset,
+                              const std::uint64_t count,
+                              const std::size_t element_size) {
+  if ((offset > image.size()) ||
+      (count > ((image.size() - offset) / element_size))) {
+    throw_malformed_image();
+  }
+}
+
+template <typename t_value>
+static t_value image_load(const std::string_view image,
+                          const std::uint64_t offset) {
+  image_check_range(image, offset, 1, sizeof(t_value));
+  t_value ret_val;
+  std::memcpy(&ret_val, image.data() + offset, sizeof(ret_val));
+  return ret_val;
+}
+
+static const numeral_system *image_num_sys(const std::uint8_t base) {
+  switch (base) {
+  case 2: {
+    return &numeral_system_binary;
+  } break;
+  case 8: {
+    return &numeral_system_octal;
+  } break;
+  case 16: {
+    return &numeral_system_hexadecimal;
+  } break;
+  default: {
+    return &numeral_system_decimal;
+  } break;
+  }
+}
+} // namespace impl
+} // namespace libconfigfile
+
+libconfigfile::image_view::image_view()
+    : m_image{},
+      m_slot{static_cast<std::uint8_t>(node_type::Null), 0, 0, 0, 0} {}
+
+libconfigfile::image_view::image_view(std::nullptr_t) : image_view{} {}
+
+libconfigfile::image_view::image_view(const std::string_view image,
+                                      const image_format::slot &slot)
+    : m_image{image}, m_slot{slot} {}
+
+libconfigfile::image_view::image_view(const image_view &other)
+    : m_image{other.m_image}, m_slot{other.m_slot} {}
+
+libconfigfile::image_view::~image_view() {}
+
+libconfigfile::image_view &
+libconfigfile::image_view::operator=(const image_view &other) {
+  if (this != &other) {
+    m_image = other.m_image;
+    m_slot = other.m_slot;
+  }
+  return *this;
+}
+
+libconfigfile::node_type libconfigfile::image_view::get_node_type() const {
+  switch (static_cast<node_type>(m_slot.type)) {
+  case node_type::String:
+  case node_type::Integer:
+  case node_type::Float:
+  case node_type::Array:
+  case node_type::Map: {
+    return static_cast<node_type>(m_slot.type);
+  } break;
+  default: {
+    return node_type::Null;
+  } break;
+  }
+}
+
+std::optional<std::int64_t> libconfigfile::image_view::get_integer() const {
+  if (get_node_type() == node_type::Integer) {
+    return std::bit_cast<std::int64_t>(m_slot.payload);
+  } else {
+    return std::nullopt;
+  }
+}
+
+const libconfigfile::numeral_system *
+libconfigfile::image_view::get_num_sys() const {
+  if (get_node_type() == node_type::Integer) {
+    return impl::image_num_sys(m_slot.integer_base);
+  } else {
+    return nullptr;
+  }
+}
+
+std::optional<double> libconfigfile::image_view::get_float() const {
+  if (get_node_type() == node_type::Float) {
+    return std::bit_cast<double>(m_slot.payload);
+  } else {
+    return std::nullopt;
+  }
+}
+
+std::optional<std::string_view> libconfigfile::image_view::get_string() const {
+  if (get_node_type() == node_type::String) {
+    return string_at(m_slot.payload, m_slot.length);
+  } else {
+    return std::nullopt;
+  }
+}
+
+libconfigfile::image_view
+libconfigfile::image_view::find(const std::string_view key) const {
+  if (get_node_type() != node_type::Map) {
+    return image_view{nullptr};
+  }
+
+  std::size_t first{0};
+  std::size_t last{m_slot.length};
+  while (first < last) {
+    const std::size_t middle{first + ((last - first) / 2)};
+    const image_format::key_entry entry{key_entry_at(middle)};
+    const int compared{string_at(entry.offset, entry.length).compare(key)};
+    if (compared < 0) {
+      first = middle + 1;
+    } else if (compared > 0) {
+      last = middle;
+    } else {
+      return find(middle);
+    }
+  }
+  return image_view{nullptr};
+}
+
+// For a map, returns the value of the member whose key is key_at(pos).
+libconfigfile::image_view
+libconfigfile::image_view::find(const std::size_t pos) const {
+  const node_type type{get_node_type()};
+  if (((type != node_type::Array) && (type != node_type::Map)) ||
+      (pos >= m_slot.length)) {
+    return image_view{nullptr};
+  }
+
+  const std::uint64_t slots_offset{
+      m_slot.payload +
+      ((type == node_type::Map)
+           ? (std::uint64_t{m_slot.length} * sizeof(image_format::key_entry))
+           : (0))};
+  return image_view{m_image,
+                    slot_at(slots_offset + (std::uint64_t{pos} *
+                                            sizeof(image_format::slot)))};
+}
+
+bool libconfigfile::image_view::contains(const std::string_view key) const {
+  return static_cast<bool>(find(key));
+}
+
+std::size_t libconfigfile::image_view::size() const {
+  switch (get_node_type()) {
+  case node_type::Array:
+  case node_type::Map: {
+    return m_slot.length;
+  } break;
+  default: {
+    return 0;
+  } break;
+  }
+}
+
+std::string_view
+libconfigfile::image_view::key_at(const std::size_t pos) const {
+  if ((get_node_type() != node_type::Map) || (pos >= m_slot.length)) {
+    throw std::out_of_range{"image_view::key_at"};
+  }
+  const image_format::key_entry entry{key_entry_at(pos)};
+  return string_at(entry.offset, entry.length);
+}
+
+libconfigfile::node_ptr<libconfigfile::node>
+libconfigfile::image_view::to_node() const {
+  node_ptr<node> ret_val{to_node(m_image.size())};
+  if (get_node_type() == node_type::Map) {
+    static_cast<map_node &>(*ret_val).set_is_root_map(true);
+  }
+  return ret_val;
+}
+
+// compile_image() writes the records of a container's members before its
+// own, so every record must start below `record_limit`, the start of its
+// parent's; this keeps a corrupted image from making the copy loop forever.
+libconfigfile::node_ptr<libconfigfile::node>
+libconfigfile::image_view::to_node(const std::uint64_t record_limit) const {
+  const node_type type{get_node_type()};
+  if (((type == node_type::Array) || (type == node_type::Map)) &&
+      (m_slot.length > 0)) {
+    impl::image_check_range(
+        m_image, m_slot.payload, m_slot.length,
+        ((type == node_type::Map)
+             ? (sizeof(image_format::key_entry) + sizeof(image_format::slot))
+             : (sizeof(image_format::slot))));
+    if (m_slot.payload >= record_limit) {
+      impl::throw_malformed_image();
+    }
+  }
+
+  switch (type) {
+  case node_type::String: {
+    return make_node_ptr<string_node>(std::string{get_string().value()});
+  } break;
+
+  case node_type::Integer: {
+    return make_node_ptr<integer_node>(get_integer().value(), get_num_sys());
+  } break;
+
+  case node_type::Float: {
+    return make_node_ptr<float_node>(get_float().value());
+  } break;
+
+  case node_type::Array: {
+    node_ptr<array_node> ret_val{make_node_ptr<array_node>()};
+    ret_val->reserve(size());
+    for (std::size_t i{0}; i < size(); ++i) {
+      ret_val->push_back(find(i).to_node(m_slot.payload));
+    }
+    return ret_val;
+  } break;
+
+  case node_type::Map: {
+    node_ptr<map_node> ret_val{make_node_ptr<map_node>()};
+    ret_val->reserve(size());
+    for (std::size_t i{0}; i < size(); ++i) {
+      ret_val->insert(
+          {std::string{key_at(i)}, find(i).to_node(m_slot.payload)});
+    }
+    return ret_val;
+  } break;
+
+  default: {
+    return node_ptr<node>{nullptr};
+  } break;
+  }
+}
+
+libconfigfile::image_view::operator bool() const {
+  return (get_node_type() != node_type::Null);
+}
+
+libconfigfile::image_view
+libconfigfile::image_view::operator[](const std::string_view key) const {
+  return find(key);
+}
+
+libconfigfile::image_view
+libconfigfile::image_view::operator[](const std::size_t pos) const {
+  return find(pos);
+}
+
+std::string_view
+libconfigfile::image_view::string_at(const std::uint64_t offset,
+                                     const std::size_t length) const {
+  impl::image_check_range(m_image, offset, length, 1);
+  return m_image.substr(static_cast<std::size_t>(offset), length);
+}
+
+libconfigfile::image_format::slot
+libconfigfile::image_view::slot_at(const std::uint64_t offset) const {
+  return impl::image_load<image_format::slot>(m_image, offset);
+}
+
+libconfigfile::image_format::key_entry
+libconfigfile::image_view::key_entry_at(const std::size_t pos) const {
+  return impl::image_load<image_format::key_entry>(
+      m_image,
+      m_slot.payload + (std::uint64_t{pos} * sizeof(image_format::key_entry)));
+}
+
+libconfigfile::image_view
+libconfigfile::image_root(const std::string_view image) {
+  const image_format::header header{
+      impl::image_load<image_format::header>(image, 0)};
+  if (std::memcmp(header.magic, image_format::k_magic,
+                  sizeof(header.magic)) != 0) {
+    throw std::runtime_error{"data is not a config image"};
+  } else if (header.byte_order_mark != image_format::k_byte_order_mark) {
+    throw std::runtime_error{
+        "config image was compiled for a different byte order"};
+  } else if (header.version != image_format::k_version) {
+    throw std::runtime_error{"config image version is not supported"};
+  } else if ((header.size > image.size()) ||
+             (header.root.type != static_cast<std::uint8_t>(node_type::Map))) {
+    impl::throw_malformed_image();
+  }
+  return image_view{image.substr(0, static_cast<std::size_t>(header.size)),
+                    header.root};
+}
+
+std::string libconfigfile::compile_image(const map_node &root) {
+  impl::image_writer writer{std::string(sizeof(image_format::header), '\0'),
+                            {}};
+  image_format::header header{};
+  header.root = impl::image_write_value(writer, &root);
+  impl::image_align(writer.bytes);
+
+  std::memcpy(header.magic, image_format::k_magic, sizeof(header.magic));
+  header.version = image_format::k_version;
+  header.byte_order_mark = image_format::k_byte_order_mark;
+  header.size = writer.bytes.size();
+  std::memcpy(writer.bytes.data(), &header, sizeof(header));
+  return std::move(writer.bytes);
+}
+
+void libconfigfile::write_image_file(const map_node &root,
+                                     const std::filesystem::path &file_path) {
+  const std::string image{compile_image(root)};
+  std::ofstream output_stream{file_path, std::ios::binary | std::ios::trunc};
+  output_stream.write(image.data(),
+                      static_cast<std::streamsize>(image.size()));
+  output_stream.close();
+  if (output_stream.fail() == true) {
+    throw std::runtime_error{"file \"" + file_path.string() +
+                             "\" could not be written"};
+  }
+}
+
+libconfigfile::config_image::config_image()
+    : m_mapping{nullptr}, m_size{0} {}
+
+libconfigfile::config_image::config_image(
+    const std::filesystem::path &file_path)
+    : m_mapping{nullptr}, m_size{0} {
+  const int fd{open(file_path.c_str(), O_RDONLY | O_CLOEXEC)};
+  if (fd == -1) {
+    throw std::system_error{errno, std::generic_category(),
+                            "file \"" + file_path.string() +
+                                "\" could not be opened for reading"};
+  }
+
+  try {
+    *this = config_image{fd, file_path.string()};
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  close(fd);
+}
+
+libconfigfile::config_image::config_image(const int fd,
+                                          const std::string &name)
+    : m_mapping{nullptr}, m_size{0} {
+  struct stat file_status{};
+  if (fstat(fd, &file_status) == -1) {
+    throw std::system_error{errno, std::generic_category(),
+                            "file \"" + name + "\" could not be examined"};
+  } else if (static_cast<std::size_t>(file_status.st_size) <
+             sizeof(image_format::header)) {
+    throw std::runtime_error{"data is not a config image"};
+  }
+
+  m_size = static_cast<std::size_t>(file_status.st_size);
+  m_mapping = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (m_mapping == MAP_FAILED) {
+    m_mapping = nullptr;
+    throw std::system_error{errno, std::generic_category(),
+                            "file \"" + name + "\" could not be mapped"};
+  }
+
+  try {
+    image_root(bytes());
+  } catch (...) {
+    munmap(m_mapping, m_size);
+    throw;
+  }
+}
+
+libconfigfile::config_image::config_image(config_image &&other) noexcept
+    : m_mapping{std::exchange(other.m_mapping, nullptr)},
+      m_size{std::exchange(other.m_size, 0)} {}
+
+libconfigfile::config_image::~config_image() {
+  if (m_mapping != nullptr) {
+    munmap(m_mapping, m_size);
+  }
+}
+
+libconfigfile::config_image &
+libconfigfile::config_image::operator=(config_image &&other) noexcept {
+  if (this != &other) {
+    if (m_mapping != nullptr) {
+      munmap(m_mapping, m_size);
+    }
+    m_mapping = std::exchange(other.m_mapping, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+  }
+  return *this;
+}
+
+std::string_view libconfigfile::config_image::bytes() const {
+  return std::string_view{static_cast<const char *>(m_mapping), m_size};
+}
+
+libconfigfile::image_view libconfigfile::config_image::root() const {
+  return image_root(bytes());
+}
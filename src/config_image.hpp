@@ -0,0 +1,184 @@
+#ifndef LIBCONFIGFILE_CONFIG_IMAGE_HPP
+#define LIBCONFIGFILE_CONFIG_IMAGE_HPP
+
+#include "map_node.hpp"
+#include "node.hpp"
+#include "node_ptr.hpp"
+#include "node_types.hpp"
+#include "numeral_system.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace libconfigfile {
+// A parsed tree laid out as a single relocatable block of bytes that can be
+// read in place, e.g. straight from a memory mapping. All references are byte
+// offsets from the start of the image. Every value is described by a
+// fixed-size slot; the contents of strings and the keys of maps are stored
+// once each in the same block. A map's keys are sorted, so lookups are a
+// binary search, and neither lookups nor reads allocate.
+//
+// Images are written in the byte order of the machine compiling them and are
+// rejected on a machine with another byte order.
+namespace image_format {
+static constexpr char k_magic[8]{'L', 'C', 'F', 'I', 'M', 'G', '\0', '\0'};
+static constexpr std::uint32_t k_version{1};
+static constexpr std::uint32_t k_byte_order_mark{0x01020304};
+
+// `length` is the size of a string or the element count of a container, and
+// `payload` holds an integer, the bits of a float, or the offset of a string's
+// bytes or a container's record. An array record is `length` slots; a map
+// record is `length` key_entry's followed by `length` slots.
+struct slot {
+  std::uint8_t type;
+  std::uint8_t integer_base;
+  std::uint16_t reserved_1;
+  std::uint32_t length;
+  std::uint64_t payload;
+};
+
+struct key_entry {
+  std::uint64_t offset;
+  std::uint32_t length;
+  std::uint32_t reserved_1;
+};
+
+struct header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order_mark;
+  std::uint64_t size;
+  slot root;
+};
+
+static_assert(sizeof(slot) == 16);
+static_assert(sizeof(key_entry) == 16);
+static_assert(sizeof(header) == 40);
+} // namespace image_format
+
+template <typename t_value>
+concept concept_image_view_value =
+    (std::integral<t_value> && (!(std::same_as<t_value, bool>))) ||
+    std::floating_point<t_value> || std::same_as<t_value, std::string_view>;
+
+// A value in a config image, with the same lookup interface as node_view. A
+// default-constructed view, or one returned by a failed lookup, refers to no
+// value. Views refer to the image's bytes and must not outlive them. Offsets
+// are bounds-checked as they are followed, and std::runtime_error is thrown if
+// one points outside of the image.
+class image_view {
+private:
+  std::string_view m_image;
+  image_format::slot m_slot;
+
+public:
+  image_view();
+  image_view(std::nullptr_t);
+  image_view(const std::string_view image, const image_format::slot &slot);
+  image_view(const image_view &other);
+
+  ~image_view();
+
+public:
+  image_view &operator=(const image_view &other);
+
+public:
+  node_type get_node_type() const;
+
+  std::optional<std::int64_t> get_integer() const;
+  const numeral_system *get_num_sys() const;
+  std::optional<double> get_float() const;
+  std::optional<std::string_view> get_string() const;
+
+  template <concept_image_view_value t_value>
+  std::optional<t_value> try_get() const {
+    if constexpr (std::same_as<t_value, std::string_view>) {
+      return get_string();
+    } else if constexpr (std::floating_point<t_value>) {
+      if (const std::optional<double> value{get_float()};
+          value.has_value() == true) {
+        return static_cast<t_value>(value.value());
+      }
+    } else {
+      if (const std::optional<std::int64_t> value{get_integer()};
+          (value.has_value() == true) &&
+          (std::in_range<t_value>(value.value()) == true)) {
+        return static_cast<t_value>(value.value());
+      }
+    }
+    return std::nullopt;
+  }
+
+  template <concept_image_view_value t_value>
+  t_value value_or(t_value default_value) const {
+    return try_get<t_value>().value_or(std::move(default_value));
+  }
+
+  image_view find(const std::string_view key) const;
+  image_view find(const std::size_t pos) const;
+  bool contains(const std::string_view key) const;
+  std::size_t size() const;
+  // The key of the member at `pos` of a map, in sorted order.
+  std::string_view key_at(const std::size_t pos) const;
+
+  // Copies the value into a node tree. A map becomes the root map of the
+  // tree, as if it had been parsed.
+  node_ptr<node> to_node() const;
+
+public:
+  explicit operator bool() const;
+
+  image_view operator[](const std::string_view key) const;
+  image_view operator[](const std::size_t pos) const;
+
+private:
+  std::string_view string_at(const std::uint64_t offset,
+                             const std::size_t length) const;
+  image_format::slot slot_at(const std::uint64_t offset) const;
+  image_format::key_entry key_entry_at(const std::size_t pos) const;
+  node_ptr<node> to_node(const std::uint64_t record_limit) const;
+};
+
+// Checks the header of an image and returns a view of its root map.
+image_view image_root(const std::string_view image);
+
+std::string compile_image(const map_node &root);
+void write_image_file(const map_node &root,
+                      const std::filesystem::path &file_path);
+
+// An image file mapped read-only into memory. Pages are only read from disk
+// as they are touched, and are shared with every other process mapping the
+// same file. A default-constructed config_image maps nothing.
+class config_image {
+private:
+  void *m_mapping;
+  std::size_t m_size;
+
+public:
+  config_image();
+  explicit config_image(const std::filesystem::path &file_path);
+  // Maps the image in an already open file, e.g. a shared memory object. The
+  // descriptor isn't closed; `name` is only used in error messages.
+  config_image(const int fd, const std::string &name);
+  config_image(const config_image &other) = delete;
+  config_image(config_image &&other) noexcept;
+
+  ~config_image();
+
+public:
+  config_image &operator=(const config_image &other) = delete;
+  config_image &operator=(config_image &&other) noexcept;
+
+public:
+  std::string_view bytes() const;
+  image_view root() const;
+};
+} // namespace libconfigfile
+
+#endif
@@ -0,0 +1,351 @@
+#include "config_manager.hpp"
+
+#include "map_node.hpp"
+#include "node_ptr.hpp"
+#include "parser.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+libconfigfile::config_manager::reader::reader(const config_manager &manager)
+    : m_manager{&manager}, m_snapshot{manager.snapshot()},
+      m_generation{manager.generation()} {}
+
+libconfigfile::config_manager::reader::reader(const reader &other)
+    : m_manager{other.m_manager}, m_snapshot{other.m_snapshot},
+      m_generation{other.m_generation} {}
+
+libconfigfile::config_manager::reader::reader(reader &&other) noexcept
+    : m_manager{other.m_manager}, m_snapshot{std::move(other.m_snapshot)},
+      m_generation{other.m_generation} {}
+
+libconfigfile::config_manager::reader::~reader() {}
+
+libconfigfile::config_manager::reader &
+libconfigfile::config_manager::reader::operator=(const reader &other) {
+  if (this != &other) {
+    m_manager = other.m_manager;
+    m_snapshot = other.m_snapshot;
+    m_generation = other.m_generation;
+  }
+  return *this;
+}
+
+libconfigfile::config_manager::reader &
+libconfigfile::config_manager::reader::operator=(reader &&other) noexcept {
+  if (this != &other) {
+    m_manager = other.m_manager;
+    m_snapshot = std::move(other.m_snapshot);
+    m_generation = other.m_generation;
+  }
+  return *this;
+}
+
+const libconfigfile::map_node &libconfigfile::config_manager::reader::get() {
+  return *(get_snapshot());
+}
+
+const libconfigfile::config_manager::snapshot_t &
+libconfigfile::config_manager::reader::get_snapshot() {
+  // The generation counter is the only shared state touched on the fast path;
+  // the reference-counted snapshot is reloaded only after a publication.
+  const std::uint64_t cur_generation{m_manager->generation()};
+  if (cur_generation != m_generation) {
+    m_snapshot = m_manager->snapshot();
+    m_generation = cur_generation;
+  }
+  return m_snapshot;
+}
+
+std::uint64_t
+libconfigfile::config_manager::reader::get_generation() const {
+  return m_generation;
+}
+
+libconfigfile::config_manager::config_manager(
+    const std::filesystem::path &file_path,
+    const std::chrono::milliseconds
+        debounce_interval /*= k_default_debounce_interval*/,
+    reload_callback_t reload_callback /*= {}*/,
+    error_callback_t error_callback /*= {}*/,
+    const parser::parse_options &parse_options /*= parser::parse_options{}*/)
+    : m_file_path{std::filesystem::absolute(file_path).lexically_normal()},
+      m_debounce_interval{debounce_interval},
+      m_reload_callback{std::move(reload_callback)},
+      m_error_callback{std::move(error_callback)},
+      m_parse_options{parse_options}, m_snapshot{nullptr},
+      m_generation{0}, m_reload_mutex{}, m_dependency_paths{},
+      m_inotify_fd{-1}, m_stop_fd{-1}, m_watched_directories{},
+      m_watcher_thread{} {
+  // A deadline is a point in time, which later reloads would be past, and
+  // spans would be written by the watcher thread while they may be read.
+  m_parse_options.deadline.reset();
+  m_parse_options.spans = nullptr;
+
+  std::vector<std::filesystem::path> included_file_paths{};
+  snapshot_t initial_snapshot{
+      parser::parse_file(m_file_path, included_file_paths, m_parse_options)
+          .release()};
+
+  m_dependency_paths.push_back(m_file_path);
+  for (const std::filesystem::path &p : included_file_paths) {
+    m_dependency_paths.push_back(std::filesystem::absolute(p).lexically_normal());
+  }
+
+  m_snapshot.store(std::move(initial_snapshot), std::memory_order_release);
+  m_generation.store(1, std::memory_order_release);
+
+  m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_inotify_fd == -1) {
+    throw std::system_error{errno, std::generic_category(),
+                            "inotify could not be initialized"};
+  }
+
+  m_stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_stop_fd == -1) {
+    const int error{errno};
+    close(m_inotify_fd);
+    throw std::system_error{error, std::generic_category(),
+                            "eventfd could not be created"};
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{m_reload_mutex};
+    update_watches();
+  }
+
+  m_watcher_thread = std::thread{&config_manager::watch_loop, this};
+}
+
+libconfigfile::config_manager::~config_manager() {
+  const std::uint64_t stop_signal{1};
+  [[maybe_unused]] const ssize_t res{
+      write(m_stop_fd, &stop_signal, sizeof(stop_signal))};
+
+  if (m_watcher_thread.joinable()) {
+    m_watcher_thread.join();
+  }
+
+  close(m_stop_fd);
+  close(m_inotify_fd);
+}
+
+libconfigfile::config_manager::snapshot_t
+libconfigfile::config_manager::snapshot() const {
+  return m_snapshot.load(std::memory_order_acquire);
+}
+
+std::uint64_t libconfigfile::config_manager::generation() const {
+  return m_generation.load(std::memory_order_acquire);
+}
+
+libconfigfile::config_manager::reader
+libconfigfile::config_manager::make_reader() const {
+  return reader{*this};
+}
+
+const std::filesystem::path &
+libconfigfile::config_manager::file_path() const {
+  return m_file_path;
+}
+
+std::vector<std::filesystem::path>
+libconfigfile::config_manager::dependency_paths() {
+  std::lock_guard<std::mutex> lock{m_reload_mutex};
+  return m_dependency_paths;
+}
+
+bool libconfigfile::config_manager::reload() {
+  snapshot_t new_snapshot{nullptr};
+  std::exception_ptr error{nullptr};
+
+  {
+    std::lock_guard<std::mutex> lock{m_reload_mutex};
+
+    std::vector<std::filesystem::path> included_file_paths{};
+    try {
+      new_snapshot.reset(
+          parser::parse_file(m_file_path, included_file_paths, m_parse_options)
+              .release());
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    std::vector<std::filesystem::path> new_dependency_paths{m_file_path};
+    for (const std::filesystem::path &p : included_file_paths) {
+      new_dependency_paths.push_back(
+          std::filesystem::absolute(p).lexically_normal());
+    }
+
+    if (error == nullptr) {
+      m_dependency_paths = std::move(new_dependency_paths);
+      m_snapshot.store(new_snapshot, std::memory_order_release);
+      m_generation.fetch_add(1, std::memory_order_acq_rel);
+    } else {
+      // A failed parse keeps the last good tree, but any file it got as far
+      // as including must be watched too, or fixing it would go unnoticed.
+      for (std::filesystem::path &p : new_dependency_paths) {
+        if (std::find(m_dependency_paths.begin(), m_dependency_paths.end(),
+                      p) == m_dependency_paths.end()) {
+          m_dependency_paths.push_back(std::move(p));
+        }
+      }
+    }
+
+    update_watches();
+  }
+
+  if (error == nullptr) {
+    if (m_reload_callback) {
+      m_reload_callback(new_snapshot);
+    }
+    return true;
+  } else {
+    if (m_error_callback) {
+      m_error_callback(error);
+    }
+    return false;
+  }
+}
+
+void libconfigfile::config_manager::watch_loop() {
+  static constexpr std::uint32_t k_event_mask{IN_CLOSE_WRITE | IN_MOVED_TO |
+                                              IN_CREATE | IN_DELETE |
+                                              IN_MOVED_FROM};
+  static_assert((k_event_mask & IN_ALL_EVENTS) == k_event_mask);
+
+  alignas(inotify_event) std::array<char, 4096> buffer{};
+
+  bool reload_pending{false};
+  std::chrono::steady_clock::time_point reload_deadline{};
+
+  while (true) {
+    int timeout_ms{-1};
+    if (reload_pending == true) {
+      const auto remaining{
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              reload_deadline - std::chrono::steady_clock::now())};
+      timeout_ms = static_cast<int>(
+          std::max(remaining.count(), decltype(remaining)::rep{0}));
+    }
+
+    std::array<pollfd, 2> poll_fds{{{m_inotify_fd, POLLIN, 0},
+                                    {m_stop_fd, POLLIN, 0}}};
+    if (poll(poll_fds.data(), poll_fds.size(), timeout_ms) == -1) {
+      if (errno == EINTR) {
+        continue;
+      } else {
+        if (m_error_callback) {
+          m_error_callback(std::make_exception_ptr(std::system_error{
+              errno, std::generic_category(), "inotify could not be polled"}));
+        }
+        return;
+      }
+    }
+
+    if ((poll_fds[1].revents & POLLIN) != 0) {
+      return;
+    }
+
+    if ((poll_fds[0].revents & POLLIN) != 0) {
+      bool relevant{false};
+
+      while (true) {
+        const ssize_t len{read(m_inotify_fd, buffer.data(), buffer.size())};
+        if (len <= 0) {
+          break;
+        }
+
+        std::lock_guard<std::mutex> lock{m_reload_mutex};
+        for (ssize_t offset{0}; offset < len;) {
+          const inotify_event *event{
+              reinterpret_cast<const inotify_event *>(buffer.data() + offset)};
+          offset += sizeof(inotify_event) + event->len;
+
+          if ((event->mask & IN_Q_OVERFLOW) != 0) {
+            relevant = true;
+          } else if ((event->mask & IN_IGNORED) != 0) {
+            if (m_watched_directories.erase(event->wd) != 0) {
+              relevant = true;
+            }
+          } else if (((event->mask & k_event_mask) != 0) && (event->len > 0) &&
+                     (is_watched_event(event->wd, event->name) == true)) {
+            relevant = true;
+          }
+        }
+      }
+
+      if (relevant == true) {
+        reload_pending = true;
+        reload_deadline =
+            std::chrono::steady_clock::now() + m_debounce_interval;
+      }
+    }
+
+    if ((reload_pending == true) &&
+        (std::chrono::steady_clock::now() >= reload_deadline)) {
+      reload_pending = false;
+      reload();
+    }
+  }
+}
+
+void libconfigfile::config_manager::update_watches() {
+  // Directories rather than files are watched so that editors which save by
+  // writing a temporary file and renaming it over the original are noticed.
+  static constexpr std::uint32_t k_watch_mask{
+      IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+      IN_ONLYDIR};
+
+  std::unordered_map<int, watched_directory> new_watched_directories{};
+
+  for (const std::filesystem::path &p : m_dependency_paths) {
+    const std::filesystem::path dir{p.parent_path()};
+    const int wd{inotify_add_watch(m_inotify_fd, dir.c_str(), k_watch_mask)};
+    if (wd == -1) {
+      continue;
+    }
+
+    watched_directory &entry{new_watched_directories[wd]};
+    entry.path = dir;
+    entry.file_names.insert(p.filename().string());
+  }
+
+  for (const auto &[wd, entry] : m_watched_directories) {
+    if (new_watched_directories.contains(wd) == false) {
+      inotify_rm_watch(m_inotify_fd, wd);
+    }
+  }
+
+  m_watched_directories = std::move(new_watched_directories);
+}
+
+bool libconfigfile::config_manager::is_watched_event(
+    const int watch_descriptor, const std::string &file_name) const {
+  auto entry{m_watched_directories.find(watch_descriptor)};
+  return ((entry != m_watched_directories.end()) &&
+          (entry->second.file_names.contains(file_name)));
+}
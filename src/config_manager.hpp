@@ -0,0 +1,115 @@
+#ifndef LIBCONFIGFILE_CONFIG_MANAGER_HPP
+#define LIBCONFIGFILE_CONFIG_MANAGER_HPP
+
+#include "map_node.hpp"
+#include "parser.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace libconfigfile {
+class config_manager {
+public:
+  using snapshot_t = std::shared_ptr<const map_node>;
+  using reload_callback_t = std::function<void(const snapshot_t &snapshot)>;
+  using error_callback_t = std::function<void(std::exception_ptr error)>;
+
+public:
+  static constexpr std::chrono::milliseconds k_default_debounce_interval{100};
+
+public:
+  class reader {
+  private:
+    const config_manager *m_manager;
+    snapshot_t m_snapshot;
+    std::uint64_t m_generation;
+
+  public:
+    explicit reader(const config_manager &manager);
+    reader(const reader &other);
+    reader(reader &&other) noexcept;
+
+    ~reader();
+
+  public:
+    reader &operator=(const reader &other);
+    reader &operator=(reader &&other) noexcept;
+
+  public:
+    const map_node &get();
+    const snapshot_t &get_snapshot();
+    std::uint64_t get_generation() const;
+  };
+
+private:
+  struct watched_directory {
+    std::filesystem::path path;
+    std::unordered_set<std::string> file_names;
+  };
+
+private:
+  std::filesystem::path m_file_path;
+  std::chrono::milliseconds m_debounce_interval;
+  reload_callback_t m_reload_callback;
+  error_callback_t m_error_callback;
+  // Used for every parse, without the deadline and spans; see the constructor.
+  parser::parse_options m_parse_options;
+
+  std::atomic<snapshot_t> m_snapshot;
+  std::atomic<std::uint64_t> m_generation;
+
+  std::mutex m_reload_mutex;
+  std::vector<std::filesystem::path> m_dependency_paths;
+
+  int m_inotify_fd;
+  int m_stop_fd;
+  std::unordered_map<int, watched_directory> m_watched_directories;
+  std::thread m_watcher_thread;
+
+public:
+  explicit config_manager(
+      const std::filesystem::path &file_path,
+      const std::chrono::milliseconds debounce_interval =
+          k_default_debounce_interval,
+      reload_callback_t reload_callback = {},
+      error_callback_t error_callback = {},
+      const parser::parse_options &parse_options = parser::parse_options{});
+  config_manager(const config_manager &other) = delete;
+  config_manager(config_manager &&other) = delete;
+
+  ~config_manager();
+
+public:
+  config_manager &operator=(const config_manager &other) = delete;
+  config_manager &operator=(config_manager &&other) = delete;
+
+public:
+  snapshot_t snapshot() const;
+  std::uint64_t generation() const;
+  reader make_reader() const;
+
+  const std::filesystem::path &file_path() const;
+  std::vector<std::filesystem::path> dependency_paths();
+
+  bool reload();
+
+private:
+  void watch_loop();
+  void update_watches();
+  bool is_watched_event(const int watch_descriptor,
+                        const std::string &file_name) const;
+};
+} // namespace libconfigfile
+
+#endif
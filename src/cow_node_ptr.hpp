@@ -0,0 +1,285 @@
+#ifndef LIBCONFIGFILE_COW_NODE_PTR_HPP
+#define LIBCONFIGFILE_COW_NODE_PTR_HPP
+
+#include "node.hpp"
+#include "node_ptr.hpp"
+
+#include <atomic>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace libconfigfile {
+namespace impl {
+struct cow_control_block {
+  std::atomic<long> ref_count;
+  node *owned;
+};
+} // namespace impl
+
+template <concept_node_type t_node, bool t_compare_equality_by_value = false>
+class cow_node_ptr {
+  template <concept_node_type t_node_1, bool t_compare_equality_by_value_1>
+  friend class cow_node_ptr;
+
+public:
+  using t_ptr = t_node *;
+  using t_const_ptr = const t_node *;
+
+private:
+  impl::cow_control_block *m_block;
+  t_ptr m_ptr;
+
+private:
+  cow_node_ptr(impl::cow_control_block *block, t_ptr ptr)
+      : m_block{block}, m_ptr{ptr} {
+    acquire();
+  }
+
+public:
+  cow_node_ptr() : m_block{nullptr}, m_ptr{nullptr} {}
+
+  cow_node_ptr(std::nullptr_t) : m_block{nullptr}, m_ptr{nullptr} {}
+
+  explicit cow_node_ptr(t_ptr ptr)
+      : m_block{((ptr == nullptr) ? (nullptr)
+                                  : (new impl::cow_control_block{1, ptr}))},
+        m_ptr{ptr} {}
+
+  template <concept_node_type t_node_from, bool t_compare_equality_by_value_from>
+    requires concept_node_ptr_implicitly_upcastable<t_node, t_node_from>
+  cow_node_ptr(node_ptr<t_node_from, t_compare_equality_by_value_from> &&np)
+      : cow_node_ptr{static_cast<t_ptr>(np.get())} {
+    np.release();
+  }
+
+  cow_node_ptr(const cow_node_ptr &other)
+      : m_block{other.m_block}, m_ptr{other.m_ptr} {
+    acquire();
+  }
+
+  cow_node_ptr(cow_node_ptr &&other) noexcept
+      : m_block{other.m_block}, m_ptr{other.m_ptr} {
+    other.m_block = nullptr;
+    other.m_ptr = nullptr;
+  }
+
+  template <concept_node_type t_node_from, bool t_compare_equality_by_value_from>
+    requires(concept_node_ptr_implicitly_upcastable<t_node, t_node_from> &&
+             (!(std::same_as<cow_node_ptr<t_node_from,
+                                          t_compare_equality_by_value_from>,
+                             cow_node_ptr>)))
+  cow_node_ptr(
+      const cow_node_ptr<t_node_from, t_compare_equality_by_value_from> &other)
+      : m_block{other.m_block}, m_ptr{other.m_ptr} {
+    acquire();
+  }
+
+  template <concept_node_type t_node_from, bool t_compare_equality_by_value_from>
+    requires(concept_node_ptr_implicitly_upcastable<t_node, t_node_from> &&
+             (!(std::same_as<cow_node_ptr<t_node_from,
+                                          t_compare_equality_by_value_from>,
+                             cow_node_ptr>)))
+  cow_node_ptr(
+      cow_node_ptr<t_node_from, t_compare_equality_by_value_from> &&other) noexcept
+      : m_block{other.m_block}, m_ptr{other.m_ptr} {
+    other.m_block = nullptr;
+    other.m_ptr = nullptr;
+  }
+
+  ~cow_node_ptr() { release(); }
+
+private:
+  void acquire() {
+    if (m_block != nullptr) {
+      m_block->ref_count.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void release() {
+    if (m_block != nullptr) {
+      if (m_block->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete m_block->owned;
+        delete m_block;
+      }
+      m_block = nullptr;
+      m_ptr = nullptr;
+    }
+  }
+
+public:
+  void reset(t_ptr ptr = nullptr) { cow_node_ptr{ptr}.swap(*this); }
+
+  void swap(cow_node_ptr &other) {
+    using std::swap;
+    swap(m_block, other.m_block);
+    swap(m_ptr, other.m_ptr);
+  }
+
+  t_const_ptr get() const { return m_ptr; }
+
+  t_ptr get_mutable() {
+    if ((m_ptr != nullptr) && (unique() == false)) {
+      reset(static_cast<t_ptr>(node_clone(*m_ptr)));
+    }
+    return m_ptr;
+  }
+
+  long use_count() const {
+    return ((m_block == nullptr)
+                ? (0)
+                : (m_block->ref_count.load(std::memory_order_acquire)));
+  }
+
+  bool unique() const { return use_count() == 1; }
+
+  node_ptr<t_node, t_compare_equality_by_value> to_node_ptr() const & {
+    return node_ptr<t_node, t_compare_equality_by_value>{
+        ((m_ptr == nullptr) ? (nullptr)
+                            : (static_cast<t_ptr>(node_clone(*m_ptr))))};
+  }
+
+  node_ptr<t_node, t_compare_equality_by_value> to_node_ptr() && {
+    if ((m_ptr != nullptr) && (unique() == true) &&
+        (static_cast<node *>(m_ptr) == m_block->owned)) {
+      t_ptr ptr{m_ptr};
+      delete m_block;
+      m_block = nullptr;
+      m_ptr = nullptr;
+      return node_ptr<t_node, t_compare_equality_by_value>{ptr};
+    } else {
+      node_ptr<t_node, t_compare_equality_by_value> ret_val{to_node_ptr()};
+      release();
+      return ret_val;
+    }
+  }
+
+public:
+  cow_node_ptr &operator=(const cow_node_ptr &other) {
+    if (this != &other) {
+      cow_node_ptr{other}.swap(*this);
+    }
+    return *this;
+  }
+
+  cow_node_ptr &operator=(cow_node_ptr &&other) noexcept {
+    if (this != &other) {
+      release();
+      m_block = other.m_block;
+      m_ptr = other.m_ptr;
+      other.m_block = nullptr;
+      other.m_ptr = nullptr;
+    }
+    return *this;
+  }
+
+  cow_node_ptr &operator=(std::nullptr_t) {
+    release();
+    return *this;
+  }
+
+  explicit operator bool() const { return m_ptr != nullptr; }
+
+  const t_node &operator*() const { return *get(); }
+
+  t_const_ptr operator->() const { return get(); }
+
+public:
+  template <concept_node_type t_node_to, bool t_compare_equality_by_value_1,
+            concept_node_type t_node_from, bool t_compare_equality_by_value_2>
+  friend cow_node_ptr<t_node_to, t_compare_equality_by_value_1>
+  cow_node_ptr_cast(
+      const cow_node_ptr<t_node_from, t_compare_equality_by_value_2> &np);
+
+  template <concept_node_type t_node_1, bool t_compare_equality_by_value_1,
+            typename... t_args>
+  friend cow_node_ptr<t_node_1, t_compare_equality_by_value_1>
+  make_cow_node_ptr(t_args &&...args);
+};
+
+template <
+    concept_node_type t_node_to, bool t_compare_equality_by_value_1 = false,
+    concept_node_type t_node_from, bool t_compare_equality_by_value_2 = false>
+cow_node_ptr<t_node_to, t_compare_equality_by_value_1> cow_node_ptr_cast(
+    const cow_node_ptr<t_node_from, t_compare_equality_by_value_2> &np) {
+  if (np.get() == nullptr) {
+    return cow_node_ptr<t_node_to, t_compare_equality_by_value_1>{nullptr};
+  } else {
+    auto ptr{dynamic_cast<
+        typename cow_node_ptr<t_node_to, t_compare_equality_by_value_1>::t_ptr>(
+        np.m_ptr)};
+
+    if (ptr != nullptr) {
+      return cow_node_ptr<t_node_to, t_compare_equality_by_value_1>{np.m_block,
+                                                                    ptr};
+    } else {
+      throw std::runtime_error{"bad cow_node_ptr_cast"};
+    }
+  }
+}
+
+template <concept_node_type t_node_1,
+          bool t_compare_equality_by_value_1 = false, typename... t_args>
+cow_node_ptr<t_node_1, t_compare_equality_by_value_1>
+make_cow_node_ptr(t_args &&...args) {
+  return cow_node_ptr<t_node_1, t_compare_equality_by_value_1>{
+      new t_node_1{std::forward<t_args>(args)...}};
+}
+
+template <concept_node_type t_node_1, concept_node_type t_node_2>
+bool operator==(const cow_node_ptr<t_node_1, false> &x,
+                const cow_node_ptr<t_node_2, false> &y) {
+  return ((static_cast<const node *>(x.get())) ==
+          (static_cast<const node *>(y.get())));
+}
+
+template <concept_node_type t_node_1>
+bool operator==(const cow_node_ptr<t_node_1, false> &x, std::nullptr_t) {
+  return ((x.get()) == (nullptr));
+}
+
+template <concept_node_type t_node_1, concept_node_type t_node_2>
+bool operator!=(const cow_node_ptr<t_node_1, false> &x,
+                const cow_node_ptr<t_node_2, false> &y) {
+  return (!(x == y));
+}
+
+template <concept_node_type t_node_1>
+bool operator!=(const cow_node_ptr<t_node_1, false> &x, std::nullptr_t) {
+  return (!(x == nullptr));
+}
+
+template <concept_node_type t_node_1, concept_node_type t_node_2>
+bool operator==(const cow_node_ptr<t_node_1, true> &x,
+                const cow_node_ptr<t_node_2, true> &y) {
+  if ((static_cast<const node *>(x.get())) ==
+      (static_cast<const node *>(y.get()))) {
+    return true;
+  } else if ((x.get() == nullptr) || (y.get() == nullptr)) {
+    return false;
+  } else {
+    return (node_val_equal_to(*(x.get()), *(y.get())));
+  }
+}
+
+template <concept_node_type t_node_1, concept_node_type t_node_2>
+bool operator!=(const cow_node_ptr<t_node_1, true> &x,
+                const cow_node_ptr<t_node_2, true> &y) {
+  return (!(x == y));
+}
+
+template <concept_node_type t_node_1, bool t_compare_equality_by_value_1>
+std::ostream &
+operator<<(std::ostream &out,
+           const cow_node_ptr<t_node_1, t_compare_equality_by_value_1> &p) {
+  p.get()->print(out);
+  return out;
+}
+
+} // namespace libconfigfile
+
+#endif
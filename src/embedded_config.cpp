@@ -0,0 +1,58 @@
+#include "embedded_config.hpp"
+
+#include "array_node.hpp"
+#include "float_node.hpp"
+#include "integer_node.hpp"
+#include "map_node.hpp"
+#include "node.hpp"
+#include "node_ptr.hpp"
+#include "node_types.hpp"
+#include "string_node.hpp"
+
+#include <cstddef>
+#include <string>
+
+libconfigfile::node_ptr<libconfigfile::node>
+libconfigfile::embedded_view::to_node() const {
+  return to_node(true);
+}
+
+libconfigfile::node_ptr<libconfigfile::node>
+libconfigfile::embedded_view::to_node(const bool is_root) const {
+  switch (get_node_type()) {
+  case node_type::String: {
+    return make_node_ptr<string_node>(std::string{get_string().value()});
+  } break;
+
+  case node_type::Integer: {
+    return make_node_ptr<integer_node>(get_integer().value(), get_num_sys());
+  } break;
+
+  case node_type::Float: {
+    return make_node_ptr<float_node>(get_float().value());
+  } break;
+
+  case node_type::Array: {
+    node_ptr<array_node> ret_val{make_node_ptr<array_node>()};
+    ret_val->reserve(size());
+    for (std::size_t i{0}; i < size(); ++i) {
+      ret_val->push_back(find(i).to_node(false));
+    }
+    return ret_val;
+  } break;
+
+  case node_type::Map: {
+    node_ptr<map_node> ret_val{make_node_ptr<map_node>()};
+    ret_val->set_is_root_map(is_root);
+    ret_val->reserve(size());
+    for (std::size_t i{0}; i < size(); ++i) {
+      ret_val->insert({std::string{key_at(i)}, find(i).to_node(false)});
+    }
+    return ret_val;
+  } break;
+
+  default: {
+    return node_ptr<node>{nullptr};
+  } break;
+  }
+}
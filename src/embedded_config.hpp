@@ -0,0 +1,485 @@
+#ifndef LIBCONFIGFILE_EMBEDDED_CONFIG_HPP
+#define LIBCONFIGFILE_EMBEDDED_CONFIG_HPP
+
+#include "error_messages.hpp"
+#include "event_parser.hpp"
+#include "node.hpp"
+#include "node_ptr.hpp"
+#include "node_types.hpp"
+#include "numeral_system.hpp"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace libconfigfile {
+// The text of a configuration embedded in the program, as a template argument.
+// Built from a string literal, or from any constexpr char array (e.g. one
+// initialized with #embed); a trailing null character is ignored.
+template <std::size_t t_size> struct embedded_text {
+  char chars[t_size];
+
+  consteval embedded_text(const char (&text)[t_size]) : chars{} {
+    std::copy_n(text, t_size, chars);
+  }
+
+  consteval explicit embedded_text(const std::string_view text) : chars{} {
+    std::copy_n(text.data(), std::min(text.size(), t_size), chars);
+  }
+
+  constexpr std::string_view view() const {
+    return std::string_view{
+        chars, (((t_size > 0) && (chars[t_size - 1] == '\0')) ? (t_size - 1)
+                                                                : (t_size))};
+  }
+};
+
+namespace impl {
+struct embedded_value {
+  node_type type;
+  const numeral_system *num_sys;
+  std::int64_t integer;
+  double floating;
+  // The position and size of a string's characters, or of a container's
+  // members among the values. A map's members are sorted by key.
+  std::size_t offset;
+  std::size_t length;
+  std::size_t key_offset;
+  std::size_t key_length;
+};
+} // namespace impl
+
+template <typename t_value>
+concept concept_embedded_view_value =
+    (std::integral<t_value> && (!(std::same_as<t_value, bool>))) ||
+    std::floating_point<t_value> || std::same_as<t_value, std::string_view>;
+
+// A value in an embedded config, with the same lookup interface as node_view
+// and image_view. Everything but to_node() can be used in constant
+// expressions, so lookups of constant keys in a constexpr config are folded.
+class embedded_view {
+private:
+  const impl::embedded_value *m_values;
+  const char *m_chars;
+  const impl::embedded_value *m_value;
+
+public:
+  constexpr embedded_view()
+      : m_values{nullptr}, m_chars{nullptr}, m_value{nullptr} {}
+
+  constexpr embedded_view(std::nullptr_t) : embedded_view{} {}
+
+  constexpr embedded_view(const impl::embedded_value *values, const char *chars,
+                          const impl::embedded_value *value)
+      : m_values{values}, m_chars{chars}, m_value{value} {}
+
+  constexpr embedded_view(const embedded_view &other)
+      : m_values{other.m_values}, m_chars{other.m_chars},
+        m_value{other.m_value} {}
+
+  constexpr ~embedded_view() {}
+
+public:
+  constexpr embedded_view &operator=(const embedded_view &other) {
+    if (this != &other) {
+      m_values = other.m_values;
+      m_chars = other.m_chars;
+      m_value = other.m_value;
+    }
+    return *this;
+  }
+
+public:
+  constexpr node_type get_node_type() const {
+    return ((m_value != nullptr) ? (m_value->type) : (node_type::Null));
+  }
+
+  constexpr std::optional<std::int64_t> get_integer() const {
+    if (get_node_type() == node_type::Integer) {
+      return m_value->integer;
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  constexpr const numeral_system *get_num_sys() const {
+    return ((get_node_type() == node_type::Integer) ? (m_value->num_sys)
+                                                    : (nullptr));
+  }
+
+  constexpr std::optional<double> get_float() const {
+    if (get_node_type() == node_type::Float) {
+      return m_value->floating;
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  constexpr std::optional<std::string_view> get_string() const {
+    if (get_node_type() == node_type::String) {
+      return std::string_view{m_chars + m_value->offset, m_value->length};
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  template <concept_embedded_view_value t_value>
+  constexpr std::optional<t_value> try_get() const {
+    if constexpr (std::same_as<t_value, std::string_view>) {
+      return get_string();
+    } else if constexpr (std::floating_point<t_value>) {
+      if (const std::optional<double> value{get_float()};
+          value.has_value() == true) {
+        return static_cast<t_value>(value.value());
+      }
+    } else {
+      if (const std::optional<std::int64_t> value{get_integer()};
+          (value.has_value() == true) &&
+          (std::in_range<t_value>(value.value()) == true)) {
+        return static_cast<t_value>(value.value());
+      }
+    }
+    return std::nullopt;
+  }
+
+  template <concept_embedded_view_value t_value>
+  constexpr t_value value_or(t_value default_value) const {
+    return try_get<t_value>().value_or(std::move(default_value));
+  }
+
+  constexpr embedded_view find(const std::string_view key) const {
+    if (get_node_type() != node_type::Map) {
+      return embedded_view{nullptr};
+    }
+
+    std::size_t first{0};
+    std::size_t last{m_value->length};
+    while (first < last) {
+      const std::size_t middle{first + ((last - first) / 2)};
+      const int compared{key_at(middle).compare(key)};
+      if (compared < 0) {
+        first = middle + 1;
+      } else if (compared > 0) {
+        last = middle;
+      } else {
+        return find(middle);
+      }
+    }
+    return embedded_view{nullptr};
+  }
+
+  // For a map, returns the value of the member whose key is key_at(pos).
+  constexpr embedded_view find(const std::size_t pos) const {
+    const node_type type{get_node_type()};
+    if (((type != node_type::Array) && (type != node_type::Map)) ||
+        (pos >= m_value->length)) {
+      return embedded_view{nullptr};
+    }
+    return embedded_view{m_values, m_chars,
+                         m_values + m_value->offset + pos};
+  }
+
+  constexpr bool contains(const std::string_view key) const {
+    return static_cast<bool>(find(key));
+  }
+
+  constexpr std::size_t size() const {
+    switch (get_node_type()) {
+    case node_type::Array:
+    case node_type::Map: {
+      return m_value->length;
+    } break;
+    default: {
+      return 0;
+    } break;
+    }
+  }
+
+  // The key of the member at `pos` of a map, in sorted order.
+  constexpr std::string_view key_at(const std::size_t pos) const {
+    if ((get_node_type() != node_type::Map) || (pos >= m_value->length)) {
+      throw std::out_of_range{"embedded_view::key_at"};
+    }
+    const impl::embedded_value &member{m_values[m_value->offset + pos]};
+    return std::string_view{m_chars + member.key_offset, member.key_length};
+  }
+
+  // Copies the value into a node tree. A map becomes the root map of the
+  // tree, as if it had been parsed.
+  node_ptr<node> to_node() const;
+
+public:
+  constexpr explicit operator bool() const {
+    return (get_node_type() != node_type::Null);
+  }
+
+  constexpr embedded_view operator[](const std::string_view key) const {
+    return find(key);
+  }
+
+  constexpr embedded_view operator[](const std::size_t pos) const {
+    return find(pos);
+  }
+
+private:
+  node_ptr<node> to_node(const bool is_root) const;
+};
+
+// A configuration parsed at compile time by parse_embedded(), stored in two
+// fixed-size arrays: one record per value, with the members of each container
+// next to each other, and the characters of all strings and keys.
+template <std::size_t t_value_count, std::size_t t_char_count>
+class embedded_config {
+public:
+  std::array<impl::embedded_value, t_value_count> values;
+  std::array<char, t_char_count> chars;
+
+public:
+  constexpr embedded_view root() const {
+    return embedded_view{values.data(), chars.data(), values.data()};
+  }
+};
+
+namespace impl {
+struct embedded_parsed_value {
+  node_type type;
+  const numeral_system *num_sys;
+  std::int64_t integer;
+  double floating;
+  // A string's characters among those of all strings.
+  std::size_t string_offset;
+  std::size_t string_length;
+  std::string_view key;
+  // The members of a container, linked in order of appearance.
+  std::size_t member_count;
+  std::size_t first_member;
+  std::size_t last_member;
+  std::size_t next_sibling;
+};
+
+struct embedded_parse_summary {
+  const error_messages::error_message *error;
+  std::size_t line;
+  std::size_t column;
+  std::size_t value_count;
+  std::size_t char_count;
+};
+
+// The handler with which the event_parser builds the values of an embedded
+// config. The root map is the first value.
+class embedded_tree_builder {
+public:
+  // Constant evaluation limits how deeply functions may recurse.
+  static constexpr std::size_t k_max_nesting_depth{64};
+
+private:
+  std::vector<embedded_parsed_value> m_values;
+  std::string m_strings;
+  // The containers being parsed, innermost last.
+  std::vector<std::size_t> m_open_containers;
+  std::string_view m_key;
+
+public:
+  constexpr embedded_tree_builder()
+      : m_values{}, m_strings{}, m_open_containers{}, m_key{} {}
+
+public:
+  constexpr const std::vector<embedded_parsed_value> &values() const {
+    return m_values;
+  }
+
+  constexpr std::string_view strings() const { return m_strings; }
+
+public:
+  constexpr const error_messages::error_message *
+  begin_map(const std::size_t /*offset*/) {
+    m_open_containers.push_back(add_value(node_type::Map));
+    return nullptr;
+  }
+
+  constexpr const error_messages::error_message *
+  end_map(const std::size_t /*offset*/) {
+    m_open_containers.pop_back();
+    return nullptr;
+  }
+
+  constexpr const error_messages::error_message *
+  begin_array(const std::size_t /*offset*/) {
+    m_open_containers.push_back(add_value(node_type::Array));
+    return nullptr;
+  }
+
+  constexpr const error_messages::error_message *
+  end_array(const std::size_t /*offset*/) {
+    m_open_containers.pop_back();
+    return nullptr;
+  }
+
+  constexpr const error_messages::error_message *
+  key(const std::string_view key, const std::size_t /*offset*/) {
+    m_key = key;
+    return nullptr;
+  }
+
+  constexpr const error_messages::error_message *
+  string_value(const std::string_view value, const std::size_t /*offset*/) {
+    embedded_parsed_value &added{m_values[add_value(node_type::String)]};
+    added.string_length = value.size();
+    m_strings.append(value);
+    return nullptr;
+  }
+
+  constexpr const error_messages::error_message *
+  integer_value(const std::int64_t value, const numeral_system &num_sys,
+                const std::size_t /*offset*/) {
+    embedded_parsed_value &added{m_values[add_value(node_type::Integer)]};
+    added.integer = value;
+    added.num_sys = &num_sys;
+    return nullptr;
+  }
+
+  constexpr const error_messages::error_message *
+  float_value(const double value, const std::size_t /*offset*/) {
+    m_values[add_value(node_type::Float)].floating = value;
+    return nullptr;
+  }
+
+private:
+  constexpr std::size_t add_value(const node_type type) {
+    const std::size_t ret_val{m_values.size()};
+    m_values.push_back(embedded_parsed_value{
+        type, &numeral_system_decimal, 0, 0.0, m_strings.size(), 0, {}, 0,
+        std::string_view::npos, std::string_view::npos,
+        std::string_view::npos});
+
+    if (m_open_containers.empty() == false) {
+      embedded_parsed_value &parent{m_values[m_open_containers.back()]};
+      if (parent.type == node_type::Map) {
+        m_values[ret_val].key = m_key;
+      }
+      if (parent.member_count == 0) {
+        parent.first_member = ret_val;
+      } else {
+        m_values[parent.last_member].next_sibling = ret_val;
+      }
+      parent.last_member = ret_val;
+      ++parent.member_count;
+    }
+    return ret_val;
+  }
+};
+
+consteval embedded_parse_summary
+summarize_embedded(const std::string_view text) {
+  embedded_tree_builder builder{};
+  event_parser<embedded_tree_builder> parser{
+      builder, text, embedded_tree_builder::k_max_nesting_depth};
+  embedded_parse_summary ret_val{nullptr, 0, 0, 0, 0};
+  if (parser.parse() == false) {
+    ret_val.error = parser.error();
+    std::tie(ret_val.line, ret_val.column) = parser.error_position();
+  } else {
+    ret_val.value_count = builder.values().size();
+    ret_val.char_count = builder.strings().size();
+    for (const embedded_parsed_value &value : builder.values()) {
+      ret_val.char_count += value.key.size();
+    }
+  }
+  return ret_val;
+}
+
+template <std::size_t t_value_count, std::size_t t_char_count>
+consteval embedded_config<t_value_count, t_char_count>
+build_embedded(const std::string_view text) {
+  embedded_tree_builder builder{};
+  event_parser<embedded_tree_builder> parser{
+      builder, text, embedded_tree_builder::k_max_nesting_depth};
+  parser.parse();
+  const std::vector<embedded_parsed_value> &parsed{builder.values()};
+
+  embedded_config<t_value_count, t_char_count> ret_val{};
+  // The strings come first, so their offsets stay the same.
+  std::copy(builder.strings().begin(), builder.strings().end(),
+            ret_val.chars.begin());
+  std::size_t char_count{builder.strings().size()};
+
+  // Breadth-first, so that the members of each container are laid out next
+  // to each other.
+  std::vector<std::pair<std::size_t /*parsed*/, std::size_t /*laid out*/>>
+      queue{{0, 0}};
+  std::size_t value_count{1};
+  for (std::size_t i{0}; i < queue.size(); ++i) {
+    const embedded_parsed_value &from{parsed[queue[i].first]};
+    embedded_value &to{ret_val.values[queue[i].second]};
+    to = embedded_value{from.type,          from.num_sys,
+                        from.integer,       from.floating,
+                        from.string_offset, from.string_length,
+                        char_count,         from.key.size()};
+    std::copy(from.key.begin(), from.key.end(),
+              ret_val.chars.begin() + char_count);
+    char_count += from.key.size();
+
+    if ((from.type == node_type::Array) || (from.type == node_type::Map)) {
+      std::vector<std::size_t> members{};
+      members.reserve(from.member_count);
+      for (std::size_t member{from.first_member};
+           member != std::string_view::npos;
+           member = parsed[member].next_sibling) {
+        members.push_back(member);
+      }
+      if (from.type == node_type::Map) {
+        std::sort(members.begin(), members.end(),
+                  [&parsed](const std::size_t x, const std::size_t y) {
+                    return (parsed[x].key < parsed[y].key);
+                  });
+      }
+      to.offset = value_count;
+      to.length = members.size();
+      for (const std::size_t member : members) {
+        queue.emplace_back(member, value_count++);
+      }
+    }
+  }
+  return ret_val;
+}
+
+// Instantiated only to report a syntax error in an embedded config as a
+// compile error naming the message, line and column.
+template <embedded_text t_message, std::size_t t_line, std::size_t t_column>
+consteval void embedded_syntax_error() {
+  static_assert(t_line == 0, "embedded configuration has a syntax error; its "
+                             "message, line and column are the template "
+                             "arguments of embedded_syntax_error()");
+}
+} // namespace impl
+
+// Parses a configuration at compile time. A syntax error is a compile error.
+// The result should be stored in a static constexpr variable, e.g.
+//   static constexpr auto k_defaults{parse_embedded<R"(port = 80;)">()};
+// so that it's placed in read-only data and lookups on it can be folded:
+//   static_assert(k_defaults.root()["port"].value_or(0) == 80);
+template <embedded_text t_text> consteval auto parse_embedded() {
+  constexpr impl::embedded_parse_summary k_summary{
+      impl::summarize_embedded(t_text.view())};
+  if constexpr (k_summary.error != nullptr) {
+    constexpr std::string_view k_message{k_summary.error->message};
+    impl::embedded_syntax_error<embedded_text<k_message.size() + 1>{k_message},
+                                k_summary.line, k_summary.column>();
+    return embedded_config<1, 0>{};
+  } else {
+    return impl::build_embedded<k_summary.value_count, k_summary.char_count>(
+        t_text.view());
+  }
+}
+} // namespace libconfigfile
+
+#endif
@@ -1,18 +1,17 @@
 #ifndef LIBCONFIGFILE_ERROR_MESSAGES_HPP
 #define LIBCONFIGFILE_ERROR_MESSAGES_HPP
 
-#include <string>
+#include <algorithm>
+#include <array>
+#include <string_view>
 
 namespace libconfigfile {
 namespace error_messages {
-struct error_message {
-  std::string category;
-  std::string message;
-};
-
 /*   digit 1:
  *   1 syntax
  *   2 semantic
+ *   3 limit
+ *   4 input
  *
  *   digit 2:
  *   1 comment
@@ -25,81 +24,326 @@ struct error_message {
  *   8 directive
  *   9 misc
  *
+ *   digit 2 (semantic):
+ *   1 type
+ *   2 range
+ *   3 key
+ *
+ *   digit 2 (limit):
+ *   1 input size
+ *   2 node count
+ *   3 nesting depth
+ *   4 include
+ *   5 string length
+ *   6 time
+ *
+ *   digit 2 (input):
+ *   1 open
+ *
  *   digit 3:
- *   individual */
+ *   individual
+ *
+ *   error_code values are digit 1 followed by digits 2 and 3 as two-digit
+ *   decimal fields (e.g. err_1_5_13 == 10513), so they sort in the same
+ *   order as the err_msg_x_y_z constants below. */
+
+// clang-format off
+enum class error_code : unsigned int {
+  err_1_1_1 = 10101,
+
+  err_1_2_1 = 10201,
+  err_1_2_2 = 10202,
+  err_1_2_3 = 10203,
+  err_1_2_4 = 10204,
+  err_1_2_5 = 10205,
+  err_1_2_6 = 10206,
+  err_1_2_7 = 10207,
+
+  err_1_3_1 = 10301,
+  err_1_3_2 = 10302,
+  err_1_3_3 = 10303,
+
+  err_1_4_1 = 10401,
+  err_1_4_2 = 10402,
+  err_1_4_3 = 10403,
+  err_1_4_4 = 10404,
+  err_1_4_5 = 10405,
+  err_1_4_6 = 10406,
+  err_1_4_7 = 10407,
+  err_1_4_8 = 10408,
+  err_1_4_9 = 10409,
+
+  err_1_5_1 = 10501,
+  err_1_5_2 = 10502,
+  err_1_5_3 = 10503,
+  err_1_5_4 = 10504,
+  err_1_5_5 = 10505,
+  err_1_5_6 = 10506,
+  err_1_5_7 = 10507,
+  err_1_5_8 = 10508,
+  err_1_5_9 = 10509,
+  err_1_5_10 = 10510,
+  err_1_5_11 = 10511,
+  err_1_5_12 = 10512,
+  err_1_5_13 = 10513,
+
+  err_1_6_1 = 10601,
+  err_1_6_2 = 10602,
+  err_1_6_3 = 10603,
+
+  err_1_7_1 = 10701,
+  err_1_7_2 = 10702,
+  err_1_7_3 = 10703,
+
+  err_1_8_1 = 10801,
+  err_1_8_2 = 10802,
+  err_1_8_3 = 10803,
+  err_1_8_4 = 10804,
+  err_1_8_5 = 10805,
+  err_1_8_6 = 10806,
+  err_1_8_7 = 10807,
+  err_1_8_8 = 10808,
+  err_1_8_9 = 10809,
+  err_1_8_10 = 10810,
+  err_1_8_11 = 10811,
+  err_1_8_12 = 10812,
+  err_1_8_13 = 10813,
+  err_1_8_14 = 10814,
+  err_1_8_15 = 10815,
+  err_1_8_16 = 10816,
+  err_1_8_17 = 10817,
+
+  err_1_9_1 = 10901,
+  err_1_9_2 = 10902,
+  err_1_9_3 = 10903,
+  err_1_9_4 = 10904,
+  err_1_9_5 = 10905,
+
+  err_2_1_1 = 20101,
+
+  err_2_2_1 = 20201,
+  err_2_2_2 = 20202,
+
+  err_2_3_1 = 20301,
+  err_2_3_2 = 20302,
+
+  err_3_1_1 = 30101,
+
+  err_3_2_1 = 30201,
+
+  err_3_3_1 = 30301,
+
+  err_3_4_1 = 30401,
+  err_3_4_2 = 30402,
+
+  err_3_5_1 = 30501,
+
+  err_3_6_1 = 30601,
+
+  err_4_1_1 = 40101,
+  err_4_1_2 = 40102,
+};
+// clang-format on
+
+struct error_message {
+  error_code code;
+  std::string_view category;
+  std::string_view message;
+};
 
 // clang-format off
-  static const error_message err_msg_1_1_1 {"/error/syntax/comment", "C-style comment is unterminated"};
-
-  static const error_message err_msg_1_2_1 {"/error/syntax/key-value", "key-value key contains invalid character(s)"};
-  static const error_message err_msg_1_2_2 {"/error/syntax/key-value", "key-value key is split by comment(s)"};
-  static const error_message err_msg_1_2_3 {"/error/syntax/key-value", "key-value key is split by newline(s)"};
-  static const error_message err_msg_1_2_4 {"/error/syntax/key-value", "key is missing"};
-  static const error_message err_msg_1_2_5 {"/error/syntax/key-value", "value is missing"};
-  static const error_message err_msg_1_2_6 {"/error/syntax/key-value", "value is unterminated"};
-  static const error_message err_msg_1_2_7 {"/error/syntax/key-value", "key-value is missing"};
-
-  static const error_message err_msg_1_3_1 {"/error/syntax/string", "non-whitespace character appears outside of string"};
-  static const error_message err_msg_1_3_2 {"/error/syntax/string", "string is split by newline(s)"};
-  static const error_message err_msg_1_3_3 {"/error/syntax/string", "string is unterminated"};
-
-  static const error_message err_msg_1_4_1 {"/error/syntax/integer", "integer contains invalid character(s)"};
-  static const error_message err_msg_1_4_2 {"/error/syntax/integer", "integer digit separator is not surrounded by at least one digit on either side"};
-  static const error_message err_msg_1_4_3 {"/error/syntax/integer", "integer is split by comment(s)"};
-  static const error_message err_msg_1_4_4 {"/error/syntax/integer", "integer is split by newline(s)"};
-  static const error_message err_msg_1_4_5 {"/error/syntax/integer", "integer value is too large"};
-  static const error_message err_msg_1_4_6 {"/error/syntax/integer", "negative sign does not appear at start of integer"};
-  static const error_message err_msg_1_4_7 {"/error/syntax/integer", "numeral system prefix does not appear before integer digits"};
-  static const error_message err_msg_1_4_8 {"/error/syntax/integer", "positive sign does not appear at start of integer"};
-  static const error_message err_msg_1_4_9 {"/error/syntax/integer", "extraneous character(s) appear(s) after integer"};
-
-  static const error_message err_msg_1_5_1 {"/error/syntax/float", "float contains invalid character(s)"};
-  static const error_message err_msg_1_5_2 {"/error/syntax/float", "float contains more than one decimal point"};
-  static const error_message err_msg_1_5_3 {"/error/syntax/float", "float contains more than one exponent sign"};
-  static const error_message err_msg_1_5_4 {"/error/syntax/float", "float decimal point appears after exponent sign"};
-  static const error_message err_msg_1_5_5 {"/error/syntax/float", "float decimal point is not surrounded by at least one digit on either side"};
-  static const error_message err_msg_1_5_6 {"/error/syntax/float", "float digit separator is not surrounded by at least one digit on either side"};
-  static const error_message err_msg_1_5_7 {"/error/syntax/float", "float exponent sign is not surrounded by at least one digit on either side"};
-  static const error_message err_msg_1_5_8 {"/error/syntax/float", "float is split by comment(s)"};
-  static const error_message err_msg_1_5_9 {"/error/syntax/float", "float is split by newline(s)"};
-  static const error_message err_msg_1_5_10 {"/error/syntax/float", "float value in too large"};
-  static const error_message err_msg_1_5_11 {"/error/syntax/float", "negative sign does not appear at start of integer or exponent part of float"};
-  static const error_message err_msg_1_5_12 {"/error/syntax/float", "positive sign does not appear at start of integer or exponent part of float"};
-  static const error_message err_msg_1_5_13 {"/error/syntax/float", "extraneous character(s) appear(s) after float"};
-
-  static const error_message err_msg_1_6_1 {"/error/syntax/array", "array opening delimiter is missing"};
-  static const error_message err_msg_1_6_2 {"/error/syntax/array", "array closing delimiter is missing"};
-  static const error_message err_msg_1_6_3 {"/error/syntax/array", "extraneous character(s) appear(s) after array"};
-
-  static const error_message err_msg_1_7_1 {"/error/syntax/map", "map opening delimiter is missing"};
-  static const error_message err_msg_1_7_2 {"/error/syntax/map", "map closing delimiter is missing"};
-  static const error_message err_msg_1_7_3 {"/error/syntax/map", "extraneous character(s) appear(s) after map"};
-
-  static const error_message err_msg_1_8_1 {"/error/syntax/directive", "directive is invalid"};
-  static const error_message err_msg_1_8_2 {"/error/syntax/directive", "directive is split by newline(s)"};
-  static const error_message err_msg_1_8_3 {"/error/syntax/directive", "directive name is missing"};
-  static const error_message err_msg_1_8_4 {"/error/syntax/directive", "directive name is split by comment(s)"};
-  static const error_message err_msg_1_8_5 {"/error/syntax/directive", "escape sequence in include directive file path argument is invalid"};
-  static const error_message err_msg_1_8_6 {"/error/syntax/directive", "include directive file path argument is empty"};
-  static const error_message err_msg_1_8_7 {"/error/syntax/directive", "include directive file path argument is missing"};
-  static const error_message err_msg_1_8_8 {"/error/syntax/directive", "include directive file path argument is unterminated"};
-  static const error_message err_msg_1_8_9 {"/error/syntax/directive", "include directive given excess arguments"};
-  static const error_message err_msg_1_8_10 {"/error/syntax/directive", "parser and configuration file version are incompatible"};
-  static const error_message err_msg_1_8_11 {"/error/syntax/directive", "version directive given excess arguments"};
-  static const error_message err_msg_1_8_12 {"/error/syntax/directive", "version directive version argument is empty"};
-  static const error_message err_msg_1_8_13 {"/error/syntax/directive", "version directive version argument is missing"};
-  static const error_message err_msg_1_8_14 {"/error/syntax/directive", "version directive version argument is unterminated"};
-  static const error_message err_msg_1_8_15 {"/error/syntax/directive", "directive does not appear directly in root map"};
-  static const error_message err_msg_1_8_16 {"/error/syntax/directive", "directive does not appear on a line by itself"};
-
-  static const error_message err_msg_1_9_1 {"/error/syntax/misc", "escape sequence is incomplete"};
-  static const error_message err_msg_1_9_2 {"/error/syntax/misc", "escape sequence is invalid"};
-  static const error_message err_msg_1_9_3 {"/error/syntax/misc", "escape sequence leader is missing"};
-  static const error_message err_msg_1_9_4 {"/error/syntax/misc", "hexadecimal escape sequence contains invalid digit"};
-  static const error_message err_msg_1_9_5 {"/error/syntax/misc", "duplicate name in scope"};
+  inline constexpr error_message err_msg_1_1_1 {error_code::err_1_1_1, "/error/syntax/comment", "C-style comment is unterminated"};
+
+  inline constexpr error_message err_msg_1_2_1 {error_code::err_1_2_1, "/error/syntax/key-value", "key-value key contains invalid character(s)"};
+  inline constexpr error_message err_msg_1_2_2 {error_code::err_1_2_2, "/error/syntax/key-value", "key-value key is split by comment(s)"};
+  inline constexpr error_message err_msg_1_2_3 {error_code::err_1_2_3, "/error/syntax/key-value", "key-value key is split by newline(s)"};
+  inline constexpr error_message err_msg_1_2_4 {error_code::err_1_2_4, "/error/syntax/key-value", "key is missing"};
+  inline constexpr error_message err_msg_1_2_5 {error_code::err_1_2_5, "/error/syntax/key-value", "value is missing"};
+  inline constexpr error_message err_msg_1_2_6 {error_code::err_1_2_6, "/error/syntax/key-value", "value is unterminated"};
+  inline constexpr error_message err_msg_1_2_7 {error_code::err_1_2_7, "/error/syntax/key-value", "key-value is missing"};
+
+  inline constexpr error_message err_msg_1_3_1 {error_code::err_1_3_1, "/error/syntax/string", "non-whitespace character appears outside of string"};
+  inline constexpr error_message err_msg_1_3_2 {error_code::err_1_3_2, "/error/syntax/string", "string is split by newline(s)"};
+  inline constexpr error_message err_msg_1_3_3 {error_code::err_1_3_3, "/error/syntax/string", "string is unterminated"};
+
+  inline constexpr error_message err_msg_1_4_1 {error_code::err_1_4_1, "/error/syntax/integer", "integer contains invalid character(s)"};
+  inline constexpr error_message err_msg_1_4_2 {error_code::err_1_4_2, "/error/syntax/integer", "integer digit separator is not surrounded by at least one digit on either side"};
+  inline constexpr error_message err_msg_1_4_3 {error_code::err_1_4_3, "/error/syntax/integer", "integer is split by comment(s)"};
+  inline constexpr error_message err_msg_1_4_4 {error_code::err_1_4_4, "/error/syntax/integer", "integer is split by newline(s)"};
+  inline constexpr error_message err_msg_1_4_5 {error_code::err_1_4_5, "/error/syntax/integer", "integer value is too large"};
+  inline constexpr error_message err_msg_1_4_6 {error_code::err_1_4_6, "/error/syntax/integer", "negative sign does not appear at start of integer"};
+  inline constexpr error_message err_msg_1_4_7 {error_code::err_1_4_7, "/error/syntax/integer", "numeral system prefix does not appear before integer digits"};
+  inline constexpr error_message err_msg_1_4_8 {error_code::err_1_4_8, "/error/syntax/integer", "positive sign does not appear at start of integer"};
+  inline constexpr error_message err_msg_1_4_9 {error_code::err_1_4_9, "/error/syntax/integer", "extraneous character(s) appear(s) after integer"};
+
+  inline constexpr error_message err_msg_1_5_1 {error_code::err_1_5_1, "/error/syntax/float", "float contains invalid character(s)"};
+  inline constexpr error_message err_msg_1_5_2 {error_code::err_1_5_2, "/error/syntax/float", "float contains more than one decimal point"};
+  inline constexpr error_message err_msg_1_5_3 {error_code::err_1_5_3, "/error/syntax/float", "float contains more than one exponent sign"};
+  inline constexpr error_message err_msg_1_5_4 {error_code::err_1_5_4, "/error/syntax/float", "float decimal point appears after exponent sign"};
+  inline constexpr error_message err_msg_1_5_5 {error_code::err_1_5_5, "/error/syntax/float", "float decimal point is not surrounded by at least one digit on either side"};
+  inline constexpr error_message err_msg_1_5_6 {error_code::err_1_5_6, "/error/syntax/float", "float digit separator is not surrounded by at least one digit on either side"};
+  inline constexpr error_message err_msg_1_5_7 {error_code::err_1_5_7, "/error/syntax/float", "float exponent sign is not surrounded by at least one digit on either side"};
+  inline constexpr error_message err_msg_1_5_8 {error_code::err_1_5_8, "/error/syntax/float", "float is split by comment(s)"};
+  inline constexpr error_message err_msg_1_5_9 {error_code::err_1_5_9, "/error/syntax/float", "float is split by newline(s)"};
+  inline constexpr error_message err_msg_1_5_10 {error_code::err_1_5_10, "/error/syntax/float", "float value in too large"};
+  inline constexpr error_message err_msg_1_5_11 {error_code::err_1_5_11, "/error/syntax/float", "negative sign does not appear at start of integer or exponent part of float"};
+  inline constexpr error_message err_msg_1_5_12 {error_code::err_1_5_12, "/error/syntax/float", "positive sign does not appear at start of integer or exponent part of float"};
+  inline constexpr error_message err_msg_1_5_13 {error_code::err_1_5_13, "/error/syntax/float", "extraneous character(s) appear(s) after float"};
+
+  inline constexpr error_message err_msg_1_6_1 {error_code::err_1_6_1, "/error/syntax/array", "array opening delimiter is missing"};
+  inline constexpr error_message err_msg_1_6_2 {error_code::err_1_6_2, "/error/syntax/array", "array closing delimiter is missing"};
+  inline constexpr error_message err_msg_1_6_3 {error_code::err_1_6_3, "/error/syntax/array", "extraneous character(s) appear(s) after array"};
+
+  inline constexpr error_message err_msg_1_7_1 {error_code::err_1_7_1, "/error/syntax/map", "map opening delimiter is missing"};
+  inline constexpr error_message err_msg_1_7_2 {error_code::err_1_7_2, "/error/syntax/map", "map closing delimiter is missing"};
+  inline constexpr error_message err_msg_1_7_3 {error_code::err_1_7_3, "/error/syntax/map", "extraneous character(s) appear(s) after map"};
+
+  inline constexpr error_message err_msg_1_8_1 {error_code::err_1_8_1, "/error/syntax/directive", "directive is invalid"};
+  inline constexpr error_message err_msg_1_8_2 {error_code::err_1_8_2, "/error/syntax/directive", "directive is split by newline(s)"};
+  inline constexpr error_message err_msg_1_8_3 {error_code::err_1_8_3, "/error/syntax/directive", "directive name is missing"};
+  inline constexpr error_message err_msg_1_8_4 {error_code::err_1_8_4, "/error/syntax/directive", "directive name is split by comment(s)"};
+  inline constexpr error_message err_msg_1_8_5 {error_code::err_1_8_5, "/error/syntax/directive", "escape sequence in include directive file path argument is invalid"};
+  inline constexpr error_message err_msg_1_8_6 {error_code::err_1_8_6, "/error/syntax/directive", "include directive file path argument is empty"};
+  inline constexpr error_message err_msg_1_8_7 {error_code::err_1_8_7, "/error/syntax/directive", "include directive file path argument is missing"};
+  inline constexpr error_message err_msg_1_8_8 {error_code::err_1_8_8, "/error/syntax/directive", "include directive file path argument is unterminated"};
+  inline constexpr error_message err_msg_1_8_9 {error_code::err_1_8_9, "/error/syntax/directive", "include directive given excess arguments"};
+  inline constexpr error_message err_msg_1_8_10 {error_code::err_1_8_10, "/error/syntax/directive", "parser and configuration file version are incompatible"};
+  inline constexpr error_message err_msg_1_8_11 {error_code::err_1_8_11, "/error/syntax/directive", "version directive given excess arguments"};
+  inline constexpr error_message err_msg_1_8_12 {error_code::err_1_8_12, "/error/syntax/directive", "version directive version argument is empty"};
+  inline constexpr error_message err_msg_1_8_13 {error_code::err_1_8_13, "/error/syntax/directive", "version directive version argument is missing"};
+  inline constexpr error_message err_msg_1_8_14 {error_code::err_1_8_14, "/error/syntax/directive", "version directive version argument is unterminated"};
+  inline constexpr error_message err_msg_1_8_15 {error_code::err_1_8_15, "/error/syntax/directive", "directive does not appear directly in root map"};
+  inline constexpr error_message err_msg_1_8_16 {error_code::err_1_8_16, "/error/syntax/directive", "directive does not appear on a line by itself"};
+  inline constexpr error_message err_msg_1_8_17 {error_code::err_1_8_17, "/error/syntax/directive", "include directive is not supported in this context"};
+
+  inline constexpr error_message err_msg_1_9_1 {error_code::err_1_9_1, "/error/syntax/misc", "escape sequence is incomplete"};
+  inline constexpr error_message err_msg_1_9_2 {error_code::err_1_9_2, "/error/syntax/misc", "escape sequence is invalid"};
+  inline constexpr error_message err_msg_1_9_3 {error_code::err_1_9_3, "/error/syntax/misc", "escape sequence leader is missing"};
+  inline constexpr error_message err_msg_1_9_4 {error_code::err_1_9_4, "/error/syntax/misc", "hexadecimal escape sequence contains invalid digit"};
+  inline constexpr error_message err_msg_1_9_5 {error_code::err_1_9_5, "/error/syntax/misc", "duplicate name in scope"};
+
+  inline constexpr error_message err_msg_2_1_1 {error_code::err_2_1_1, "/error/semantic/type", "value does not have the type of its field"};
+
+  inline constexpr error_message err_msg_2_2_1 {error_code::err_2_2_1, "/error/semantic/range", "integer value is out of range of its field"};
+  inline constexpr error_message err_msg_2_2_2 {error_code::err_2_2_2, "/error/semantic/range", "float value is out of range of its field"};
+
+  inline constexpr error_message err_msg_2_3_1 {error_code::err_2_3_1, "/error/semantic/key", "required key is missing"};
+  inline constexpr error_message err_msg_2_3_2 {error_code::err_2_3_2, "/error/semantic/key", "forbidden key is present"};
+
+  inline constexpr error_message err_msg_3_1_1 {error_code::err_3_1_1, "/error/limit/input", "input size limit exceeded"};
+
+  inline constexpr error_message err_msg_3_2_1 {error_code::err_3_2_1, "/error/limit/node", "node count limit exceeded"};
+
+  inline constexpr error_message err_msg_3_3_1 {error_code::err_3_3_1, "/error/limit/nesting", "nesting depth limit exceeded"};
+
+  inline constexpr error_message err_msg_3_4_1 {error_code::err_3_4_1, "/error/limit/include", "include count limit exceeded"};
+  inline constexpr error_message err_msg_3_4_2 {error_code::err_3_4_2, "/error/limit/include", "include depth limit exceeded"};
+
+  inline constexpr error_message err_msg_3_5_1 {error_code::err_3_5_1, "/error/limit/string", "string length limit exceeded"};
+
+  inline constexpr error_message err_msg_3_6_1 {error_code::err_3_6_1, "/error/limit/time", "parse deadline exceeded"};
+
+  inline constexpr error_message err_msg_4_1_1 {error_code::err_4_1_1, "/error/input/open", "file could not be opened for reading"};
+  inline constexpr error_message err_msg_4_1_2 {error_code::err_4_1_2, "/error/input/open", "input stream could not be opened for reading"};
+
+  inline constexpr std::array k_error_message_table {
+    &err_msg_1_1_1,
+    &err_msg_1_2_1,
+    &err_msg_1_2_2,
+    &err_msg_1_2_3,
+    &err_msg_1_2_4,
+    &err_msg_1_2_5,
+    &err_msg_1_2_6,
+    &err_msg_1_2_7,
+    &err_msg_1_3_1,
+    &err_msg_1_3_2,
+    &err_msg_1_3_3,
+    &err_msg_1_4_1,
+    &err_msg_1_4_2,
+    &err_msg_1_4_3,
+    &err_msg_1_4_4,
+    &err_msg_1_4_5,
+    &err_msg_1_4_6,
+    &err_msg_1_4_7,
+    &err_msg_1_4_8,
+    &err_msg_1_4_9,
+    &err_msg_1_5_1,
+    &err_msg_1_5_2,
+    &err_msg_1_5_3,
+    &err_msg_1_5_4,
+    &err_msg_1_5_5,
+    &err_msg_1_5_6,
+    &err_msg_1_5_7,
+    &err_msg_1_5_8,
+    &err_msg_1_5_9,
+    &err_msg_1_5_10,
+    &err_msg_1_5_11,
+    &err_msg_1_5_12,
+    &err_msg_1_5_13,
+    &err_msg_1_6_1,
+    &err_msg_1_6_2,
+    &err_msg_1_6_3,
+    &err_msg_1_7_1,
+    &err_msg_1_7_2,
+    &err_msg_1_7_3,
+    &err_msg_1_8_1,
+    &err_msg_1_8_2,
+    &err_msg_1_8_3,
+    &err_msg_1_8_4,
+    &err_msg_1_8_5,
+    &err_msg_1_8_6,
+    &err_msg_1_8_7,
+    &err_msg_1_8_8,
+    &err_msg_1_8_9,
+    &err_msg_1_8_10,
+    &err_msg_1_8_11,
+    &err_msg_1_8_12,
+    &err_msg_1_8_13,
+    &err_msg_1_8_14,
+    &err_msg_1_8_15,
+    &err_msg_1_8_16,
+    &err_msg_1_8_17,
+    &err_msg_1_9_1,
+    &err_msg_1_9_2,
+    &err_msg_1_9_3,
+    &err_msg_1_9_4,
+    &err_msg_1_9_5,
+    &err_msg_2_1_1,
+    &err_msg_2_2_1,
+    &err_msg_2_2_2,
+    &err_msg_2_3_1,
+    &err_msg_2_3_2,
+    &err_msg_3_1_1,
+    &err_msg_3_2_1,
+    &err_msg_3_3_1,
+    &err_msg_3_4_1,
+    &err_msg_3_4_2,
+    &err_msg_3_5_1,
+    &err_msg_3_6_1,
+    &err_msg_4_1_1,
+    &err_msg_4_1_2,
+  };
 // clang-format on
 
+static_assert(std::is_sorted(k_error_message_table.begin(),
+                             k_error_message_table.end(),
+                             [](const error_message *const x,
+                                const error_message *const y) {
+                               return x->code < y->code;
+                             }));
+
+constexpr const error_message *find_error_message(const error_code code) {
+  const auto *const pos{std::lower_bound(
+      k_error_message_table.begin(), k_error_message_table.end(), code,
+      [](const error_message *const entry, const error_code value) {
+        return entry->code < value;
+      })};
+  return (((pos != k_error_message_table.end()) && ((*pos)->code == code))
+              ? (*pos)
+              : (nullptr));
+}
 } // namespace error_messages
+using error_messages::error_code;
 } // namespace libconfigfile
 
 #endif
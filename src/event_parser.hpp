@@ -0,0 +1,1078 @@
+#ifndef LIBCONFIGFILE_EVENT_PARSER_HPP
+#define LIBCONFIGFILE_EVENT_PARSER_HPP
+
+#include "character_constants.hpp"
+#include "error_messages.hpp"
+#include "node_types.hpp"
+#include "numeral_system.hpp"
+#include "parse_error.hpp"
+#include "version.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace libconfigfile {
+namespace impl {
+// Only as much arithmetic on unbounded unsigned integers as converting a
+// decimal float to the nearest double needs.
+class decimal_big_integer {
+private:
+  // Least significant first, with no leading zeros.
+  std::vector<std::uint32_t> m_limbs;
+
+public:
+  constexpr decimal_big_integer() : m_limbs{} {}
+
+  constexpr explicit decimal_big_integer(const std::uint64_t value)
+      : m_limbs{} {
+    add(value);
+  }
+
+public:
+  constexpr bool is_zero() const { return m_limbs.empty(); }
+
+  constexpr std::size_t limb_count() const { return m_limbs.size(); }
+
+  constexpr std::uint32_t limb(const std::size_t pos) const {
+    return ((pos < m_limbs.size()) ? (m_limbs[pos]) : (0));
+  }
+
+  constexpr std::size_t bit_width() const {
+    return ((m_limbs.empty() == true)
+                ? (0)
+                : (((m_limbs.size() - 1) * 32) +
+                   std::bit_width(m_limbs.back())));
+  }
+
+  constexpr void add(std::uint64_t value) {
+    for (std::size_t i{0}; value != 0; ++i) {
+      if (i == m_limbs.size()) {
+        m_limbs.push_back(0);
+      }
+      value += m_limbs[i];
+      m_limbs[i] = static_cast<std::uint32_t>(value);
+      value >>= 32;
+    }
+  }
+
+  constexpr void multiply(const std::uint32_t value) {
+    std::uint64_t carry{0};
+    for (std::uint32_t &limb : m_limbs) {
+      carry += (std::uint64_t{limb} * value);
+      limb = static_cast<std::uint32_t>(carry);
+      carry >>= 32;
+    }
+    if (carry != 0) {
+      m_limbs.push_back(static_cast<std::uint32_t>(carry));
+    }
+    trim();
+  }
+
+  constexpr void multiply_by_power_of_10(std::size_t exponent) {
+    for (; exponent >= 9; exponent -= 9) {
+      multiply(1000000000);
+    }
+    for (; exponent > 0; --exponent) {
+      multiply(10);
+    }
+  }
+
+  constexpr void shift_left(const std::size_t bits) {
+    if ((is_zero() == true) || (bits == 0)) {
+      return;
+    }
+    const std::size_t limb_shift{bits / 32};
+    const std::size_t bit_shift{bits % 32};
+    m_limbs.insert(m_limbs.begin(), limb_shift, 0);
+    if (bit_shift != 0) {
+      std::uint32_t carry{0};
+      for (std::size_t i{limb_shift}; i < m_limbs.size(); ++i) {
+        const std::uint32_t limb{m_limbs[i]};
+        m_limbs[i] = ((limb << bit_shift) | carry);
+        carry = (limb >> (32 - bit_shift));
+      }
+      if (carry != 0) {
+        m_limbs.push_back(carry);
+      }
+    }
+  }
+
+  // Requires *this >= other.
+  constexpr void subtract(const decimal_big_integer &other) {
+    std::int64_t borrow{0};
+    for (std::size_t i{0}; i < m_limbs.size(); ++i) {
+      std::int64_t difference{std::int64_t{m_limbs[i]} - borrow -
+                              ((i < other.m_limbs.size())
+                                   ? (std::int64_t{other.m_limbs[i]})
+                                   : (0))};
+      borrow = ((difference < 0) ? (1) : (0));
+      m_limbs[i] = static_cast<std::uint32_t>(difference + (borrow << 32));
+    }
+    trim();
+  }
+
+  constexpr int compare(const decimal_big_integer &other) const {
+    if (m_limbs.size() != other.m_limbs.size()) {
+      return ((m_limbs.size() < other.m_limbs.size()) ? (-1) : (1));
+    }
+    for (std::size_t i{m_limbs.size()}; i > 0; --i) {
+      if (m_limbs[i - 1] != other.m_limbs[i - 1]) {
+        return ((m_limbs[i - 1] < other.m_limbs[i - 1]) ? (-1) : (1));
+      }
+    }
+    return 0;
+  }
+
+private:
+  constexpr void trim() {
+    while ((m_limbs.empty() == false) && (m_limbs.back() == 0)) {
+      m_limbs.pop_back();
+    }
+  }
+};
+
+// Returns the double nearest to `digits` * 10^`exponent` (ties to even), like
+// std::from_chars(), or nothing if it overflows or underflows to zero.
+constexpr std::optional<double>
+decimal_to_double(const std::string_view digits,
+                           const std::int64_t exponent,
+                           const bool is_negative) {
+  const std::size_t first_nonzero{digits.find_first_not_of('0')};
+  const double zero{(is_negative == true) ? (-0.0) : (0.0)};
+  if (first_nonzero == std::string_view::npos) {
+    return zero;
+  }
+  const std::string_view significant{digits.substr(first_nonzero)};
+
+  // Both operands are exact, so a single correctly rounded operation suffices.
+  if ((significant.size() <= 15) && (exponent >= -22) && (exponent <= 22)) {
+    std::int64_t integer{0};
+    for (const char digit : significant) {
+      integer = ((integer * 10) + (digit - '0'));
+    }
+    double power{1.0};
+    for (std::int64_t i{0}; i < ((exponent < 0) ? (-exponent) : (exponent));
+         ++i) {
+      power *= 10.0;
+    }
+    const double ret_val{(exponent < 0)
+                             ? (static_cast<double>(integer) / power)
+                             : (static_cast<double>(integer) * power)};
+    return ((is_negative == true) ? (-ret_val) : (ret_val));
+  }
+
+  // Far enough outside of the range of doubles to not need exact arithmetic.
+  const std::int64_t magnitude{static_cast<std::int64_t>(significant.size()) +
+                               exponent};
+  if (magnitude > 310) {
+    return std::nullopt;
+  } else if (magnitude < -330) {
+    return std::nullopt;
+  }
+
+  decimal_big_integer numerator{};
+  for (const char digit : significant) {
+    numerator.multiply(10);
+    numerator.add(static_cast<std::uint64_t>(digit - '0'));
+  }
+  decimal_big_integer denominator{1};
+  if (exponent >= 0) {
+    numerator.multiply_by_power_of_10(static_cast<std::size_t>(exponent));
+  } else {
+    denominator.multiply_by_power_of_10(static_cast<std::size_t>(-exponent));
+  }
+
+  // Scale so that the quotient has exactly 64 bits: 2^63 <= q < 2^64, with
+  // the value being q * 2^-shift.
+  std::int64_t shift{63 - (static_cast<std::int64_t>(numerator.bit_width()) -
+                           static_cast<std::int64_t>(denominator.bit_width()))};
+  if (shift > 0) {
+    numerator.shift_left(static_cast<std::size_t>(shift));
+  } else {
+    denominator.shift_left(static_cast<std::size_t>(-shift));
+  }
+  decimal_big_integer top_bit{denominator};
+  top_bit.shift_left(63);
+  if (numerator.compare(top_bit) < 0) {
+    numerator.shift_left(1);
+    ++shift;
+  }
+
+  // Schoolbook division yielding the two 32-bit digits of the quotient. With
+  // the denominator's top bit set, each estimated digit is at most 2 too big.
+  const std::size_t normalization{
+      (32 - (denominator.bit_width() % 32)) % 32};
+  numerator.shift_left(normalization);
+  denominator.shift_left(normalization);
+  const std::size_t denominator_size{denominator.limb_count()};
+  std::uint64_t quotient{0};
+  for (std::size_t digit_pos{2}; digit_pos > 0; --digit_pos) {
+    const std::size_t top{(digit_pos - 1) + denominator_size};
+    std::uint64_t digit{
+        std::min(((std::uint64_t{numerator.limb(top)} << 32) |
+                  numerator.limb(top - 1)) /
+                     denominator.limb(denominator_size - 1),
+                 std::uint64_t{std::numeric_limits<std::uint32_t>::max()})};
+    decimal_big_integer divisor{denominator};
+    divisor.shift_left(32 * (digit_pos - 1));
+    decimal_big_integer product{divisor};
+    product.multiply(static_cast<std::uint32_t>(digit));
+    while (product.compare(numerator) > 0) {
+      product.subtract(divisor);
+      --digit;
+    }
+    numerator.subtract(product);
+    quotient = ((quotient << 32) | digit);
+  }
+  const bool is_inexact{numerator.is_zero() == false};
+
+  std::int64_t binary_exponent{63 - shift};
+  std::int64_t dropped_bits{11};
+  if (binary_exponent < -1022) {
+    dropped_bits += (-1022 - binary_exponent);
+  }
+  if (dropped_bits > 64) {
+    return std::nullopt;
+  }
+
+  std::uint64_t mantissa{0};
+  bool round_up{false};
+  if (dropped_bits == 64) {
+    round_up = ((quotient > (std::uint64_t{1} << 63)) ||
+                ((quotient == (std::uint64_t{1} << 63)) && (is_inexact)));
+  } else {
+    const std::uint64_t half{std::uint64_t{1} << (dropped_bits - 1)};
+    const std::uint64_t remainder{quotient &
+                                  ((std::uint64_t{1} << dropped_bits) - 1)};
+    mantissa = (quotient >> dropped_bits);
+    round_up = ((remainder > half) ||
+                ((remainder == half) &&
+                 ((is_inexact == true) || ((mantissa & 1) != 0))));
+  }
+  if (round_up == true) {
+    ++mantissa;
+  }
+
+  std::uint64_t bits{0};
+  if (binary_exponent < -1022) {
+    // Subnormal; a mantissa rounded up to 2^52 correctly becomes the smallest
+    // normal.
+    if (mantissa == 0) {
+      return std::nullopt;
+    }
+    bits = mantissa;
+  } else {
+    if (mantissa == (std::uint64_t{1} << 53)) {
+      mantissa >>= 1;
+      ++binary_exponent;
+    }
+    if (binary_exponent > 1023) {
+      return std::nullopt;
+    }
+    bits = ((static_cast<std::uint64_t>(binary_exponent + 1023) << 52) |
+            (mantissa & ((std::uint64_t{1} << 52) - 1)));
+  }
+  if (is_negative == true) {
+    bits |= (std::uint64_t{1} << 63);
+  }
+  return std::bit_cast<double>(bits);
+}
+
+// A parser for the same syntax as parser::parse() that builds nothing itself
+// but reports what it reads to a handler, and can run during constant
+// evaluation. The handler is called for:
+//   begin_map(offset), end_map(offset), begin_array(offset), end_array(offset)
+//   key(key, offset), before the value of each member of a map
+//   string_value(value, offset), integer_value(value, num_sys, offset) and
+//   float_value(value, offset)
+// where the offsets are those of the text read. Each returns null, or an error
+// message with which to stop parsing; string views are only valid during the
+// call. The root map is reported like any other, at offset 0. Instead of
+// throwing, the parser records the first error and stops. Includes aren't
+// supported.
+template <typename t_handler> class event_parser {
+private:
+  // FNV-1a.
+  static constexpr std::uint64_t k_key_hash_basis{0xcbf29ce484222325};
+  static constexpr std::uint64_t k_key_hash_prime{0x100000001b3};
+
+  struct map_key {
+    std::string_view key;
+    std::uint64_t hash;
+  };
+
+private:
+  t_handler &m_handler;
+  std::string_view m_text;
+  std::size_t m_max_nesting_depth;
+  std::size_t m_pos;
+  // The keys of every map being parsed, innermost last.
+  std::vector<map_key> m_keys;
+  std::string m_string;
+  const error_messages::error_message *m_error;
+  std::size_t m_error_offset;
+
+public:
+  constexpr event_parser(t_handler &handler, const std::string_view text,
+                         const std::size_t max_nesting_depth)
+      : m_handler{handler}, m_text{text},
+        m_max_nesting_depth{max_nesting_depth}, m_pos{0}, m_keys{},
+        m_string{}, m_error{nullptr}, m_error_offset{0} {}
+
+public:
+  constexpr bool parse() {
+    return ((notify(m_handler.begin_map(0), 0) == true) &&
+            (parse_map_members(true, 0) == true) &&
+            (notify(m_handler.end_map(m_pos), m_pos) == true));
+  }
+
+  constexpr const error_messages::error_message *error() const {
+    return m_error;
+  }
+
+  constexpr std::size_t error_offset() const { return m_error_offset; }
+
+  // The line and character numbers of the error, starting from 1.
+  constexpr std::pair<std::size_t, std::size_t> error_position() const {
+    const std::string_view before{m_text.substr(0, m_error_offset)};
+    const std::size_t line_start{before.rfind(character_constants::k_newline)};
+    const std::size_t line_count{static_cast<std::size_t>(std::count(
+        before.begin(), before.end(), character_constants::k_newline))};
+    return {(line_count + 1),
+            ((line_start == std::string_view::npos)
+                 ? (m_error_offset + 1)
+                 : (m_error_offset - line_start))};
+  }
+
+private:
+  constexpr bool notify(const error_messages::error_message *error,
+                        const std::size_t offset) {
+    return ((error == nullptr) ? (true) : (fail(*error, offset)));
+  }
+
+  constexpr bool fail(const error_messages::error_message &message,
+                      const std::size_t offset) {
+    if (m_error == nullptr) {
+      m_error = &message;
+      m_error_offset = offset;
+    }
+    return false;
+  }
+
+  constexpr bool fail(const error_messages::error_message &message) {
+    return fail(message, m_pos);
+  }
+
+  constexpr bool is_end() const { return (m_pos >= m_text.size()); }
+
+  constexpr char peek(const std::size_t ahead = 0) const {
+    return (((m_pos + ahead) < m_text.size()) ? (m_text[m_pos + ahead])
+                                              : ('\0'));
+  }
+
+  static constexpr bool is_whitespace(const char ch) {
+    return ((ch == character_constants::k_space) ||
+            (ch == character_constants::k_tab) ||
+            (ch == character_constants::k_newline));
+  }
+
+  static constexpr bool is_name_char(const char ch) {
+    return (((ch >= 'a') && (ch <= 'z')) || ((ch >= 'A') && (ch <= 'Z')) ||
+            ((ch >= '0') && (ch <= '9')) || (ch == '_') || (ch == '-'));
+  }
+
+  constexpr bool is_comment_start() const {
+    return ((peek() == character_constants::k_comment_script) ||
+            ((peek() == character_constants::k_comment_cpp[0]) &&
+             ((peek(1) == character_constants::k_comment_cpp[1]) ||
+              (peek(1) == character_constants::k_comment_c_start[1]))));
+  }
+
+  // Skips a comment at the current position, if any, returning whether there
+  // was one; fails if it is unterminated.
+  constexpr bool skip_comment(bool &is_skipped) {
+    is_skipped = is_comment_start();
+    if (is_skipped == false) {
+      return true;
+    } else if ((peek() == character_constants::k_comment_c_start[0]) &&
+               (peek(1) == character_constants::k_comment_c_start[1])) {
+      const std::size_t end{
+          m_text.find(character_constants::k_comment_c_end, m_pos + 2)};
+      if (end == std::string_view::npos) {
+        return fail(error_messages::err_msg_1_1_1);
+      }
+      m_pos = end + character_constants::k_comment_c_end.size();
+    } else {
+      while ((is_end() == false) &&
+             (peek() != character_constants::k_newline)) {
+        ++m_pos;
+      }
+    }
+    return true;
+  }
+
+  constexpr bool skip_whitespace() {
+    while (is_end() == false) {
+      bool is_skipped{false};
+      if (is_whitespace(peek()) == true) {
+        ++m_pos;
+      } else if (skip_comment(is_skipped) == false) {
+        return false;
+      } else if (is_skipped == false) {
+        break;
+      }
+    }
+    return true;
+  }
+
+  static constexpr const error_messages::error_message &
+  extraneous_chars_error(const node_type type) {
+    switch (type) {
+    case node_type::String: {
+      return error_messages::err_msg_1_3_1;
+    } break;
+    case node_type::Integer: {
+      return error_messages::err_msg_1_4_9;
+    } break;
+    case node_type::Float: {
+      return error_messages::err_msg_1_5_13;
+    } break;
+    case node_type::Array: {
+      return error_messages::err_msg_1_6_3;
+    } break;
+    default: {
+      return error_messages::err_msg_1_7_3;
+    } break;
+    }
+  }
+
+  constexpr bool parse_map_members(const bool is_root,
+                                   const std::size_t depth) {
+    const std::size_t first_key{m_keys.size()};
+    while (true) {
+      if (skip_whitespace() == false) {
+        return false;
+      } else if (is_end() == true) {
+        m_keys.resize(first_key);
+        return ((is_root == true) ? (true)
+                                  : (fail(error_messages::err_msg_1_7_2)));
+      } else if ((is_root == false) &&
+                 (peek() == character_constants::k_map_closing_delimiter)) {
+        m_keys.resize(first_key);
+        ++m_pos;
+        return notify(m_handler.end_map(m_pos - 1), m_pos - 1);
+      } else if (peek() == character_constants::k_directive_leader) {
+        if (is_root == false) {
+          return fail(error_messages::err_msg_1_8_15);
+        } else if (parse_directive() == false) {
+          return false;
+        }
+        continue;
+      }
+
+      // Keys are compared by hash first when checking for duplicates, as
+      // that check is quadratic.
+      const std::size_t key_offset{m_pos};
+      std::uint64_t key_hash{k_key_hash_basis};
+      while ((is_end() == false) && (is_name_char(peek()) == true)) {
+        key_hash = ((key_hash ^ static_cast<unsigned char>(peek())) *
+                    k_key_hash_prime);
+        ++m_pos;
+      }
+      if (m_pos == key_offset) {
+        return fail(
+            (peek() == character_constants::k_key_value_terminate)
+                ? (error_messages::err_msg_1_2_7)
+                : ((peek() == character_constants::k_key_value_assign)
+                       ? (error_messages::err_msg_1_2_4)
+                       : (error_messages::err_msg_1_2_1)));
+      } else if ((is_end() == false) && (is_whitespace(peek()) == false) &&
+                 (peek() != character_constants::k_key_value_assign) &&
+                 (is_comment_start() == false)) {
+        return fail(error_messages::err_msg_1_2_1);
+      }
+      const std::string_view key{
+          m_text.substr(key_offset, m_pos - key_offset)};
+
+      if (skip_whitespace() == false) {
+        return false;
+      } else if (peek() != character_constants::k_key_value_assign) {
+        return fail(error_messages::err_msg_1_2_5);
+      }
+      ++m_pos;
+      if (skip_whitespace() == false) {
+        return false;
+      }
+
+      // Like the parser, a duplicate key is only reported after its value.
+      node_type type{node_type::Null};
+      if ((notify(m_handler.key(key, key_offset), key_offset) == false) ||
+          (parse_value(type, depth) == false)) {
+        return false;
+      }
+      for (std::size_t i{first_key}; i < m_keys.size(); ++i) {
+        if ((m_keys[i].hash == key_hash) && (m_keys[i].key == key)) {
+          return fail(error_messages::err_msg_1_9_5, key_offset);
+        }
+      }
+      m_keys.push_back(map_key{key, key_hash});
+
+      if (skip_whitespace() == false) {
+        return false;
+      } else if (is_end() == true) {
+        return fail(error_messages::err_msg_1_2_6);
+      } else if (peek() != character_constants::k_key_value_terminate) {
+        return fail(extraneous_chars_error(type));
+      }
+      ++m_pos;
+    }
+  }
+
+  constexpr bool parse_array_elements(const std::size_t depth) {
+    while (true) {
+      if (skip_whitespace() == false) {
+        return false;
+      } else if (is_end() == true) {
+        return fail(error_messages::err_msg_1_6_2);
+      } else if (peek() == character_constants::k_array_closing_delimiter) {
+        ++m_pos;
+        return notify(m_handler.end_array(m_pos - 1), m_pos - 1);
+      }
+
+      node_type type{node_type::Null};
+      if (parse_value(type, depth) == false) {
+        return false;
+      }
+
+      if (skip_whitespace() == false) {
+        return false;
+      } else if (is_end() == true) {
+        return fail(error_messages::err_msg_1_6_2);
+      } else if (peek() == character_constants::k_array_closing_delimiter) {
+        ++m_pos;
+        return notify(m_handler.end_array(m_pos - 1), m_pos - 1);
+      } else if (peek() != character_constants::k_array_element_separator) {
+        return fail(extraneous_chars_error(type));
+      }
+      ++m_pos;
+    }
+  }
+
+  constexpr bool parse_value(node_type &type, const std::size_t depth) {
+    if (is_end() == true) {
+      return fail(error_messages::err_msg_1_2_5);
+    }
+
+    const std::size_t offset{m_pos};
+    switch (peek()) {
+    case character_constants::k_map_opening_delimiter: {
+      if (depth >= m_max_nesting_depth) {
+        return fail(error_messages::err_msg_3_3_1);
+      }
+      type = node_type::Map;
+      ++m_pos;
+      return ((notify(m_handler.begin_map(offset), offset) == true) &&
+              (parse_map_members(false, depth + 1) == true));
+    } break;
+
+    case character_constants::k_array_opening_delimiter: {
+      if (depth >= m_max_nesting_depth) {
+        return fail(error_messages::err_msg_3_3_1);
+      }
+      type = node_type::Array;
+      ++m_pos;
+      return ((notify(m_handler.begin_array(offset), offset) == true) &&
+              (parse_array_elements(depth + 1) == true));
+    } break;
+
+    case character_constants::k_string_delimiter: {
+      type = node_type::String;
+      m_string.clear();
+      return ((parse_string() == true) &&
+              (notify(m_handler.string_value(std::string_view{m_string},
+                                             offset),
+                      offset) == true));
+    } break;
+
+    case character_constants::k_key_value_terminate:
+    case character_constants::k_array_element_separator:
+    case character_constants::k_array_closing_delimiter:
+    case character_constants::k_map_closing_delimiter: {
+      return fail(error_messages::err_msg_1_2_5);
+    } break;
+
+    default: {
+      return parse_number(type);
+    } break;
+    }
+  }
+
+  constexpr bool parse_string() {
+    while (true) {
+      ++m_pos;
+      while (true) {
+        if (is_end() == true) {
+          return fail(error_messages::err_msg_1_3_3);
+        } else if (peek() == character_constants::k_newline) {
+          return fail(error_messages::err_msg_1_3_2);
+        } else if (peek() == character_constants::k_string_delimiter) {
+          ++m_pos;
+          break;
+        } else if (peek() == character_constants::k_escape_leader) {
+          char escaped_char{};
+          if (parse_escape_sequence(escaped_char) == false) {
+            return false;
+          }
+          m_string.push_back(escaped_char);
+        } else {
+          m_string.push_back(peek());
+          ++m_pos;
+        }
+      }
+
+      // Adjacent strings are concatenated.
+      if (skip_whitespace() == false) {
+        return false;
+      } else if (peek() != character_constants::k_string_delimiter) {
+        return true;
+      }
+    }
+  }
+
+  static constexpr int hex_digit_value(const char ch) {
+    if ((ch >= '0') && (ch <= '9')) {
+      return (ch - '0');
+    } else if ((ch >= 'a') && (ch <= 'f')) {
+      return ((ch - 'a') + 10);
+    } else if ((ch >= 'A') && (ch <= 'F')) {
+      return ((ch - 'A') + 10);
+    } else {
+      return -1;
+    }
+  }
+
+  constexpr bool parse_escape_sequence(char &escaped_char) {
+    ++m_pos;
+    if ((is_end() == true) || (peek() == character_constants::k_newline)) {
+      return fail(error_messages::err_msg_1_9_1);
+    } else if (peek() == character_constants::k_hex_escape_char) {
+      for (std::size_t i{1}; i <= 2; ++i) {
+        if (((m_pos + i) >= m_text.size()) ||
+            (peek(i) == character_constants::k_newline)) {
+          return fail(error_messages::err_msg_1_9_1);
+        }
+      }
+      const int high{hex_digit_value(peek(1))};
+      const int low{hex_digit_value(peek(2))};
+      if ((high == -1) || (low == -1)) {
+        return fail(error_messages::err_msg_1_9_4);
+      }
+      escaped_char = static_cast<char>((high * 16) + low);
+      m_pos += 3;
+      return true;
+    }
+
+    switch (peek()) {
+    case '"':
+    case '\\':
+    case '/': {
+      escaped_char = peek();
+    } break;
+    case 'b': {
+      escaped_char = '\b';
+    } break;
+    case 'f': {
+      escaped_char = '\f';
+    } break;
+    case 'n': {
+      escaped_char = '\n';
+    } break;
+    case 'r': {
+      escaped_char = '\r';
+    } break;
+    case 't': {
+      escaped_char = '\t';
+    } break;
+    default: {
+      return fail(error_messages::err_msg_1_9_2);
+    } break;
+    }
+    ++m_pos;
+    return true;
+  }
+
+  static constexpr char to_lower(const char ch) {
+    return (((ch >= 'A') && (ch <= 'Z')) ? (static_cast<char>(ch - 'A' + 'a'))
+                                         : (ch));
+  }
+
+  static constexpr bool equals_ignoring_case(const std::string_view x,
+                                             const std::string_view y) {
+    return std::equal(x.begin(), x.end(), y.begin(), y.end(),
+                      [](const char x_char, const char y_char) {
+                        return (to_lower(x_char) == to_lower(y_char));
+                      });
+  }
+
+  static constexpr bool contains_ignoring_case(const std::string_view str,
+                                               const std::string_view part) {
+    for (std::size_t i{0}; (i + part.size()) <= str.size(); ++i) {
+      if (equals_ignoring_case(str.substr(i, part.size()), part) == true) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  constexpr bool parse_number(node_type &type) {
+    const std::size_t offset{m_pos};
+    while ((is_end() == false) && (is_whitespace(peek()) == false) &&
+           (peek() != character_constants::k_key_value_terminate) &&
+           (peek() != character_constants::k_array_element_separator) &&
+           (peek() != character_constants::k_array_closing_delimiter) &&
+           (peek() != character_constants::k_map_closing_delimiter) &&
+           (is_comment_start() == false)) {
+      ++m_pos;
+    }
+    const std::string_view token{m_text.substr(offset, m_pos - offset)};
+
+    // Classified the same way as by the parser, in a single pass over the
+    // token since constant evaluation is slow.
+    bool has_decimal_point{false};
+    bool has_exponent_sign{false};
+    bool has_hex_prefix{false};
+    bool has_letter_n{false};
+    for (const char ch : token) {
+      has_decimal_point = ((has_decimal_point == true) ||
+                           (ch == character_constants::k_float_decimal_point));
+      has_exponent_sign =
+          ((has_exponent_sign == true) ||
+           (ch == character_constants::k_float_exponent_sign_lower) ||
+           (ch == character_constants::k_float_exponent_sign_upper));
+      has_hex_prefix = ((has_hex_prefix == true) ||
+                        (ch == numeral_system_hexadecimal.prefix) ||
+                        (ch == numeral_system_hexadecimal.prefix_alt));
+      has_letter_n = ((has_letter_n == true) || (to_lower(ch) == 'n'));
+    }
+    const bool is_float{
+        (has_decimal_point == true) ||
+        ((has_exponent_sign == true) && (has_hex_prefix == false)) ||
+        ((has_letter_n == true) &&
+         ((contains_ignoring_case(
+               token, character_constants::k_float_infinity.second) == true) ||
+          (contains_ignoring_case(
+               token, character_constants::k_float_not_a_number.second) ==
+           true)))};
+
+    if (is_float == true) {
+      type = node_type::Float;
+      double floating{0.0};
+      return ((parse_float(token, offset, floating) == true) &&
+              (notify(m_handler.float_value(floating, offset), offset) ==
+               true));
+    } else {
+      type = node_type::Integer;
+      std::int64_t integer{0};
+      const numeral_system *num_sys{&numeral_system_decimal};
+      return ((parse_integer(token, offset, integer, num_sys) == true) &&
+              (notify(m_handler.integer_value(integer, *num_sys, offset),
+                      offset) == true));
+    }
+  }
+
+  constexpr bool parse_integer(const std::string_view token,
+                               const std::size_t offset, std::int64_t &integer,
+                               const numeral_system *&num_sys) {
+    std::size_t pos{0};
+    bool is_negative{false};
+    if ((pos < token.size()) &&
+        ((token[pos] == character_constants::k_num_positive_sign) ||
+         (token[pos] == character_constants::k_num_negative_sign))) {
+      is_negative = (token[pos] == character_constants::k_num_negative_sign);
+      ++pos;
+    }
+
+    std::size_t leading_zero_count{0};
+    for (; (pos < token.size()) &&
+           (token[pos] == character_constants::k_num_sys_prefix_leader);
+         ++pos) {
+      ++leading_zero_count;
+    }
+    num_sys = &numeral_system_decimal;
+    if (pos < token.size()) {
+      for (const numeral_system *prefixed :
+           {&numeral_system_binary, &numeral_system_octal,
+            &numeral_system_hexadecimal}) {
+        if ((token[pos] == prefixed->prefix) ||
+            (token[pos] == prefixed->prefix_alt)) {
+          if (leading_zero_count != 1) {
+            return fail(((leading_zero_count == 0)
+                             ? (error_messages::err_msg_1_4_1)
+                             : (error_messages::err_msg_1_4_7)),
+                        offset + pos);
+          }
+          num_sys = prefixed;
+          ++pos;
+          break;
+        }
+      }
+    }
+
+    std::uint64_t magnitude{0};
+    bool is_after_digit{(leading_zero_count > 0) &&
+                        (num_sys == &numeral_system_decimal)};
+    for (; pos < token.size(); ++pos) {
+      const char ch{token[pos]};
+      if (ch == character_constants::k_num_digit_separator) {
+        if ((is_after_digit == false) || ((pos + 1) == token.size())) {
+          return fail(error_messages::err_msg_1_4_2, offset + pos);
+        }
+        is_after_digit = false;
+      } else if (ch == character_constants::k_num_negative_sign) {
+        return fail(error_messages::err_msg_1_4_6, offset + pos);
+      } else if (ch == character_constants::k_num_positive_sign) {
+        return fail(error_messages::err_msg_1_4_8, offset + pos);
+      } else {
+        const int digit{hex_digit_value(ch)};
+        if ((digit == -1) || (digit >= num_sys->base)) {
+          return fail(error_messages::err_msg_1_4_1, offset + pos);
+        } else if (magnitude >
+                   ((static_cast<std::uint64_t>(
+                         std::numeric_limits<std::int64_t>::max()) -
+                     static_cast<std::uint64_t>(digit)) /
+                    static_cast<std::uint64_t>(num_sys->base))) {
+          return fail(error_messages::err_msg_1_4_5, offset);
+        }
+        magnitude = ((magnitude * static_cast<std::uint64_t>(num_sys->base)) +
+                     static_cast<std::uint64_t>(digit));
+        is_after_digit = true;
+      }
+    }
+
+    integer = static_cast<std::int64_t>(magnitude);
+    if (is_negative == true) {
+      integer = -integer;
+    }
+    return true;
+  }
+
+  constexpr bool parse_float(const std::string_view token,
+                             const std::size_t offset, double &floating) {
+    std::size_t pos{0};
+    bool is_negative{false};
+    if ((pos < token.size()) &&
+        ((token[pos] == character_constants::k_num_positive_sign) ||
+         (token[pos] == character_constants::k_num_negative_sign))) {
+      is_negative = (token[pos] == character_constants::k_num_negative_sign);
+      ++pos;
+    }
+
+    const std::string_view rest{token.substr(pos)};
+    if (equals_ignoring_case(rest,
+                             character_constants::k_float_infinity.second) ==
+        true) {
+      floating = ((is_negative == true)
+                      ? (-character_constants::k_float_infinity.first)
+                      : (character_constants::k_float_infinity.first));
+      return true;
+    } else if (equals_ignoring_case(
+                   rest, character_constants::k_float_not_a_number.second) ==
+               true) {
+      floating = ((is_negative == true)
+                      ? (-character_constants::k_float_not_a_number.first)
+                      : (character_constants::k_float_not_a_number.first));
+      return true;
+    }
+
+    enum class num_location {
+      integer,
+      fractional,
+      exponent,
+    };
+
+    num_location location{num_location::integer};
+    std::string digits{};
+    std::int64_t exponent{0};
+    std::int64_t written_exponent{0};
+    bool is_exponent_negative{false};
+    bool is_after_digit{false};
+    for (; pos < token.size(); ++pos) {
+      const char ch{token[pos]};
+      const bool is_next_digit{((pos + 1) < token.size()) &&
+                               (numeral_system_decimal.is_digit(
+                                    token[pos + 1]) == true)};
+      if (numeral_system_decimal.is_digit(ch) == true) {
+        if (location == num_location::exponent) {
+          // Beyond this, the value is zero or infinity anyway.
+          if (written_exponent < 100000) {
+            written_exponent = ((written_exponent * 10) + (ch - '0'));
+          }
+        } else {
+          digits.push_back(ch);
+          if (location == num_location::fractional) {
+            --exponent;
+          }
+        }
+        is_after_digit = true;
+      } else if (ch == character_constants::k_num_digit_separator) {
+        if ((is_after_digit == false) || (is_next_digit == false)) {
+          return fail(error_messages::err_msg_1_5_6, offset + pos);
+        }
+        is_after_digit = false;
+      } else if (ch == character_constants::k_float_decimal_point) {
+        if (location == num_location::fractional) {
+          return fail(error_messages::err_msg_1_5_2, offset + pos);
+        } else if (location == num_location::exponent) {
+          return fail(error_messages::err_msg_1_5_4, offset + pos);
+        } else if ((is_after_digit == false) || (is_next_digit == false)) {
+          return fail(error_messages::err_msg_1_5_5, offset + pos);
+        }
+        location = num_location::fractional;
+        is_after_digit = false;
+      } else if ((ch == character_constants::k_float_exponent_sign_lower) ||
+                 (ch == character_constants::k_float_exponent_sign_upper)) {
+        if (location == num_location::exponent) {
+          return fail(error_messages::err_msg_1_5_3, offset + pos);
+        } else if (is_after_digit == false) {
+          return fail(error_messages::err_msg_1_5_7, offset + pos);
+        }
+        if (((pos + 1) < token.size()) &&
+            ((token[pos + 1] == character_constants::k_num_positive_sign) ||
+             (token[pos + 1] == character_constants::k_num_negative_sign))) {
+          ++pos;
+          is_exponent_negative =
+              (token[pos] == character_constants::k_num_negative_sign);
+        }
+        if ((((pos + 1) < token.size()) &&
+             (numeral_system_decimal.is_digit(token[pos + 1]) == true)) ==
+            false) {
+          return fail(error_messages::err_msg_1_5_7, offset + pos);
+        }
+        location = num_location::exponent;
+        is_after_digit = false;
+      } else if (ch == character_constants::k_num_negative_sign) {
+        return fail(error_messages::err_msg_1_5_11, offset + pos);
+      } else if (ch == character_constants::k_num_positive_sign) {
+        return fail(error_messages::err_msg_1_5_12, offset + pos);
+      } else {
+        return fail(error_messages::err_msg_1_5_1, offset + pos);
+      }
+    }
+
+    exponent += ((is_exponent_negative == true) ? (-written_exponent)
+                                                : (written_exponent));
+    const std::optional<double> converted{
+        decimal_to_double(digits, exponent, is_negative)};
+    if (converted.has_value() == false) {
+      return fail(error_messages::err_msg_1_5_10, offset);
+    }
+    floating = converted.value();
+    return true;
+  }
+
+  constexpr bool skip_directive_line_end() {
+    while ((is_end() == false) &&
+           ((peek() == character_constants::k_space) ||
+            (peek() == character_constants::k_tab))) {
+      ++m_pos;
+    }
+    bool is_skipped{false};
+    if ((is_end() == false) && (peek() != character_constants::k_newline) &&
+        ((peek() == character_constants::k_comment_script) ||
+         ((peek() == character_constants::k_comment_cpp[0]) &&
+          (peek(1) == character_constants::k_comment_cpp[1])))) {
+      skip_comment(is_skipped);
+    }
+    return ((is_end() == true) || (peek() == character_constants::k_newline));
+  }
+
+  constexpr bool parse_directive() {
+    ++m_pos;
+    const std::size_t name_offset{m_pos};
+    while ((is_end() == false) && (peek() >= 'a') && (peek() <= 'z')) {
+      ++m_pos;
+    }
+    const std::string_view name{
+        m_text.substr(name_offset, m_pos - name_offset)};
+
+    if (name.empty() == true) {
+      return fail(error_messages::err_msg_1_8_3);
+    } else if (name == character_constants::k_include_directive_name) {
+      return fail(error_messages::err_msg_1_8_17, name_offset);
+    } else if (name != character_constants::k_version_directive_name) {
+      return fail(error_messages::err_msg_1_8_1, name_offset);
+    }
+
+    while ((is_end() == false) &&
+           ((peek() == character_constants::k_space) ||
+            (peek() == character_constants::k_tab))) {
+      ++m_pos;
+    }
+    if ((is_end() == true) ||
+        (peek() != character_constants::k_string_delimiter)) {
+      return fail(error_messages::err_msg_1_8_13);
+    }
+    ++m_pos;
+    const std::size_t version_offset{m_pos};
+    while (peek() != character_constants::k_string_delimiter) {
+      if ((is_end() == true) || (peek() == character_constants::k_newline)) {
+        return fail(error_messages::err_msg_1_8_14);
+      }
+      ++m_pos;
+    }
+    const std::string_view version{
+        m_text.substr(version_offset, m_pos - version_offset)};
+    ++m_pos;
+
+    if (version.empty() == true) {
+      return fail(error_messages::err_msg_1_8_12, version_offset);
+    } else if (version != k_version) {
+      return fail(error_messages::err_msg_1_8_10, version_offset);
+    } else if (skip_directive_line_end() == false) {
+      return fail(error_messages::err_msg_1_8_11);
+    }
+    return true;
+  }
+};
+
+// Runs an event_parser over everything in a stream, reporting failures the
+// way parser::try_parse() does.
+template <typename t_handler>
+std::expected<void, parse_error>
+parse_events(t_handler &handler, const std::string &identifier,
+             std::istream &input_stream, const bool identifier_is_file_path,
+             const std::size_t max_nesting_depth) {
+  if (input_stream.good() == false) {
+    const error_messages::error_message &error{
+        ((identifier_is_file_path == true) ? (error_messages::err_msg_4_1_1)
+                                           : (error_messages::err_msg_4_1_2))};
+    return std::unexpected{parse_error{error, identifier, 0, 0}};
+  }
+  const std::string text{std::istreambuf_iterator<char>{input_stream},
+                         std::istreambuf_iterator<char>{}};
+
+  event_parser<t_handler> parser{handler, text, max_nesting_depth};
+  if (parser.parse() == false) {
+    const std::pair<std::size_t, std::size_t> position{
+        parser.error_position()};
+    return std::unexpected{parse_error{
+        *parser.error(), identifier, static_cast<long long>(position.first),
+        static_cast<long long>(position.second)}};
+  }
+  return {};
+}
+} // namespace impl
+} // namespace libconfigfile
+
+#endif
@@ -0,0 +1,423 @@
+#ifndef LIBCONFIGFILE_FLAT_MAP_HPP
+#define LIBCONFIGFILE_FLAT_MAP_HPP
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace libconfigfile {
+namespace impl {
+template <typename t_hash, typename t_key_equal>
+concept concept_transparent_lookup = requires {
+  typename t_hash::is_transparent;
+  typename t_key_equal::is_transparent;
+};
+} // namespace impl
+
+// An unordered map whose members are kept in a single std::vector, in the
+// order they were inserted, with much the same interface as
+// std::unordered_map.
+//
+// Maps of up to t_linear_size members, which most maps in a config are, are
+// searched by comparing every key in turn and allocate nothing but their
+// members. Larger ones also keep an open-addressing table of the positions of
+// their members, tagged with the upper half of each key's hash so that most
+// mismatches are rejected without touching the key; with a t_linear_size of
+// 0 every map keeps one.
+//
+// As in std::unordered_map, value_type's key is const. Inserting members
+// invalidates all iterators and references, and erasing them moves the
+// members after them, so it takes linear time.
+template <typename t_key, typename t_value, typename t_hash = std::hash<t_key>,
+          typename t_key_equal = std::equal_to<t_key>,
+          std::size_t t_linear_size = 16>
+class flat_map {
+public:
+  using key_type = t_key;
+  using mapped_type = t_value;
+  using value_type = std::pair<const t_key, t_value>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using hasher = t_hash;
+  using key_equal = t_key_equal;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using iterator = typename std::vector<value_type>::iterator;
+  using const_iterator = typename std::vector<value_type>::const_iterator;
+
+  static constexpr size_type k_linear_size{t_linear_size};
+
+private:
+  static constexpr size_type k_npos{static_cast<size_type>(-1)};
+
+  // Members in insertion order.
+  std::vector<value_type> m_entries;
+  // Empty while m_entries.size() <= t_linear_size, unless reserve() built it
+  // ahead of time. Otherwise a power of two of slots, at most three quarters
+  // full, each 0 or the upper half of a key's hash followed by the position
+  // of its member plus 1. Once it exists, every member is in it.
+  std::vector<std::uint64_t> m_index;
+  [[no_unique_address]] t_hash m_hash;
+  [[no_unique_address]] t_key_equal m_key_equal;
+
+public:
+  flat_map() : m_entries{}, m_index{}, m_hash{}, m_key_equal{} {}
+
+  flat_map(const std::initializer_list<value_type> init) : flat_map{} {
+    insert(init.begin(), init.end());
+  }
+
+  template <std::input_iterator t_input_iterator>
+  flat_map(t_input_iterator first, t_input_iterator last) : flat_map{} {
+    insert(first, last);
+  }
+
+  flat_map(const flat_map &other) = default;
+  flat_map(flat_map &&other) noexcept = default;
+
+  ~flat_map() = default;
+
+public:
+  // std::vector's copy assignment would assign to the members, which the
+  // const key rules out.
+  flat_map &operator=(const flat_map &other) {
+    if (this != &other) {
+      flat_map copy{other};
+      swap(copy);
+    }
+    return *this;
+  }
+  flat_map &operator=(flat_map &&other) noexcept = default;
+
+public:
+  iterator begin() { return m_entries.begin(); }
+  const_iterator begin() const { return m_entries.begin(); }
+  const_iterator cbegin() const { return m_entries.cbegin(); }
+  iterator end() { return m_entries.end(); }
+  const_iterator end() const { return m_entries.end(); }
+  const_iterator cend() const { return m_entries.cend(); }
+
+  bool empty() const { return m_entries.empty(); }
+  size_type size() const { return m_entries.size(); }
+  size_type max_size() const { return m_entries.max_size(); }
+
+  hasher hash_function() const { return m_hash; }
+  key_equal key_eq() const { return m_key_equal; }
+
+  void reserve(const size_type count) {
+    if (count > m_entries.capacity()) {
+      relocate_entries(count);
+    }
+    if ((count > t_linear_size) && (index_capacity(count) > m_index.size())) {
+      rebuild_index(index_capacity(count));
+    }
+  }
+
+  void clear() {
+    m_entries.clear();
+    m_index.clear();
+  }
+
+  void swap(flat_map &other) noexcept {
+    using std::swap;
+    swap(m_entries, other.m_entries);
+    swap(m_index, other.m_index);
+    swap(m_hash, other.m_hash);
+    swap(m_key_equal, other.m_key_equal);
+  }
+
+  template <typename t_lookup_key>
+    requires(impl::concept_transparent_lookup<t_hash, t_key_equal> ||
+             std::same_as<t_lookup_key, t_key>)
+  iterator find(const t_lookup_key &key) {
+    const size_type pos{find_position(key)};
+    return ((pos == k_npos) ? (end()) : (begin() + pos));
+  }
+
+  template <typename t_lookup_key>
+    requires(impl::concept_transparent_lookup<t_hash, t_key_equal> ||
+             std::same_as<t_lookup_key, t_key>)
+  const_iterator find(const t_lookup_key &key) const {
+    const size_type pos{find_position(key)};
+    return ((pos == k_npos) ? (end()) : (begin() + pos));
+  }
+
+  template <typename t_lookup_key>
+    requires(impl::concept_transparent_lookup<t_hash, t_key_equal> ||
+             std::same_as<t_lookup_key, t_key>)
+  bool contains(const t_lookup_key &key) const {
+    return (find_position(key) != k_npos);
+  }
+
+  template <typename t_lookup_key>
+    requires(impl::concept_transparent_lookup<t_hash, t_key_equal> ||
+             std::same_as<t_lookup_key, t_key>)
+  size_type count(const t_lookup_key &key) const {
+    return ((find_position(key) == k_npos) ? (0) : (1));
+  }
+
+  template <typename t_lookup_key>
+    requires(impl::concept_transparent_lookup<t_hash, t_key_equal> ||
+             std::same_as<t_lookup_key, t_key>)
+  mapped_type &at(const t_lookup_key &key) {
+    const size_type pos{find_position(key)};
+    if (pos == k_npos) {
+      throw std::out_of_range{"flat_map::at"};
+    }
+    return m_entries[pos].second;
+  }
+
+  template <typename t_lookup_key>
+    requires(impl::concept_transparent_lookup<t_hash, t_key_equal> ||
+             std::same_as<t_lookup_key, t_key>)
+  const mapped_type &at(const t_lookup_key &key) const {
+    const size_type pos{find_position(key)};
+    if (pos == k_npos) {
+      throw std::out_of_range{"flat_map::at"};
+    }
+    return m_entries[pos].second;
+  }
+
+  mapped_type &operator[](const key_type &key) {
+    return try_emplace(key).first->second;
+  }
+
+  mapped_type &operator[](key_type &&key) {
+    return try_emplace(std::move(key)).first->second;
+  }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return try_emplace(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(value_type &&value) {
+    return try_emplace(std::move(value.first), std::move(value.second));
+  }
+
+  template <std::input_iterator t_input_iterator>
+  void insert(t_input_iterator first, t_input_iterator last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  void insert(const std::initializer_list<value_type> init) {
+    insert(init.begin(), init.end());
+  }
+
+  template <typename... t_args>
+  std::pair<iterator, bool> emplace(t_args &&...args) {
+    value_type value(std::forward<t_args>(args)...);
+    return try_emplace(std::move(value.first), std::move(value.second));
+  }
+
+  template <typename... t_args>
+  std::pair<iterator, bool> try_emplace(const key_type &key,
+                                        t_args &&...args) {
+    const size_type pos{find_position(key)};
+    if (pos != k_npos) {
+      return {begin() + pos, false};
+    }
+    make_room();
+    m_entries.emplace_back(
+        std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<t_args>(args)...));
+    return {added_last(), true};
+  }
+
+  template <typename... t_args>
+  std::pair<iterator, bool> try_emplace(key_type &&key, t_args &&...args) {
+    const size_type pos{find_position(key)};
+    if (pos != k_npos) {
+      return {begin() + pos, false};
+    }
+    make_room();
+    m_entries.emplace_back(
+        std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+        std::forward_as_tuple(std::forward<t_args>(args)...));
+    return {added_last(), true};
+  }
+
+  template <typename t_mapped>
+  std::pair<iterator, bool> insert_or_assign(const key_type &key,
+                                             t_mapped &&value) {
+    std::pair<iterator, bool> ret_val{
+        try_emplace(key, std::forward<t_mapped>(value))};
+    if (ret_val.second == false) {
+      ret_val.first->second = std::forward<t_mapped>(value);
+    }
+    return ret_val;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+  iterator erase(iterator pos) { return erase(const_iterator{pos}); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    const difference_type offset{first - cbegin()};
+    if (first != last) {
+      relocate_entries(m_entries.capacity(),
+                       static_cast<size_type>(offset),
+                       static_cast<size_type>(last - cbegin()));
+    }
+    if (m_entries.size() <= t_linear_size) {
+      m_index.clear();
+    } else if (first != last) {
+      rebuild_index(m_index.size());
+    }
+    return (begin() + offset);
+  }
+
+  template <typename t_lookup_key>
+    requires((impl::concept_transparent_lookup<t_hash, t_key_equal> ||
+              std::same_as<t_lookup_key, t_key>) &&
+             (!(std::convertible_to<t_lookup_key, iterator>)) &&
+             (!(std::convertible_to<t_lookup_key, const_iterator>)))
+  size_type erase(const t_lookup_key &key) {
+    const size_type pos{find_position(key)};
+    if (pos == k_npos) {
+      return 0;
+    }
+    erase(cbegin() + static_cast<difference_type>(pos));
+    return 1;
+  }
+
+public:
+  // Maps are equal if they hold the same members, in any order.
+  friend bool operator==(const flat_map &lhs, const flat_map &rhs) {
+    if (lhs.size() != rhs.size()) {
+      return false;
+    }
+    for (const value_type &member : lhs.m_entries) {
+      const size_type pos{rhs.find_position(member.first)};
+      if ((pos == k_npos) || ((rhs.m_entries[pos].second == member.second) ==
+                              false)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  friend void swap(flat_map &lhs, flat_map &rhs) noexcept { lhs.swap(rhs); }
+
+private:
+  static size_type index_capacity(const size_type count) {
+    return std::bit_ceil(((count * 4) / 3) + 1);
+  }
+
+  static std::uint64_t index_tag(const std::uint64_t hash) {
+    return (hash >> 32);
+  }
+
+  template <typename t_lookup_key>
+  size_type find_position(const t_lookup_key &key) const {
+    if (m_index.empty() == true) {
+      for (size_type i{0}; i < m_entries.size(); ++i) {
+        if (m_key_equal(m_entries[i].first, key) == true) {
+          return i;
+        }
+      }
+      return k_npos;
+    }
+
+    const std::uint64_t hash{static_cast<std::uint64_t>(m_hash(key))};
+    const size_type mask{m_index.size() - 1};
+    for (size_type slot{static_cast<size_type>(hash) & mask};;
+         slot = ((slot + 1) & mask)) {
+      const std::uint64_t entry{m_index[slot]};
+      if (entry == 0) {
+        return k_npos;
+      } else if (((entry >> 32) == index_tag(hash)) &&
+                 (m_key_equal(m_entries[(entry & 0xffffffff) - 1].first,
+                              key) == true)) {
+        return ((entry & 0xffffffff) - 1);
+      }
+    }
+  }
+
+  void index_insert(std::vector<std::uint64_t> &index,
+                    const size_type pos) const {
+    const std::uint64_t hash{
+        static_cast<std::uint64_t>(m_hash(m_entries[pos].first))};
+    const size_type mask{index.size() - 1};
+    size_type slot{static_cast<size_type>(hash) & mask};
+    while (index[slot] != 0) {
+      slot = ((slot + 1) & mask);
+    }
+    index[slot] = ((index_tag(hash) << 32) | (pos + 1));
+  }
+
+  void rebuild_index(const size_type capacity) {
+    std::vector<std::uint64_t> index(capacity, 0);
+    for (size_type i{0}; i < m_entries.size(); ++i) {
+      index_insert(index, i);
+    }
+    m_index = std::move(index);
+  }
+
+  // std::vector would copy the members when it reallocates, as the const key
+  // makes moving one potentially throwing, so they're moved to a new vector
+  // here instead, which only copies the keys; if that throws, the values are
+  // moved back. The members in [skip_first, skip_last) are left out, since
+  // members can't be assigned to when erasing them either.
+  void relocate_entries(const size_type capacity,
+                        const size_type skip_first = 0,
+                        const size_type skip_last = 0) {
+    std::vector<value_type> entries{};
+    entries.reserve(capacity);
+    size_type i{0};
+    try {
+      for (; i < m_entries.size(); ++i) {
+        if ((i < skip_first) || (i >= skip_last)) {
+          entries.emplace_back(std::move(m_entries[i]));
+        }
+      }
+    } catch (...) {
+      size_type moved{0};
+      for (size_type j{0}; j < i; ++j) {
+        if ((j < skip_first) || (j >= skip_last)) {
+          m_entries[j].second = std::move(entries[moved].second);
+          ++moved;
+        }
+      }
+      throw;
+    }
+    m_entries = std::move(entries);
+  }
+
+  void make_room() {
+    if (m_entries.size() == m_entries.capacity()) {
+      relocate_entries(std::max(m_entries.capacity() * 2, size_type{1}));
+    }
+  }
+
+  // Adds the member just appended to m_entries to the index, or removes it
+  // again if that fails.
+  iterator added_last() {
+    if ((m_entries.size() > t_linear_size) || (m_index.empty() == false)) {
+      try {
+        if (index_capacity(m_entries.size()) > m_index.size()) {
+          rebuild_index(index_capacity(m_entries.size()) * 2);
+        } else {
+          index_insert(m_index, m_entries.size() - 1);
+        }
+      } catch (...) {
+        m_entries.pop_back();
+        throw;
+      }
+    }
+    return (end() - 1);
+  }
+};
+} // namespace libconfigfile
+
+#endif
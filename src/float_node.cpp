@@ -36,7 +36,7 @@ libconfigfile::node_type libconfigfile::float_node::get_node_type() const {
 bool libconfigfile::float_node::polymorphic_value_compare(
     const node *other) const {
   if ((other->get_node_type()) == (node_type::Float)) {
-    return ((*(dynamic_cast<const float_node *>(other))) == (*this));
+    return ((*(static_cast<const float_node *>(other))) == (*this));
   } else {
     return false;
   }
@@ -43,7 +43,7 @@ libconfigfile::node_type libconfigfile::integer_node::get_node_type() const {
 bool libconfigfile::integer_node::polymorphic_value_compare(
     const node *other) const {
   if ((other->get_node_type()) == (node_type::Integer)) {
-    return ((*(dynamic_cast<const integer_node *>(other))) == (*this));
+    return ((*(static_cast<const integer_node *>(other))) == (*this));
   } else {
     return false;
   }
@@ -0,0 +1,123 @@
+#ifndef LIBCONFIGFILE_KEY_HASH_HPP
+#define LIBCONFIGFILE_KEY_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace libconfigfile {
+namespace impl {
+// The 128-bit product of x and y, as its low half in x and its high half in y.
+inline void key_hash_multiply(std::uint64_t &x, std::uint64_t &y) {
+#if defined(__SIZEOF_INT128__)
+  __extension__ const unsigned __int128 product{
+      static_cast<unsigned __int128>(x) * y};
+  x = static_cast<std::uint64_t>(product);
+  y = static_cast<std::uint64_t>(product >> 64);
+#else
+  const std::uint64_t x_high{x >> 32};
+  const std::uint64_t x_low{x & 0xffffffff};
+  const std::uint64_t y_high{y >> 32};
+  const std::uint64_t y_low{y & 0xffffffff};
+  const std::uint64_t high_high{x_high * y_high};
+  const std::uint64_t high_low{x_high * y_low};
+  const std::uint64_t low_high{x_low * y_high};
+  const std::uint64_t low_low{x_low * y_low};
+  const std::uint64_t middle{(low_low >> 32) + (high_low & 0xffffffff) +
+                             (low_high & 0xffffffff)};
+  x = ((middle << 32) | (low_low & 0xffffffff));
+  y = (high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32));
+#endif
+}
+
+inline std::uint64_t key_hash_mix(std::uint64_t x, std::uint64_t y) {
+  key_hash_multiply(x, y);
+  return (x ^ y);
+}
+
+inline std::uint64_t key_hash_read_8(const char *p) {
+  std::uint64_t ret_val;
+  std::memcpy(&ret_val, p, sizeof(ret_val));
+  return ret_val;
+}
+
+inline std::uint64_t key_hash_read_4(const char *p) {
+  std::uint32_t ret_val;
+  std::memcpy(&ret_val, p, sizeof(ret_val));
+  return ret_val;
+}
+
+// wyhash (final version 4) with its default secret. Each 16 bytes of input
+// cost one 64x64->128-bit multiplication, and keys of up to 16 bytes, which
+// most keys are, are read in two to four loads without a loop. The result
+// depends on the byte order of the machine, so it must not be stored.
+inline std::uint64_t key_hash_value(const std::string_view key) {
+  static constexpr std::uint64_t k_secret[4]{
+      0x2d358dccaa6c78a5, 0x8bb84b93962eacc9, 0x4b33a62ed433d4a3,
+      0x4d5a2da51de1aa47};
+
+  const char *p{key.data()};
+  std::size_t remaining{key.size()};
+  std::uint64_t seed{key_hash_mix(k_secret[0], k_secret[1])};
+  std::uint64_t a{0};
+  std::uint64_t b{0};
+  if (remaining <= 16) {
+    if (remaining >= 4) {
+      const std::size_t step{(remaining >> 3) << 2};
+      a = ((key_hash_read_4(p) << 32) | key_hash_read_4(p + step));
+      b = ((key_hash_read_4(p + remaining - 4) << 32) |
+           key_hash_read_4(p + remaining - 4 - step));
+    } else if (remaining > 0) {
+      a = ((static_cast<std::uint64_t>(static_cast<unsigned char>(p[0]))
+            << 16) |
+           (static_cast<std::uint64_t>(
+                static_cast<unsigned char>(p[remaining >> 1]))
+            << 8) |
+           static_cast<unsigned char>(p[remaining - 1]));
+    }
+  } else {
+    if (remaining > 48) {
+      std::uint64_t seed_1{seed};
+      std::uint64_t seed_2{seed};
+      do {
+        seed = key_hash_mix(key_hash_read_8(p) ^ k_secret[1],
+                            key_hash_read_8(p + 8) ^ seed);
+        seed_1 = key_hash_mix(key_hash_read_8(p + 16) ^ k_secret[2],
+                              key_hash_read_8(p + 24) ^ seed_1);
+        seed_2 = key_hash_mix(key_hash_read_8(p + 32) ^ k_secret[3],
+                              key_hash_read_8(p + 40) ^ seed_2);
+        p += 48;
+        remaining -= 48;
+      } while (remaining > 48);
+      seed ^= (seed_1 ^ seed_2);
+    }
+    while (remaining > 16) {
+      seed = key_hash_mix(key_hash_read_8(p) ^ k_secret[1],
+                          key_hash_read_8(p + 8) ^ seed);
+      p += 16;
+      remaining -= 16;
+    }
+    a = key_hash_read_8(p + remaining - 16);
+    b = key_hash_read_8(p + remaining - 8);
+  }
+  a ^= k_secret[1];
+  b ^= seed;
+  key_hash_multiply(a, b);
+  return key_hash_mix(a ^ k_secret[0] ^ key.size(), b ^ k_secret[1]);
+}
+} // namespace impl
+
+// Hash of the keys of maps. It is transparent, so together with
+// std::equal_to<> it lets a map keyed by std::string be searched with a
+// std::string_view or a string literal without constructing a std::string.
+struct key_hash {
+  using is_transparent = void;
+
+  std::size_t operator()(const std::string_view key) const {
+    return static_cast<std::size_t>(impl::key_hash_value(key));
+  }
+};
+} // namespace libconfigfile
+
+#endif
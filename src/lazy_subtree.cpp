@@ -0,0 +1,17 @@
+#include "lazy_subtree.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+libconfigfile::lazy_subtree::~lazy_subtree() {}
+
+std::mutex &
+libconfigfile::impl::lazy_subtree_mutex(const node *container) {
+  static constexpr std::size_t k_mutex_count{64};
+  static std::mutex mutexes[k_mutex_count];
+
+  // The low bits, which alignment leaves mostly zero, are skipped.
+  const std::uintptr_t address{reinterpret_cast<std::uintptr_t>(container)};
+  return mutexes[(address >> 4) % k_mutex_count];
+}
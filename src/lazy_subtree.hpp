@@ -0,0 +1,27 @@
+#ifndef LIBCONFIGFILE_LAZY_SUBTREE_HPP
+#define LIBCONFIGFILE_LAZY_SUBTREE_HPP
+
+#include <mutex>
+
+namespace libconfigfile {
+class node;
+
+// The not yet parsed contents of a map_node or array_node, which fill it in
+// when first accessed.
+class lazy_subtree {
+public:
+  virtual ~lazy_subtree();
+
+public:
+  virtual void materialize(node &target) const = 0;
+};
+
+namespace impl {
+// The lock serializing the materialization of `container` with other const
+// accesses to it while it is still unparsed. Containers share a fixed set of
+// locks, chosen by address, so that they don't each have to hold one.
+std::mutex &lazy_subtree_mutex(const node *container);
+} // namespace impl
+} // namespace libconfigfile
+
+#endif
@@ -5,18 +5,38 @@
 #include "bits-and-bytes/enum_flag_operators.hpp"
 #include "character_constants.hpp"
 #include "color.hpp"
+#include "config_image.hpp"
+#include "config_manager.hpp"
 #include "constexpr_tolower_toupper.hpp"
+#include "cow_node_ptr.hpp"
+#include "embedded_config.hpp"
 #include "error_messages.hpp"
+#include "event_parser.hpp"
+#include "flat_map.hpp"
 #include "float_node.hpp"
 #include "integer_node.hpp"
+#include "key_hash.hpp"
+#include "lazy_subtree.hpp"
 #include "map_node.hpp"
+#include "newline_index.hpp"
 #include "node.hpp"
 #include "node_ptr.hpp"
 #include "node_types.hpp"
+#include "node_view.hpp"
+#include "node_visit.hpp"
 #include "numeral_system.hpp"
+#include "parse_cache.hpp"
+#include "parse_error.hpp"
 #include "parser.hpp"
+#include "perfect_hash.hpp"
+#include "persistent_nodes.hpp"
+#include "schema.hpp"
+#include "shared_config.hpp"
+#include "source_map.hpp"
 #include "string_node.hpp"
+#include "struct_decoder.hpp"
 #include "syntax_error.hpp"
 #include "version.hpp"
+#include "wire_format.hpp"
 
 #endif
@@ -1,23 +1,39 @@
 #include "map_node.hpp"
 
 #include "character_constants.hpp"
+#include "flat_map.hpp"
+#include "key_hash.hpp"
+#include "lazy_subtree.hpp"
 #include "node.hpp"
 #include "node_ptr.hpp"
 #include "node_types.hpp"
 
+#include <functional>
+#include <initializer_list>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <type_traits>
-#include <unordered_map>
 #include <utility>
 
 libconfigfile::map_node::map_node() : base_t{} {}
 
-libconfigfile::map_node::map_node(const map_node &other) : base_t{other} {}
+libconfigfile::map_node::map_node(const map_node &other)
+    : base_t{}, m_lazy{other.get_lazy_subtree()},
+      m_is_lazy{(m_lazy != nullptr)} {
+  if (m_lazy == nullptr) {
+    base_t::operator=(other);
+  }
+}
 
 libconfigfile::map_node::map_node(map_node &&other) noexcept(
     std::is_nothrow_move_constructible_v<base_t>)
-    : base_t{std::move(other)} {}
+    : base_t{std::move(other)} {
+  reset_lazy_subtree(std::move(other.m_lazy));
+  other.reset_lazy_subtree(nullptr);
+}
 
 libconfigfile::map_node::map_node(const base_t &other) : base_t{other} {}
 
@@ -42,7 +58,7 @@ libconfigfile::node_type libconfigfile::map_node::get_node_type() const {
 bool libconfigfile::map_node::polymorphic_value_compare(
     const node *other) const {
   if ((other->get_node_type()) == (libconfigfile::node_type::Map)) {
-    return ((*(dynamic_cast<const map_node *>(other))) == (*this));
+    return ((*(static_cast<const map_node *>(other))) == (*this));
   } else {
     return false;
   }
@@ -62,7 +78,7 @@ std::string libconfigfile::map_node::serialize(int indent_level /*= 0*/) const {
     }
 
     (ret_val += (*p).first) += character_constants::k_key_value_assign;
-    ret_val += (*p).second->serialize(indent_level + 1);
+    ret_val += node_serialize(*((*p).second), indent_level + 1);
     (ret_val += character_constants::k_key_value_terminate) +=
         character_constants::k_newline;
   }
@@ -86,39 +102,258 @@ void libconfigfile::map_node::set_is_root_map(const bool is_root_map) {
   m_is_root_map = is_root_map;
 }
 
+void libconfigfile::map_node::set_lazy_subtree(
+    std::shared_ptr<const lazy_subtree> lazy) {
+  base_t::clear();
+  reset_lazy_subtree(std::move(lazy));
+}
+
+bool libconfigfile::map_node::is_materialized() const {
+  return (m_is_lazy.load(std::memory_order_acquire) == false);
+}
+
+// The contents are parsed without holding the lock, so that it is never held
+// while other containers are accessed; if another thread finishes parsing them
+// first, its result is kept.
+void libconfigfile::map_node::materialize() const {
+  const std::shared_ptr<const lazy_subtree> lazy{get_lazy_subtree()};
+  if (lazy == nullptr) {
+    return;
+  }
+
+  map_node contents{};
+  lazy->materialize(contents);
+
+  const std::lock_guard<std::mutex> lock{impl::lazy_subtree_mutex(this)};
+  if (m_lazy != nullptr) {
+    const_cast<map_node &>(*this).base_t::operator=(
+        std::move(static_cast<base_t &>(contents)));
+    m_lazy = nullptr;
+    m_is_lazy.store(false, std::memory_order_release);
+  }
+}
+
+// Null once the contents have been parsed, after which they can be read
+// without the lock.
+std::shared_ptr<const libconfigfile::lazy_subtree>
+libconfigfile::map_node::get_lazy_subtree() const {
+  if (m_is_lazy.load(std::memory_order_acquire) == false) {
+    return nullptr;
+  }
+  const std::lock_guard<std::mutex> lock{impl::lazy_subtree_mutex(this)};
+  return m_lazy;
+}
+
+void libconfigfile::map_node::reset_lazy_subtree(
+    std::shared_ptr<const lazy_subtree> lazy) {
+  m_lazy = std::move(lazy);
+  m_is_lazy.store((m_lazy != nullptr), std::memory_order_release);
+}
+
+libconfigfile::map_node::iterator libconfigfile::map_node::begin() {
+  materialize();
+  return base_t::begin();
+}
+
+libconfigfile::map_node::const_iterator
+libconfigfile::map_node::begin() const {
+  materialize();
+  return base_t::begin();
+}
+
+libconfigfile::map_node::const_iterator
+libconfigfile::map_node::cbegin() const {
+  materialize();
+  return base_t::cbegin();
+}
+
+libconfigfile::map_node::iterator libconfigfile::map_node::end() {
+  materialize();
+  return base_t::end();
+}
+
+libconfigfile::map_node::const_iterator libconfigfile::map_node::end() const {
+  materialize();
+  return base_t::end();
+}
+
+libconfigfile::map_node::const_iterator libconfigfile::map_node::cend() const {
+  materialize();
+  return base_t::cend();
+}
+
+bool libconfigfile::map_node::empty() const {
+  materialize();
+  return base_t::empty();
+}
+
+libconfigfile::map_node::size_type libconfigfile::map_node::size() const {
+  materialize();
+  return base_t::size();
+}
+
+void libconfigfile::map_node::reserve(const size_type count) {
+  materialize();
+  base_t::reserve(count);
+}
+
+libconfigfile::map_node::iterator
+libconfigfile::map_node::find(const std::string_view key) {
+  materialize();
+  return base_t::find(key);
+}
+
+libconfigfile::map_node::const_iterator
+libconfigfile::map_node::find(const std::string_view key) const {
+  materialize();
+  return base_t::find(key);
+}
+
+bool libconfigfile::map_node::contains(const std::string_view key) const {
+  materialize();
+  return base_t::contains(key);
+}
+
+libconfigfile::map_node::size_type
+libconfigfile::map_node::count(const std::string_view key) const {
+  materialize();
+  return base_t::count(key);
+}
+
+libconfigfile::map_node::mapped_type &
+libconfigfile::map_node::at(const std::string_view key) {
+  materialize();
+  return base_t::at(key);
+}
+
+const libconfigfile::map_node::mapped_type &
+libconfigfile::map_node::at(const std::string_view key) const {
+  materialize();
+  return base_t::at(key);
+}
+
+libconfigfile::map_node::mapped_type &
+libconfigfile::map_node::operator[](const key_type &key) {
+  materialize();
+  return base_t::operator[](key);
+}
+
+libconfigfile::map_node::mapped_type &
+libconfigfile::map_node::operator[](key_type &&key) {
+  materialize();
+  return base_t::operator[](std::move(key));
+}
+
+std::pair<libconfigfile::map_node::iterator, bool>
+libconfigfile::map_node::insert(const value_type &value) {
+  materialize();
+  return base_t::insert(value);
+}
+
+std::pair<libconfigfile::map_node::iterator, bool>
+libconfigfile::map_node::insert(value_type &&value) {
+  materialize();
+  return base_t::insert(std::move(value));
+}
+
+void libconfigfile::map_node::insert(
+    const std::initializer_list<value_type> init) {
+  materialize();
+  base_t::insert(init);
+}
+
+libconfigfile::map_node::iterator
+libconfigfile::map_node::erase(const_iterator pos) {
+  materialize();
+  return base_t::erase(pos);
+}
+
+libconfigfile::map_node::iterator
+libconfigfile::map_node::erase(iterator pos) {
+  materialize();
+  return base_t::erase(pos);
+}
+
+libconfigfile::map_node::iterator
+libconfigfile::map_node::erase(const_iterator first, const_iterator last) {
+  materialize();
+  return base_t::erase(first, last);
+}
+
+libconfigfile::map_node::size_type
+libconfigfile::map_node::erase(const std::string_view key) {
+  materialize();
+  return base_t::erase(key);
+}
+
+void libconfigfile::map_node::clear() {
+  reset_lazy_subtree(nullptr);
+  base_t::clear();
+}
+
+void libconfigfile::map_node::swap(map_node &other) noexcept {
+  base_t::swap(other);
+  std::shared_ptr<const lazy_subtree> lazy{std::move(m_lazy)};
+  reset_lazy_subtree(std::move(other.m_lazy));
+  other.reset_lazy_subtree(std::move(lazy));
+}
+
 libconfigfile::map_node &
 libconfigfile::map_node::operator=(const map_node &other) {
-  base_t::operator=(other);
+  std::shared_ptr<const lazy_subtree> lazy{other.get_lazy_subtree()};
+  if (lazy == nullptr) {
+    base_t::operator=(other);
+  } else {
+    base_t::clear();
+  }
+  reset_lazy_subtree(std::move(lazy));
   return *this;
 }
 
 libconfigfile::map_node &libconfigfile::map_node::operator=(
     map_node &&other) noexcept(std::is_nothrow_move_assignable_v<base_t>) {
   base_t::operator=(std::move(other));
+  reset_lazy_subtree(std::move(other.m_lazy));
+  other.reset_lazy_subtree(nullptr);
   return *this;
 }
 
 libconfigfile::map_node &
 libconfigfile::map_node::operator=(const base_t &other) {
   base_t::operator=(other);
+  reset_lazy_subtree(nullptr);
   return *this;
 }
 
 libconfigfile::map_node &libconfigfile::map_node::operator=(
     base_t &&other) noexcept(std::is_nothrow_move_assignable_v<base_t>) {
   base_t::operator=(std::move(other));
+  reset_lazy_subtree(nullptr);
   return *this;
 }
 
+bool libconfigfile::operator==(const map_node &lhs, const map_node &rhs) {
+  lhs.materialize();
+  rhs.materialize();
+  return (static_cast<const map_node::base_t &>(lhs) ==
+          static_cast<const map_node::base_t &>(rhs));
+}
+
 std::ostream &libconfigfile::operator<<(std::ostream &out, const map_node &n) {
   return n.print(out);
 }
 
+void libconfigfile::swap(map_node &lhs, map_node &rhs) noexcept {
+  lhs.swap(rhs);
+}
+
 libconfigfile::map_node::base_t
 libconfigfile::node_to_base(const map_node &node) {
+  node.materialize();
   return map_node::base_t{node};
 }
 
 libconfigfile::map_node::base_t libconfigfile::node_to_base(map_node &&node) {
+  node.materialize();
   return map_node::base_t{std::move(node)};
 }
@@ -1,23 +1,42 @@
 #ifndef LIBCONFIGFILE_MAP_NODE_HPP
 #define LIBCONFIGFILE_MAP_NODE_HPP
 
+#include "flat_map.hpp"
+#include "key_hash.hpp"
+#include "lazy_subtree.hpp"
 #include "node.hpp"
 #include "node_ptr.hpp"
 #include "node_types.hpp"
 
+#include <atomic>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <type_traits>
-#include <unordered_map>
+#include <utility>
 
 namespace libconfigfile {
-class map_node : public node,
-                 public std::unordered_map<std::string, node_ptr<node, true>> {
+// Members are stored in a flat_map, so they are iterated over in the order
+// they were inserted (for a parsed map, the order of the file).
+class map_node
+    : public node,
+      public flat_map<std::string, node_ptr<node, true>, key_hash,
+                      std::equal_to<>> {
 public:
-  using base_t = std::unordered_map<std::string, node_ptr<node, true>>;
+  using base_t = flat_map<std::string, node_ptr<node, true>, key_hash,
+                          std::equal_to<>>;
 
 private:
   bool m_is_root_map{false};
+  // Set while the contents haven't been parsed yet; see lazy_subtree. Const
+  // members only access it with impl::lazy_subtree_mutex() held.
+  mutable std::shared_ptr<const lazy_subtree> m_lazy{};
+  // Whether m_lazy is set, so that once the map has been materialized its
+  // const members can be used concurrently without taking the lock.
+  mutable std::atomic<bool> m_is_lazy{false};
 
 public:
   using base_t::base_t;
@@ -44,6 +63,82 @@ public:
   bool get_is_root_map() const;
   void set_is_root_map(const bool is_root_map);
 
+public:
+  void set_lazy_subtree(std::shared_ptr<const lazy_subtree> lazy);
+  bool is_materialized() const;
+  // Parses the contents if they haven't been yet. Throws syntax_error if they
+  // are malformed, which can only be found out here if they were deferred
+  // with parse_options::check_skipped_values set to false. Safe to call
+  // concurrently with itself and with the other const members.
+  void materialize() const;
+
+private:
+  std::shared_ptr<const lazy_subtree> get_lazy_subtree() const;
+  void reset_lazy_subtree(std::shared_ptr<const lazy_subtree> lazy);
+
+public:
+  // These hide every member of base_t that reads or changes the contents, so
+  // that they materialize the contents first (swap() instead exchanges what
+  // is still to be parsed too), and so can throw syntax_error like
+  // materialize(). Lookups take a std::string_view, so they don't construct a
+  // std::string.
+  iterator begin();
+  const_iterator begin() const;
+  const_iterator cbegin() const;
+  iterator end();
+  const_iterator end() const;
+  const_iterator cend() const;
+
+  bool empty() const;
+  size_type size() const;
+  void reserve(const size_type count);
+
+  iterator find(const std::string_view key);
+  const_iterator find(const std::string_view key) const;
+  bool contains(const std::string_view key) const;
+  size_type count(const std::string_view key) const;
+  mapped_type &at(const std::string_view key);
+  const mapped_type &at(const std::string_view key) const;
+  mapped_type &operator[](const key_type &key);
+  mapped_type &operator[](key_type &&key);
+
+  std::pair<iterator, bool> insert(const value_type &value);
+  std::pair<iterator, bool> insert(value_type &&value);
+  template <typename t_input_iterator>
+  void insert(t_input_iterator first, t_input_iterator last) {
+    materialize();
+    base_t::insert(first, last);
+  }
+  void insert(const std::initializer_list<value_type> init);
+  template <typename... t_args>
+  std::pair<iterator, bool> emplace(t_args &&...args) {
+    materialize();
+    return base_t::emplace(std::forward<t_args>(args)...);
+  }
+  template <typename... t_args>
+  std::pair<iterator, bool> try_emplace(const key_type &key, t_args &&...args) {
+    materialize();
+    return base_t::try_emplace(key, std::forward<t_args>(args)...);
+  }
+  template <typename... t_args>
+  std::pair<iterator, bool> try_emplace(key_type &&key, t_args &&...args) {
+    materialize();
+    return base_t::try_emplace(std::move(key), std::forward<t_args>(args)...);
+  }
+  template <typename t_mapped>
+  std::pair<iterator, bool> insert_or_assign(const key_type &key,
+                                             t_mapped &&value) {
+    materialize();
+    return base_t::insert_or_assign(key, std::forward<t_mapped>(value));
+  }
+
+  iterator erase(const_iterator pos);
+  iterator erase(iterator pos);
+  iterator erase(const_iterator first, const_iterator last);
+  size_type erase(const std::string_view key);
+  void clear();
+  void swap(map_node &other) noexcept;
+
 public:
   map_node &operator=(const map_node &other);
   map_node &operator=(map_node &&other) noexcept(
@@ -53,14 +148,22 @@ public:
   operator=(base_t &&other) noexcept(std::is_nothrow_move_assignable_v<base_t>);
 
 public:
+  friend bool operator==(const map_node &lhs, const map_node &rhs);
+
   friend std::ostream &operator<<(std::ostream &out, const map_node &n);
 
+  friend void swap(map_node &lhs, map_node &rhs) noexcept;
+
   friend map_node::base_t node_to_base(const map_node &node);
   friend map_node::base_t node_to_base(map_node &&node);
 };
 
+bool operator==(const map_node &lhs, const map_node &rhs);
+
 std::ostream &operator<<(std::ostream &out, const map_node &n);
 
+void swap(map_node &lhs, map_node &rhs) noexcept;
+
 map_node::base_t node_to_base(const map_node &node);
 map_node::base_t node_to_base(map_node &&node);
 } // namespace libconfigfile
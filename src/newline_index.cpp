@@ -0,0 +1,84 @@
+#include "newline_index.hpp"
+
+#include "character_constants.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+libconfigfile::newline_index::newline_index()
+    : m_newline_offsets{}, m_indexed_size{0} {}
+
+libconfigfile::newline_index::newline_index(const newline_index &other)
+    : m_newline_offsets{other.m_newline_offsets},
+      m_indexed_size{other.m_indexed_size} {}
+
+libconfigfile::newline_index::newline_index(newline_index &&other) noexcept
+    : m_newline_offsets{std::move(other.m_newline_offsets)},
+      m_indexed_size{std::move(other.m_indexed_size)} {}
+
+libconfigfile::newline_index::~newline_index() {}
+
+libconfigfile::newline_index &
+libconfigfile::newline_index::operator=(const newline_index &other) {
+  if (this != &other) {
+    m_newline_offsets = other.m_newline_offsets;
+    m_indexed_size = other.m_indexed_size;
+  }
+  return *this;
+}
+
+libconfigfile::newline_index &
+libconfigfile::newline_index::operator=(newline_index &&other) noexcept {
+  if (this != &other) {
+    m_newline_offsets = std::move(other.m_newline_offsets);
+    m_indexed_size = std::move(other.m_indexed_size);
+  }
+  return *this;
+}
+
+std::pair<long long, long long>
+libconfigfile::newline_index::position(const std::string_view text,
+                                       const std::size_t offset) {
+  const std::size_t end{std::min(offset, text.size())};
+
+  if (end > m_indexed_size) {
+    const char *const data{text.data()};
+    const char *cur{data + m_indexed_size};
+    const char *const last{data + end};
+    while (cur < last) {
+      const void *const found{
+          std::memchr(cur, character_constants::k_newline,
+                      static_cast<std::size_t>(last - cur))};
+      if (found == nullptr) {
+        break;
+      }
+      cur = static_cast<const char *>(found);
+      m_newline_offsets.push_back(static_cast<std::size_t>(cur - data));
+      ++cur;
+    }
+    m_indexed_size = end;
+  }
+
+  // The newlines before `end`, i.e. among the characters already consumed.
+  const std::size_t preceding_newlines{static_cast<std::size_t>(
+      std::lower_bound(m_newline_offsets.begin(), m_newline_offsets.end(),
+                       end) -
+      m_newline_offsets.begin())};
+
+  if (preceding_newlines == 0) {
+    return {1, static_cast<long long>(end)};
+  } else {
+    return {static_cast<long long>(preceding_newlines) + 1,
+            static_cast<long long>(
+                end - (m_newline_offsets[preceding_newlines - 1] + 1))};
+  }
+}
+
+void libconfigfile::newline_index::clear() {
+  m_newline_offsets.clear();
+  m_indexed_size = 0;
+}
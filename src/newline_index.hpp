@@ -0,0 +1,37 @@
+#ifndef LIBCONFIGFILE_NEWLINE_INDEX_HPP
+#define LIBCONFIGFILE_NEWLINE_INDEX_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace libconfigfile {
+// Converts byte offsets into a text to (line, character) positions, using
+// the same numbering as syntax_error. Newlines are only indexed as far as
+// the furthest offset looked up so far; the text itself is not stored.
+class newline_index {
+private:
+  std::vector<std::size_t> m_newline_offsets;
+  std::size_t m_indexed_size;
+
+public:
+  newline_index();
+
+  newline_index(const newline_index &other);
+  newline_index(newline_index &&other) noexcept;
+
+  ~newline_index();
+
+public:
+  newline_index &operator=(const newline_index &other);
+  newline_index &operator=(newline_index &&other) noexcept;
+
+public:
+  std::pair<long long, long long> position(const std::string_view text,
+                                           const std::size_t offset);
+  void clear();
+};
+} // namespace libconfigfile
+
+#endif
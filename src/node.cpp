@@ -1,5 +1,107 @@
 #include "node.hpp"
 
+#include "array_node.hpp"
+#include "float_node.hpp"
+#include "integer_node.hpp"
+#include "key_hash.hpp"
+#include "map_node.hpp"
 #include "node_types.hpp"
+#include "node_visit.hpp"
+#include "string_node.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+
+namespace libconfigfile {
+namespace impl {
+static std::size_t node_hash_combine(const std::size_t seed,
+                                     const std::size_t value) {
+  return seed ^ (value + static_cast<std::size_t>(0x9e3779b97f4a7c15ULL) +
+                 (seed << 6) + (seed >> 2));
+}
+
+template <typename t_node> static bool is_library_node(const t_node &n) {
+  return (typeid(n) == typeid(t_node));
+}
+} // namespace impl
+} // namespace libconfigfile
 
 libconfigfile::node::~node() {}
+
+// The functions below dispatch once on get_node_type() and then call the
+// concrete class's members with qualified (non-virtual) calls, so recursion
+// through maps and arrays doesn't go through the vtable for every child.
+// Classes derived from the concrete ones outside the library still get their
+// overrides, through the virtual members.
+
+libconfigfile::node *libconfigfile::node_clone(const node &n) {
+  return visit(n, [](const auto &x) -> node * {
+    using t_node = std::remove_cvref_t<decltype(x)>;
+    if (impl::is_library_node(x) == false) {
+      return x.create_clone();
+    }
+    return new t_node{x};
+  });
+}
+
+bool libconfigfile::node_val_equal_to(const node &x, const node &y) {
+  if (&x == &y) {
+    return true;
+  } else if (x.get_node_type() != y.get_node_type()) {
+    return false;
+  } else {
+    return visit(x, [&y](const auto &x_1) -> bool {
+      using t_node = std::remove_cvref_t<decltype(x_1)>;
+      if ((impl::is_library_node(x_1) == false) ||
+          (impl::is_library_node(static_cast<const t_node &>(y)) == false)) {
+        return x_1.polymorphic_value_compare(&y);
+      }
+      return x_1 == static_cast<const t_node &>(y);
+    });
+  }
+}
+
+std::string libconfigfile::node_serialize(const node &n,
+                                          const int indent_level /*= 0*/) {
+  return visit(n, [indent_level](const auto &x) -> std::string {
+    using t_node = std::remove_cvref_t<decltype(x)>;
+    if (impl::is_library_node(x) == false) {
+      return x.serialize(indent_level);
+    }
+    return x.t_node::serialize(indent_level);
+  });
+}
+
+std::size_t libconfigfile::node_hash(const node &n) {
+  return visit(n, [](const auto &x) -> std::size_t {
+    using t_node = std::remove_cvref_t<decltype(x)>;
+    if constexpr (std::same_as<t_node, string_node>) {
+      return std::hash<std::string_view>{}(x);
+    } else if constexpr (std::same_as<t_node, integer_node>) {
+      return std::hash<integer_node::base_t>{}(x.get());
+    } else if constexpr (std::same_as<t_node, float_node>) {
+      return std::hash<float_node::base_t>{}(x.get());
+    } else if constexpr (std::same_as<t_node, array_node>) {
+      std::size_t ret_val{x.size()};
+      for (auto p{x.begin()}; p != x.end(); ++p) {
+        ret_val = impl::node_hash_combine(
+            ret_val, ((p->get() == nullptr) ? (0) : (node_hash(**p))));
+      }
+      return ret_val;
+    } else {
+      // Summed so that the result doesn't depend on iteration order.
+      std::size_t ret_val{x.size()};
+      for (auto p{x.begin()}; p != x.end(); ++p) {
+        ret_val += impl::node_hash_combine(
+            key_hash{}(p->first),
+            ((p->second.get() == nullptr) ? (0) : (node_hash(*(p->second)))));
+      }
+      return ret_val;
+    }
+  });
+}
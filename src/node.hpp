@@ -3,7 +3,9 @@
 
 #include "node_types.hpp"
 
+#include <cstddef>
 #include <iostream>
+#include <string>
 
 namespace libconfigfile {
 class node {
@@ -20,6 +22,11 @@ public:
   virtual std::ostream &print(std::ostream &out,
                               const int indent_level = 0) const = 0;
 };
+
+node *node_clone(const node &n);
+bool node_val_equal_to(const node &x, const node &y);
+std::string node_serialize(const node &n, const int indent_level = 0);
+std::size_t node_hash(const node &n);
 } // namespace libconfigfile
 
 #endif
@@ -42,7 +42,8 @@ public:
 
   explicit node_ptr(t_ptr ptr) : m_ptr{ptr} {}
 
-  node_ptr(const node_ptr &other) : m_ptr{other.get()->create_clone()} {}
+  node_ptr(const node_ptr &other)
+      : m_ptr{static_cast<t_ptr>(node_clone(*(other.get())))} {}
 
   node_ptr(node_ptr &&other) noexcept : m_ptr{other.release()} {};
 
@@ -77,7 +78,7 @@ public:
       return *this;
     }
 
-    reset(other.get()->create_clone());
+    reset(static_cast<t_ptr>(node_clone(*(other.get()))));
 
     return *this;
   }
@@ -108,7 +109,7 @@ public:
     requires concept_node_ptr_implicitly_upcastable<t_node_to, t_node>
   operator node_ptr<t_node_to, t_compare_equality_by_value>() const & {
     return node_ptr<t_node_to, t_compare_equality_by_value>{
-        get()->create_clone()};
+        static_cast<t_ptr>(node_clone(*get()))};
   }
 
   template <concept_node_type t_node_to>
@@ -120,7 +121,7 @@ public:
   template <bool t_compare_equality_by_value_to>
   operator node_ptr<t_node, t_compare_equality_by_value_to>() const & {
     return node_ptr<t_node, t_compare_equality_by_value_to>{
-        get()->create_clone()};
+        static_cast<t_ptr>(node_clone(*get()))};
   }
 
   template <bool t_compare_equality_by_value_to>
@@ -132,7 +133,7 @@ public:
     requires concept_node_ptr_implicitly_upcastable<t_node_to, t_node>
   operator node_ptr<t_node_to, t_compare_equality_by_value_to>() const & {
     return node_ptr<t_node_to, t_compare_equality_by_value_to>{
-        get()->create_clone()};
+        static_cast<t_ptr>(node_clone(*get()))};
   }
 
   template <concept_node_type t_node_to, bool t_compare_equality_by_value_to>
@@ -364,7 +365,7 @@ node_ptr_cast(const node_ptr<t_node_from, t_compare_equality_by_value_2> &np) {
   if (np.get() == nullptr) {
     return (node_ptr<t_node_to, t_compare_equality_by_value_1>{nullptr});
   } else {
-    auto temp{np.get()->create_clone()};
+    auto temp{node_clone(*(np.get()))};
 
     auto ret_val{
         node_ptr<t_node_to, t_compare_equality_by_value_1>{dynamic_cast<
@@ -610,7 +611,7 @@ template <
 bool node_ptr_val_equal_to(
     const node_ptr<t_node_1, t_compare_equality_by_value_1> &x,
     const node_ptr<t_node_2, t_compare_equality_by_value_2> &y) {
-  return (x.get()->polymorphic_value_compare(y.get()));
+  return (node_val_equal_to(*(x.get()), *(y.get())));
 }
 
 template <
@@ -0,0 +1,229 @@
+#ifndef LIBCONFIGFILE_NODE_VIEW_HPP
+#define LIBCONFIGFILE_NODE_VIEW_HPP
+
+#include "array_node.hpp"
+#include "float_node.hpp"
+#include "integer_node.hpp"
+#include "map_node.hpp"
+#include "node.hpp"
+#include "node_ptr.hpp"
+#include "node_types.hpp"
+#include "string_node.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace libconfigfile {
+
+template <typename t_node>
+concept concept_node_view_type =
+    std::same_as<t_node, node> || std::same_as<t_node, string_node> ||
+    std::same_as<t_node, integer_node> || std::same_as<t_node, float_node> ||
+    std::same_as<t_node, array_node> || std::same_as<t_node, map_node>;
+
+template <typename t_value>
+concept concept_node_view_value =
+    (std::integral<t_value> && (!(std::same_as<t_value, bool>))) ||
+    std::floating_point<t_value> || std::same_as<t_value, std::string_view>;
+
+namespace impl {
+template <concept_node_view_type t_node>
+constexpr bool node_view_type_matches(const node_type type) {
+  if constexpr (std::same_as<t_node, node>) {
+    return type != node_type::Null;
+  } else if constexpr (std::same_as<t_node, string_node>) {
+    return type == node_type::String;
+  } else if constexpr (std::same_as<t_node, integer_node>) {
+    return type == node_type::Integer;
+  } else if constexpr (std::same_as<t_node, float_node>) {
+    return type == node_type::Float;
+  } else if constexpr (std::same_as<t_node, array_node>) {
+    return type == node_type::Array;
+  } else {
+    return type == node_type::Map;
+  }
+}
+} // namespace impl
+
+template <concept_node_view_type t_node> class node_view {
+  template <concept_node_view_type t_node_1> friend class node_view;
+
+public:
+  using t_const_ptr = const t_node *;
+
+private:
+  t_const_ptr m_ptr;
+
+public:
+  node_view() : m_ptr{nullptr} {}
+
+  node_view(std::nullptr_t) : m_ptr{nullptr} {}
+
+  node_view(const t_node &n) : m_ptr{&n} {}
+
+  template <concept_node_type t_node_from, bool t_compare_equality_by_value>
+    requires concept_node_ptr_implicitly_upcastable<t_node, t_node_from>
+  node_view(const node_ptr<t_node_from, t_compare_equality_by_value> &np)
+      : m_ptr{np.get()} {}
+
+  template <concept_node_view_type t_node_from>
+    requires(concept_node_ptr_implicitly_upcastable<t_node, t_node_from> &&
+             (!(std::same_as<t_node, t_node_from>)))
+  node_view(const node_view<t_node_from> &other) : m_ptr{other.m_ptr} {}
+
+  node_view(const node_view &other) = default;
+
+  ~node_view() = default;
+
+public:
+  node_view &operator=(const node_view &other) = default;
+
+public:
+  t_const_ptr get() const { return m_ptr; }
+
+  node_type get_node_type() const {
+    return ((m_ptr == nullptr) ? (node_type::Null) : (m_ptr->get_node_type()));
+  }
+
+  template <concept_node_view_type t_node_to> bool is() const {
+    return impl::node_view_type_matches<t_node_to>(get_node_type());
+  }
+
+  template <concept_node_view_type t_node_to> node_view<t_node_to> as() const {
+    if (is<t_node_to>() == true) {
+      node_view<t_node_to> ret_val{};
+      ret_val.m_ptr = static_cast<const t_node_to *>(
+          static_cast<const node *>(m_ptr));
+      return ret_val;
+    } else {
+      return node_view<t_node_to>{nullptr};
+    }
+  }
+
+  template <concept_node_view_value t_value>
+  std::optional<t_value> try_get() const {
+    if constexpr (std::same_as<t_value, std::string_view>) {
+      if (auto v{as<string_node>()}; v) {
+        return std::string_view{*(v.get())};
+      }
+    } else if constexpr (std::floating_point<t_value>) {
+      if (auto v{as<float_node>()}; v) {
+        return static_cast<t_value>(v.get()->get());
+      }
+    } else {
+      if (auto v{as<integer_node>()}; v) {
+        const integer_node::base_t value{v.get()->get()};
+        if (std::in_range<t_value>(value) == true) {
+          return static_cast<t_value>(value);
+        }
+      }
+    }
+    return std::nullopt;
+  }
+
+  template <concept_node_view_value t_value>
+  t_value value_or(t_value default_value) const {
+    return try_get<t_value>().value_or(std::move(default_value));
+  }
+
+  node_view<node> find(const std::string_view key) const {
+    if (auto v{as<map_node>()}; v) {
+      auto p{v.get()->find(key)};
+      if (p != v.get()->end()) {
+        return node_view<node>{p->second};
+      }
+    }
+    return node_view<node>{nullptr};
+  }
+
+  node_view<node> find(const std::size_t pos) const {
+    if (auto v{as<array_node>()}; v) {
+      if (pos < v.get()->size()) {
+        return node_view<node>{(*(v.get()))[pos]};
+      }
+    }
+    return node_view<node>{nullptr};
+  }
+
+  bool contains(const std::string_view key) const {
+    return static_cast<bool>(find(key));
+  }
+
+  std::size_t size() const {
+    switch (get_node_type()) {
+    case node_type::Map: {
+      return as<map_node>().get()->size();
+    } break;
+    case node_type::Array: {
+      return as<array_node>().get()->size();
+    } break;
+    default: {
+      return 0;
+    } break;
+    }
+  }
+
+  auto begin() const
+    requires(std::same_as<t_node, map_node> || std::same_as<t_node, array_node>)
+  {
+    return m_ptr->cbegin();
+  }
+
+  auto end() const
+    requires(std::same_as<t_node, map_node> || std::same_as<t_node, array_node>)
+  {
+    return m_ptr->cend();
+  }
+
+public:
+  explicit operator bool() const { return m_ptr != nullptr; }
+
+  const t_node &operator*() const { return *get(); }
+
+  t_const_ptr operator->() const { return get(); }
+
+  node_view<node> operator[](const std::string_view key) const {
+    return find(key);
+  }
+
+  node_view<node> operator[](const std::size_t pos) const { return find(pos); }
+};
+
+using map_view = node_view<map_node>;
+using array_view = node_view<array_node>;
+
+template <concept_node_view_type t_node_1, concept_node_view_type t_node_2>
+bool operator==(const node_view<t_node_1> &x, const node_view<t_node_2> &y) {
+  return ((static_cast<const node *>(x.get())) ==
+          (static_cast<const node *>(y.get())));
+}
+
+template <concept_node_view_type t_node_1>
+bool operator==(const node_view<t_node_1> &x, std::nullptr_t) {
+  return ((x.get()) == (nullptr));
+}
+
+template <concept_node_view_type t_node_1, concept_node_view_type t_node_2>
+bool operator!=(const node_view<t_node_1> &x, const node_view<t_node_2> &y) {
+  return (!(x == y));
+}
+
+template <concept_node_view_type t_node_1>
+bool operator!=(const node_view<t_node_1> &x, std::nullptr_t) {
+  return (!(x == nullptr));
+}
+
+template <concept_node_view_type t_node_1>
+std::ostream &operator<<(std::ostream &out, const node_view<t_node_1> &v) {
+  v.get()->print(out);
+  return out;
+}
+
+} // namespace libconfigfile
+
+#endif
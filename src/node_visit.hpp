@@ -0,0 +1,56 @@
+#ifndef LIBCONFIGFILE_NODE_VISIT_HPP
+#define LIBCONFIGFILE_NODE_VISIT_HPP
+
+#include "array_node.hpp"
+#include "float_node.hpp"
+#include "integer_node.hpp"
+#include "map_node.hpp"
+#include "node.hpp"
+#include "node_types.hpp"
+#include "string_node.hpp"
+
+#include "bits-and-bytes/unreachable_error.hpp"
+
+#include <concepts>
+#include <type_traits>
+#include <utility>
+
+namespace libconfigfile {
+namespace impl {
+template <typename t_from, typename t_to>
+using node_visit_copy_const_t =
+    std::conditional_t<std::is_const_v<t_from>, const t_to, t_to>;
+} // namespace impl
+
+template <typename t_node, typename t_visitor>
+  requires std::same_as<std::remove_const_t<t_node>, node>
+decltype(auto) visit(t_node &n, t_visitor &&visitor) {
+  switch (n.get_node_type()) {
+  case node_type::String: {
+    return std::forward<t_visitor>(visitor)(
+        static_cast<impl::node_visit_copy_const_t<t_node, string_node> &>(n));
+  } break;
+  case node_type::Integer: {
+    return std::forward<t_visitor>(visitor)(
+        static_cast<impl::node_visit_copy_const_t<t_node, integer_node> &>(n));
+  } break;
+  case node_type::Float: {
+    return std::forward<t_visitor>(visitor)(
+        static_cast<impl::node_visit_copy_const_t<t_node, float_node> &>(n));
+  } break;
+  case node_type::Array: {
+    return std::forward<t_visitor>(visitor)(
+        static_cast<impl::node_visit_copy_const_t<t_node, array_node> &>(n));
+  } break;
+  case node_type::Map: {
+    return std::forward<t_visitor>(visitor)(
+        static_cast<impl::node_visit_copy_const_t<t_node, map_node> &>(n));
+  } break;
+  default: {
+    throw bits_and_bytes::unreachable_error{};
+  } break;
+  }
+}
+} // namespace libconfigfile
+
+#endif
@@ -0,0 +1,336 @@
+#include "parse_cache.hpp"
+
+#include "config_image.hpp"
+#include "map_node.hpp"
+#include "node_ptr.hpp"
+#include "parser.hpp"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace libconfigfile {
+namespace parser {
+namespace impl {
+static constexpr char k_cache_magic[8]{'L', 'C', 'F', 'C', 'A', 'C', 'H', 'E'};
+static constexpr std::uint32_t k_cache_version{2};
+static constexpr std::string_view k_cache_file_suffix{".cache"};
+// File systems may only update modification times every few milliseconds (or
+// seconds), so a file modified this shortly before a parse started might
+// still have been read before the modification.
+static constexpr std::chrono::seconds k_cache_racy_interval{2};
+
+// The limits of parse_options a snapshot was parsed within. The same file
+// might be rejected under other limits, so a snapshot is only used by parses
+// with the same ones.
+struct cache_limits {
+  std::uint64_t max_nesting_depth;
+  std::uint64_t max_input_bytes;
+  std::uint64_t max_node_count;
+  std::uint64_t max_include_count;
+  std::uint64_t max_include_depth;
+  std::uint64_t max_string_length;
+
+  friend bool operator==(const cache_limits &lhs,
+                         const cache_limits &rhs) = default;
+};
+
+struct cache_header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t dependency_count;
+  // Of the image, which is otherwise only checked for offsets out of bounds.
+  std::uint64_t image_hash;
+  cache_limits limits;
+};
+
+static cache_limits make_cache_limits(const parse_options &options) {
+  return cache_limits{options.max_nesting_depth, options.max_input_bytes,
+                      options.max_node_count,    options.max_include_count,
+                      options.max_include_depth, options.max_string_length};
+}
+
+// Followed by the path's bytes.
+struct cache_dependency {
+  std::uint64_t size;
+  std::int64_t write_time;
+  std::uint64_t hash;
+  std::uint64_t path_length;
+};
+
+static std::optional<std::string>
+read_whole_file(const std::filesystem::path &file_path) {
+  std::ifstream input_stream{file_path, std::ios::binary};
+  if (input_stream.good() == false) {
+    return std::nullopt;
+  }
+  std::string ret_val{std::istreambuf_iterator<char>{input_stream},
+                      std::istreambuf_iterator<char>{}};
+  if (input_stream.bad() == true) {
+    return std::nullopt;
+  }
+  return ret_val;
+}
+
+// 64-bit FNV-1a, which unlike std::hash is the same on every platform and
+// across library versions.
+static std::uint64_t cache_hash(const std::string_view data) {
+  std::uint64_t ret_val{0xcbf29ce484222325};
+  for (const char ch : data) {
+    ret_val ^= static_cast<unsigned char>(ch);
+    ret_val *= 0x100000001b3;
+  }
+  return ret_val;
+}
+
+static std::optional<cache_dependency>
+stat_dependency(const std::filesystem::path &file_path) {
+  std::error_code error{};
+  const std::uintmax_t size{std::filesystem::file_size(file_path, error)};
+  if (error) {
+    return std::nullopt;
+  }
+  const std::filesystem::file_time_type write_time{
+      std::filesystem::last_write_time(file_path, error)};
+  if (error) {
+    return std::nullopt;
+  }
+  return cache_dependency{
+      static_cast<std::uint64_t>(size),
+      static_cast<std::int64_t>(write_time.time_since_epoch().count()), 0,
+      static_cast<std::uint64_t>(file_path.native().size())};
+}
+
+static bool is_dependency_unchanged(const cache_dependency &dependency,
+                                    const std::filesystem::path &file_path) {
+  const std::optional<cache_dependency> current{stat_dependency(file_path)};
+  if ((current.has_value() == false) ||
+      (current.value().size != dependency.size)) {
+    return false;
+  } else if (current.value().write_time == dependency.write_time) {
+    return true;
+  }
+
+  // Only touched, or rewritten with the same contents.
+  const std::optional<std::string> contents{read_whole_file(file_path)};
+  return ((contents.has_value() == true) &&
+          (cache_hash(contents.value()) == dependency.hash));
+}
+
+template <typename t_value>
+static t_value cache_load(const std::string_view data, std::size_t &offset) {
+  if ((offset > data.size()) || ((data.size() - offset) < sizeof(t_value))) {
+    throw std::runtime_error{"parse cache is malformed"};
+  }
+  t_value ret_val;
+  std::memcpy(&ret_val, data.data() + offset, sizeof(ret_val));
+  offset += sizeof(ret_val);
+  return ret_val;
+}
+
+template <typename t_value>
+static void cache_append(std::string &data, const t_value &value) {
+  data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+} // namespace impl
+} // namespace parser
+} // namespace libconfigfile
+
+std::filesystem::path libconfigfile::parser::impl::cache_file_path(
+    const std::filesystem::path &file_path) {
+  std::filesystem::path ret_val{file_path};
+  ret_val += k_cache_file_suffix;
+  return ret_val;
+}
+
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::map_node>>
+libconfigfile::parser::impl::parse_file_with_cache(
+    const std::filesystem::path &file_path, const parse_options &options,
+    std::vector<std::filesystem::path> *included_file_paths /*= nullptr*/) {
+  // Spans need the source text, a filtered tree isn't the whole file, and
+  // storing a lazy tree would materialize it.
+  if ((options.spans != nullptr) || (options.key_paths.empty() == false) ||
+      (options.lazy_containers == true)) {
+    return parse_file(file_path, options, included_file_paths);
+  }
+
+  if (std::optional<node_ptr<map_node>> cached{
+          load_parse_cache(file_path, options, included_file_paths)};
+      cached.has_value() == true) {
+    return std::move(cached.value());
+  }
+
+  const std::filesystem::file_time_type parse_start_time{
+      std::filesystem::file_time_type::clock::now()};
+  std::vector<std::filesystem::path> dependency_paths{};
+  parse_result<node_ptr<map_node>> ret_val{
+      parse_file(file_path, options, &dependency_paths)};
+  if (ret_val.has_value() == true) {
+    store_parse_cache(file_path, options, dependency_paths,
+                      *(ret_val.value()), parse_start_time);
+  }
+
+  if (included_file_paths != nullptr) {
+    included_file_paths->insert(included_file_paths->end(),
+                                dependency_paths.begin(),
+                                dependency_paths.end());
+  }
+  return ret_val;
+}
+
+std::optional<libconfigfile::node_ptr<libconfigfile::map_node>>
+libconfigfile::parser::impl::load_parse_cache(
+    const std::filesystem::path &file_path, const parse_options &options,
+    std::vector<std::filesystem::path> *included_file_paths /*= nullptr*/) {
+  const std::optional<std::string> data{
+      read_whole_file(cache_file_path(file_path))};
+  if (data.has_value() == false) {
+    return std::nullopt;
+  }
+
+  try {
+    std::size_t offset{0};
+    const cache_header header{cache_load<cache_header>(data.value(), offset)};
+    if ((std::memcmp(header.magic, k_cache_magic, sizeof(header.magic)) !=
+         0) ||
+        (header.version != k_cache_version) ||
+        (header.dependency_count == 0) ||
+        (header.limits != make_cache_limits(options))) {
+      return std::nullopt;
+    }
+
+    // The first dependency is the file itself.
+    std::vector<std::filesystem::path> dependency_paths{};
+    for (std::uint32_t i{0}; i < header.dependency_count; ++i) {
+      const cache_dependency dependency{
+          cache_load<cache_dependency>(data.value(), offset)};
+      if (dependency.path_length > (data.value().size() - offset)) {
+        return std::nullopt;
+      }
+      std::filesystem::path dependency_path{data.value().substr(
+          offset, static_cast<std::size_t>(dependency.path_length))};
+      offset += static_cast<std::size_t>(dependency.path_length);
+
+      if (((i == 0) && (dependency_path != file_path)) ||
+          (is_dependency_unchanged(dependency, dependency_path) == false)) {
+        return std::nullopt;
+      } else if (i > 0) {
+        dependency_paths.push_back(std::move(dependency_path));
+      }
+    }
+
+    offset = (offset + (alignof(std::uint64_t) - 1)) &
+             (~(alignof(std::uint64_t) - 1));
+    if (offset > data.value().size()) {
+      return std::nullopt;
+    }
+    const std::string_view image{std::string_view{data.value()}.substr(offset)};
+    if (cache_hash(image) != header.image_hash) {
+      return std::nullopt;
+    }
+    node_ptr<map_node> ret_val{
+        node_ptr_cast<map_node>(image_root(image).to_node())};
+    ret_val->set_is_root_map(true);
+
+    if (included_file_paths != nullptr) {
+      included_file_paths->insert(included_file_paths->end(),
+                                  dependency_paths.begin(),
+                                  dependency_paths.end());
+    }
+    return ret_val;
+  } catch (const std::exception &) {
+    return std::nullopt;
+  }
+}
+
+// The snapshot is written to a temporary file which is then renamed over the
+// old one, so that a concurrent load sees either the old or the new snapshot.
+// Failures are ignored; the next parse just doesn't find a snapshot.
+bool libconfigfile::parser::impl::store_parse_cache(
+    const std::filesystem::path &file_path, const parse_options &options,
+    const std::vector<std::filesystem::path> &included_file_paths,
+    const map_node &root,
+    const std::filesystem::file_time_type parse_start_time) {
+  try {
+    std::vector<std::filesystem::path> dependency_paths{file_path};
+    dependency_paths.insert(dependency_paths.end(),
+                            included_file_paths.begin(),
+                            included_file_paths.end());
+
+    std::string data{};
+    cache_header header{};
+    std::memcpy(header.magic, k_cache_magic, sizeof(header.magic));
+    header.version = k_cache_version;
+    header.dependency_count =
+        static_cast<std::uint32_t>(dependency_paths.size());
+    header.limits = make_cache_limits(options);
+    cache_append(data, header);
+
+    for (const std::filesystem::path &dependency_path : dependency_paths) {
+      std::optional<cache_dependency> dependency{
+          stat_dependency(dependency_path)};
+      const std::optional<std::string> contents{
+          read_whole_file(dependency_path)};
+      if ((dependency.has_value() == false) ||
+          (contents.has_value() == false) ||
+          (dependency.value().size != contents.value().size()) ||
+          (std::filesystem::file_time_type{
+               std::filesystem::file_time_type::duration{
+                   dependency.value().write_time}} >=
+           (parse_start_time - k_cache_racy_interval))) {
+        return false;
+      }
+      dependency.value().hash = cache_hash(contents.value());
+      cache_append(data, dependency.value());
+      data.append(dependency_path.native());
+    }
+
+    data.resize((data.size() + (alignof(std::uint64_t) - 1)) &
+                    (~(alignof(std::uint64_t) - 1)),
+                '\0');
+    const std::string image{compile_image(root)};
+    header.image_hash = cache_hash(image);
+    std::memcpy(data.data(), &header, sizeof(header));
+    data.append(image);
+
+    std::filesystem::path temp_path{cache_file_path(file_path)};
+    temp_path += '.' + std::to_string(getpid());
+    {
+      std::ofstream output_stream{temp_path,
+                                  std::ios::binary | std::ios::trunc};
+      output_stream.write(data.data(),
+                          static_cast<std::streamsize>(data.size()));
+      output_stream.close();
+      if (output_stream.fail() == true) {
+        std::error_code error{};
+        std::filesystem::remove(temp_path, error);
+        return false;
+      }
+    }
+
+    std::error_code error{};
+    std::filesystem::rename(temp_path, cache_file_path(file_path), error);
+    if (error) {
+      std::filesystem::remove(temp_path, error);
+      return false;
+    }
+    return true;
+  } catch (const std::exception &) {
+    return false;
+  }
+}
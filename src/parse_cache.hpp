@@ -0,0 +1,40 @@
+#ifndef LIBCONFIGFILE_PARSE_CACHE_HPP
+#define LIBCONFIGFILE_PARSE_CACHE_HPP
+
+#include "map_node.hpp"
+#include "node_ptr.hpp"
+#include "parser.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace libconfigfile {
+namespace parser {
+namespace impl {
+// Snapshots of parsed files, kept next to them when parse_options::use_cache
+// is set. A snapshot records the size, modification time and a hash of the
+// contents of the file and of every file it included and the limits it was
+// parsed within, followed by the tree as a config image. It is only used by
+// parses with the same limits, and only if all of those files are unchanged;
+// anything else, including a missing or corrupted snapshot, falls back to a
+// full parse, after which the snapshot is rewritten.
+std::filesystem::path cache_file_path(const std::filesystem::path &file_path);
+
+parse_result<node_ptr<map_node>> parse_file_with_cache(
+    const std::filesystem::path &file_path, const parse_options &options,
+    std::vector<std::filesystem::path> *included_file_paths = nullptr);
+
+std::optional<node_ptr<map_node>> load_parse_cache(
+    const std::filesystem::path &file_path, const parse_options &options,
+    std::vector<std::filesystem::path> *included_file_paths = nullptr);
+bool store_parse_cache(
+    const std::filesystem::path &file_path, const parse_options &options,
+    const std::vector<std::filesystem::path> &included_file_paths,
+    const map_node &root,
+    const std::filesystem::file_time_type parse_start_time);
+} // namespace impl
+} // namespace parser
+} // namespace libconfigfile
+
+#endif
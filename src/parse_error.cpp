@@ -0,0 +1,73 @@
+#include "parse_error.hpp"
+
+#include "error_messages.hpp"
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+libconfigfile::parse_error::parse_error(const error_code code,
+                                        const std::string &file_path,
+                                        const long long pos_line,
+                                        const long long pos_char)
+    : m_code{code}, m_file_path{file_path}, m_pos_line{pos_line},
+      m_pos_char{pos_char} {}
+
+libconfigfile::parse_error::parse_error(
+    const error_messages::error_message &error, const std::string &file_path,
+    const long long pos_line, const long long pos_char)
+    : parse_error{error.code, file_path, pos_line, pos_char} {}
+
+libconfigfile::parse_error::parse_error(const parse_error &other)
+    : m_code{other.m_code}, m_file_path{other.m_file_path},
+      m_pos_line{other.m_pos_line}, m_pos_char{other.m_pos_char} {}
+
+libconfigfile::parse_error::parse_error(parse_error &&other) noexcept
+    : m_code{std::move(other.m_code)},
+      m_file_path{std::move(other.m_file_path)},
+      m_pos_line{std::move(other.m_pos_line)},
+      m_pos_char{std::move(other.m_pos_char)} {}
+
+libconfigfile::parse_error::~parse_error() {}
+
+libconfigfile::parse_error &
+libconfigfile::parse_error::operator=(const parse_error &other) {
+  if (this != &other) {
+    m_code = other.m_code;
+    m_file_path = other.m_file_path;
+    m_pos_line = other.m_pos_line;
+    m_pos_char = other.m_pos_char;
+  }
+  return *this;
+}
+
+libconfigfile::parse_error &
+libconfigfile::parse_error::operator=(parse_error &&other) noexcept {
+  if (this != &other) {
+    m_code = std::move(other.m_code);
+    m_file_path = std::move(other.m_file_path);
+    m_pos_line = std::move(other.m_pos_line);
+    m_pos_char = std::move(other.m_pos_char);
+  }
+  return *this;
+}
+
+libconfigfile::error_code libconfigfile::parse_error::code() const {
+  return m_code;
+}
+
+std::string_view libconfigfile::parse_error::message() const {
+  return error_messages::find_error_message(m_code)->message;
+}
+
+std::string_view libconfigfile::parse_error::category() const {
+  return error_messages::find_error_message(m_code)->category;
+}
+
+const std::string &libconfigfile::parse_error::file_path() const {
+  return m_file_path;
+}
+
+long long libconfigfile::parse_error::pos_line() const { return m_pos_line; }
+
+long long libconfigfile::parse_error::pos_char() const { return m_pos_char; }
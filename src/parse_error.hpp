@@ -0,0 +1,45 @@
+#ifndef LIBCONFIGFILE_PARSE_ERROR_HPP
+#define LIBCONFIGFILE_PARSE_ERROR_HPP
+
+#include "error_messages.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace libconfigfile {
+class parse_error {
+  friend class syntax_error;
+
+private:
+  error_code m_code;
+  std::string m_file_path;
+  long long m_pos_line;
+  long long m_pos_char;
+
+public:
+  explicit parse_error(const error_code code, const std::string &file_path,
+                       const long long pos_line, const long long pos_char);
+  explicit parse_error(const error_messages::error_message &error,
+                       const std::string &file_path, const long long pos_line,
+                       const long long pos_char);
+
+  parse_error(const parse_error &other);
+  parse_error(parse_error &&other) noexcept;
+
+  ~parse_error();
+
+public:
+  parse_error &operator=(const parse_error &other);
+  parse_error &operator=(parse_error &&other) noexcept;
+
+public:
+  error_code code() const;
+  std::string_view message() const;
+  std::string_view category() const;
+  const std::string &file_path() const;
+  long long pos_line() const;
+  long long pos_char() const;
+};
+} // namespace libconfigfile
+
+#endif
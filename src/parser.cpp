@@ -6,11 +6,16 @@
 #include "error_messages.hpp"
 #include "float_node.hpp"
 #include "integer_node.hpp"
+#include "key_hash.hpp"
+#include "lazy_subtree.hpp"
 #include "map_node.hpp"
 #include "node.hpp"
 #include "node_ptr.hpp"
 #include "node_types.hpp"
 #include "numeral_system.hpp"
+#include "parse_cache.hpp"
+#include "parse_error.hpp"
+#include "source_map.hpp"
 #include "string_node.hpp"
 #include "syntax_error.hpp"
 #include "version.hpp"
@@ -21,13 +26,18 @@
 #include <cassert>
 #include <cctype>
 #include <charconv>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
+#include <expected>
 #include <filesystem>
 #include <fstream>
 #include <istream>
+#include <memory>
 #include <optional>
 #include <stdexcept>
+#include <streambuf>
 #include <string>
 #include <string_view>
 #include <system_error>
@@ -35,66 +45,546 @@
 #include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 libconfigfile::node_ptr<libconfigfile::map_node>
 libconfigfile::parser::parse(const std::string &identifier,
                              std::istream &input_stream,
-                             const bool identifier_is_file_path /*= false*/) {
-  return impl::parse(identifier, input_stream, identifier_is_file_path);
+                             const bool identifier_is_file_path /*= false*/,
+                             const parse_options &options /*= parse_options{}*/) {
+  return impl::value_or_throw(
+      try_parse(identifier, input_stream, identifier_is_file_path, options));
 }
 
 libconfigfile::node_ptr<libconfigfile::map_node>
-libconfigfile::parser::parse_file(const char *file_path) {
-  std::ifstream input_stream{file_path};
-  return impl::parse(file_path, input_stream, true);
+libconfigfile::parser::parse_file(
+    const char *file_path, const parse_options &options /*= parse_options{}*/) {
+  return impl::value_or_throw(try_parse_file(file_path, options));
 }
 
 libconfigfile::node_ptr<libconfigfile::map_node>
-libconfigfile::parser::parse_file(const std::string &file_path) {
-  std::ifstream input_stream{file_path};
-  return impl::parse(file_path, input_stream, true);
+libconfigfile::parser::parse_file(
+    const std::string &file_path,
+    const parse_options &options /*= parse_options{}*/) {
+  return impl::value_or_throw(try_parse_file(file_path, options));
 }
 
 libconfigfile::node_ptr<libconfigfile::map_node>
-libconfigfile::parser::parse_file(const std::filesystem::path &file_path) {
-  std::ifstream input_stream{file_path};
-  return impl::parse(file_path.string(), input_stream, true);
+libconfigfile::parser::parse_file(
+    const std::filesystem::path &file_path,
+    const parse_options &options /*= parse_options{}*/) {
+  return impl::value_or_throw(try_parse_file(file_path, options));
 }
 
 libconfigfile::node_ptr<libconfigfile::map_node>
+libconfigfile::parser::parse_file(
+    const std::filesystem::path &file_path,
+    std::vector<std::filesystem::path> &included_file_paths,
+    const parse_options &options /*= parse_options{}*/) {
+  return impl::value_or_throw(
+      try_parse_file(file_path, included_file_paths, options));
+}
+
+std::expected<libconfigfile::node_ptr<libconfigfile::map_node>,
+              libconfigfile::parse_error>
+libconfigfile::parser::try_parse(
+    const std::string &identifier, std::istream &input_stream,
+    const bool identifier_is_file_path /*= false*/,
+    const parse_options &options /*= parse_options{}*/) {
+  return impl::parse(identifier, input_stream, identifier_is_file_path,
+                     options);
+}
+
+std::expected<libconfigfile::node_ptr<libconfigfile::map_node>,
+              libconfigfile::parse_error>
+libconfigfile::parser::try_parse_file(
+    const char *file_path, const parse_options &options /*= parse_options{}*/) {
+  if (options.use_cache == true) {
+    return impl::parse_file_with_cache(file_path, options);
+  }
+  std::ifstream input_stream{file_path};
+  return impl::parse(file_path, input_stream, true, options);
+}
+
+std::expected<libconfigfile::node_ptr<libconfigfile::map_node>,
+              libconfigfile::parse_error>
+libconfigfile::parser::try_parse_file(
+    const std::string &file_path,
+    const parse_options &options /*= parse_options{}*/) {
+  if (options.use_cache == true) {
+    return impl::parse_file_with_cache(file_path, options);
+  }
+  std::ifstream input_stream{file_path};
+  return impl::parse(file_path, input_stream, true, options);
+}
+
+std::expected<libconfigfile::node_ptr<libconfigfile::map_node>,
+              libconfigfile::parse_error>
+libconfigfile::parser::try_parse_file(
+    const std::filesystem::path &file_path,
+    const parse_options &options /*= parse_options{}*/) {
+  if (options.use_cache == true) {
+    return impl::parse_file_with_cache(file_path, options);
+  }
+  return impl::parse_file(file_path, options);
+}
+
+std::expected<libconfigfile::node_ptr<libconfigfile::map_node>,
+              libconfigfile::parse_error>
+libconfigfile::parser::try_parse_file(
+    const std::filesystem::path &file_path,
+    std::vector<std::filesystem::path> &included_file_paths,
+    const parse_options &options /*= parse_options{}*/) {
+  if (options.use_cache == true) {
+    return impl::parse_file_with_cache(file_path, options,
+                                       &included_file_paths);
+  }
+  return impl::parse_file(file_path, options, &included_file_paths);
+}
+
+libconfigfile::parser::recovery_result
+libconfigfile::parser::parse_with_recovery(
+    const std::string &identifier, std::istream &input_stream,
+    const bool identifier_is_file_path /*= false*/,
+    const parse_options &options /*= parse_options{}*/) {
+  recovery_result ret_val{make_node_ptr<map_node>(), {}};
+  impl::parse_result<node_ptr<map_node>> root{
+      impl::parse(identifier, input_stream, identifier_is_file_path, options,
+                  nullptr, nullptr, &ret_val.errors)};
+  if (root.has_value() == true) {
+    ret_val.value = std::move(root.value());
+  } else {
+    ret_val.value->set_is_root_map(true);
+    ret_val.errors.push_back(std::move(root.error()));
+  }
+  return ret_val;
+}
+
+libconfigfile::parser::recovery_result
+libconfigfile::parser::parse_file_with_recovery(
+    const std::filesystem::path &file_path,
+    const parse_options &options /*= parse_options{}*/) {
+  recovery_result ret_val{make_node_ptr<map_node>(), {}};
+  impl::parse_result<node_ptr<map_node>> root{
+      impl::parse_file(file_path, options, nullptr, nullptr, &ret_val.errors)};
+  if (root.has_value() == true) {
+    ret_val.value = std::move(root.value());
+  } else {
+    ret_val.value->set_is_root_map(true);
+    ret_val.errors.push_back(std::move(root.error()));
+  }
+  return ret_val;
+}
+
+void libconfigfile::parser::validate(
+    const std::string &identifier, std::istream &input_stream,
+    const bool identifier_is_file_path /*= false*/,
+    const parse_options &options /*= parse_options{}*/) {
+  impl::value_or_throw(impl::parse(identifier, input_stream,
+                                   identifier_is_file_path, options, nullptr,
+                                   nullptr, nullptr, nullptr, true));
+}
+
+void libconfigfile::parser::validate_file(
+    const std::filesystem::path &file_path,
+    const parse_options &options /*= parse_options{}*/) {
+  impl::value_or_throw(impl::parse_file(file_path, options, nullptr, nullptr,
+                                        nullptr, nullptr, true));
+}
+
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::map_node>>
 libconfigfile::parser::impl::parse(
     const std::string &identifier, std::istream &input_stream,
-    const bool identifier_is_file_path /*= false*/) {
-  context ctx{identifier, input_stream, identifier_is_file_path, 1, 0};
+    const bool identifier_is_file_path, const parse_options &options,
+    std::vector<std::filesystem::path> *included_file_paths /*= nullptr*/,
+    parse_budget *budget /*= nullptr*/,
+    std::vector<parse_error> *errors /*= nullptr*/,
+    key_set *root_keys /*= nullptr*/,
+    const bool validate_only /*= false*/) {
+  parse_budget root_budget{0, 0, 0, 0};
+  if (budget == nullptr) {
+    budget = &root_budget;
+  }
+
+  if (input_stream.good() == false) {
+    const error_messages::error_message &error{
+        ((identifier_is_file_path == true) ? (error_messages::err_msg_4_1_1)
+                                           : (error_messages::err_msg_4_1_2))};
+    return std::unexpected{parse_error{error, identifier, 0, 0}};
+  } else {
+    source_streambuf source{input_stream.rdbuf()};
+    std::istream source_input_stream{&source};
+
+    const std::uint32_t file_id{((options.spans != nullptr)
+                                     ? (options.spans->add_file(identifier))
+                                     : (0))};
+
+    std::shared_ptr<lazy_document> document{};
+    if ((options.lazy_containers == true) && (validate_only == false) &&
+        (errors == nullptr)) {
+      document = std::make_shared<lazy_document>(lazy_document{
+          identifier, identifier_is_file_path, std::string{}, options});
+      document->options.deadline.reset();
+      document->options.spans = nullptr;
+      document->options.key_paths.clear();
+    }
+
+    context ctx{identifier, source_input_stream, source,
+                identifier_is_file_path, included_file_paths, options, budget,
+                errors, file_id, validate_only, false, root_keys,
+                document, 0};
+    source.set_context(&ctx);
+    parse_result<node_ptr<map_node>> ret_val{parse_root_map(ctx)};
+
+    if (document != nullptr) {
+      document->text =
+          ((options.spans != nullptr) ? (std::string{source.text()})
+                                      : (source.take_text()));
+    }
+
+    if (options.spans != nullptr) {
+      // The root map of an included file is merged into the including one
+      // and then destroyed, so only its members keep their spans.
+      if ((ret_val.has_value() == false) ||
+          ((source.error().has_value() == true) && (errors == nullptr))) {
+        options.spans->erase_files_from(file_id);
+      } else if ((ret_val.value().get() != nullptr) &&
+                 (budget->include_depth == 0)) {
+        options.spans->insert(ret_val.value().get(),
+                              source_span{file_id, 0, source.text().size()});
+      }
+      options.spans->set_file_text(file_id, source.take_text());
+    }
+
+    if ((source.error().has_value() == true) && (errors != nullptr) &&
+        (ret_val.has_value() == true)) {
+      errors->push_back(source.error().value());
+      return ret_val;
+    } else if (source.error().has_value() == true) {
+      return std::unexpected{source.error().value()};
+    } else {
+      return ret_val;
+    }
+  }
+}
+
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::map_node>>
+libconfigfile::parser::impl::parse_file(
+    const std::filesystem::path &file_path, const parse_options &options,
+    std::vector<std::filesystem::path> *included_file_paths /*= nullptr*/,
+    parse_budget *budget /*= nullptr*/,
+    std::vector<parse_error> *errors /*= nullptr*/,
+    key_set *root_keys /*= nullptr*/,
+    const bool validate_only /*= false*/) {
+  std::ifstream input_stream{file_path};
+  return parse(file_path.string(), input_stream, true, options,
+               included_file_paths, budget, errors, root_keys,
+               validate_only);
+}
+
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::map_node>>
+libconfigfile::parser::impl::parse_root_map(context &ctx) {
+  parse_result<node_ptr<map_node>> ret_val{
+      parse_map_value(ctx, "", nullptr, true)};
+  if ((ret_val.has_value() == true) && (is_validating(ctx) == false)) {
+    ret_val.value()->set_is_root_map(true);
+  }
+  return ret_val;
+}
+
+libconfigfile::node_ptr<libconfigfile::map_node>
+libconfigfile::parser::impl::value_or_throw(
+    parse_result<node_ptr<map_node>> &&result) {
+  if (result.has_value() == true) {
+    return std::move(result.value());
+  } else {
+    throw_parse_error(std::move(result.error()));
+  }
+}
 
-  if (ctx.input_stream.good() == false) {
+void libconfigfile::parser::impl::throw_parse_error(parse_error &&error) {
+  if ((error.code() == error_code::err_4_1_1) ||
+      (error.code() == error_code::err_4_1_2)) {
     throw std::runtime_error{
         std::string{} +
-        ((identifier_is_file_path) ? ("file") : ("input stream")) + " \"" +
-        ctx.identifier +
+        ((error.code() == error_code::err_4_1_1) ? ("file")
+                                                  : ("input stream")) +
+        " \"" + error.file_path() +
         "\" could not be opened for "
         "reading"};
   } else {
-    node_ptr<map_node> ret_val{parse_map_value(ctx, "", nullptr, true)};
-    ret_val->set_is_root_map(true);
-    return ret_val;
+    throw syntax_error{std::move(error)};
+  }
+}
+
+libconfigfile::parse_error libconfigfile::parser::impl::make_parse_error(
+    const context &ctx, const error_messages::error_message &error) {
+  return make_parse_error(ctx, error, ctx.source.offset());
+}
+
+libconfigfile::parse_error libconfigfile::parser::impl::make_parse_error(
+    const context &ctx, const error_messages::error_message &error,
+    const std::size_t offset) {
+  const std::pair<long long, long long> position{ctx.source.position(offset)};
+  return parse_error{error, ctx.identifier, position.first, position.second};
+}
+
+libconfigfile::parser::impl::parse_result<void>
+libconfigfile::parser::impl::count_node(context &ctx) {
+  if ((++(ctx.budget->node_count)) > ctx.options.max_node_count) {
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_3_2_1)};
+  } else {
+    return {};
+  }
+}
+
+libconfigfile::parser::impl::parse_result<void>
+libconfigfile::parser::impl::check_deadline(const context &ctx) {
+  if ((ctx.options.deadline.has_value() == true) &&
+      (std::chrono::steady_clock::now() >= ctx.options.deadline.value())) {
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_3_6_1)};
+  } else {
+    return {};
+  }
+}
+
+bool libconfigfile::parser::impl::record_error(context &ctx,
+                                               parse_error &&error) {
+  const bool is_limit_error{(error.code() >= error_code::err_3_1_1) &&
+                            (error.code() <= error_code::err_3_6_1)};
+  ctx.errors->push_back(std::move(error));
+  return ((is_limit_error == false) &&
+          (ctx.errors->size() < ctx.options.max_error_count));
+}
+
+bool libconfigfile::parser::impl::is_validating(const context &ctx) {
+  return ((ctx.validate_only == true) || (ctx.in_skipped_value == true));
+}
+
+// Applies parse_options::max_string_length to a string value, key or
+// directive operand as it is read.
+libconfigfile::parser::impl::parse_result<void>
+libconfigfile::parser::impl::check_string_length(const context &ctx,
+                                                 const std::string_view str) {
+  if (str.size() > ctx.options.max_string_length) {
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_3_5_1)};
+  }
+  return {};
+}
+
+// Called once the character terminating the value has been consumed; the span
+// ends after the last non-whitespace character before it.
+void libconfigfile::parser::impl::record_span(const context &ctx,
+                                              const node *value,
+                                              const std::size_t begin_offset) {
+  if ((ctx.options.spans == nullptr) || (value == nullptr)) {
+    return;
+  }
+
+  const std::string_view text{ctx.source.text()};
+  std::size_t end_offset{ctx.source.offset()};
+  if (end_offset > begin_offset) {
+    --end_offset;
+  }
+  while ((end_offset > begin_offset) &&
+         ((is_whitespace(text[end_offset - 1]) == true) ||
+          (text[end_offset - 1] == character_constants::k_newline))) {
+    --end_offset;
+  }
+
+  ctx.options.spans->insert(
+      value, source_span{ctx.file_id, begin_offset, end_offset});
+}
+
+void libconfigfile::parser::impl::erase_spans(const context &ctx,
+                                              const node *value) {
+  if ((ctx.options.spans == nullptr) || (value == nullptr)) {
+    return;
+  }
+
+  ctx.options.spans->erase(value);
+}
+
+libconfigfile::parser::impl::source_streambuf::source_streambuf(
+    std::streambuf *source)
+    : m_source{source}, m_ctx{nullptr}, m_buffer{}, m_text{},
+      m_newline_index{}, m_error{} {}
+
+libconfigfile::parser::impl::source_streambuf::source_streambuf(
+    const std::string_view text)
+    : m_source{nullptr}, m_ctx{nullptr}, m_buffer{}, m_text{text},
+      m_newline_index{}, m_error{} {
+  // The get area is never written through.
+  char *const data{const_cast<char *>(text.data())};
+  setg(data, data, data + text.size());
+}
+
+libconfigfile::parser::impl::source_streambuf::~source_streambuf() {}
+
+void libconfigfile::parser::impl::source_streambuf::set_context(
+    const context *ctx) {
+  m_ctx = ctx;
+}
+
+const std::optional<libconfigfile::parse_error> &
+libconfigfile::parser::impl::source_streambuf::error() const {
+  return m_error;
+}
+
+std::string_view
+libconfigfile::parser::impl::source_streambuf::text() const {
+  return ((m_source == nullptr) ? (m_text) : (std::string_view{m_buffer}));
+}
+
+std::string libconfigfile::parser::impl::source_streambuf::take_text() {
+  setg(nullptr, nullptr, nullptr);
+  return std::move(m_buffer);
+}
+
+std::size_t libconfigfile::parser::impl::source_streambuf::offset() const {
+  return static_cast<std::size_t>(gptr() - eback());
+}
+
+void libconfigfile::parser::impl::source_streambuf::rewind(
+    const std::size_t offset) {
+  setg(eback(), eback() + offset, egptr());
+}
+
+std::pair<long long, long long>
+libconfigfile::parser::impl::source_streambuf::position(
+    const std::size_t offset) const {
+  return m_newline_index.position(text(), offset);
+}
+
+long long libconfigfile::parser::impl::source_streambuf::line(
+    const std::size_t offset) const {
+  return position(offset).first;
+}
+
+libconfigfile::parser::impl::source_streambuf::int_type
+libconfigfile::parser::impl::source_streambuf::underflow() {
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  } else if ((m_error.has_value() == true) || (m_source == nullptr)) {
+    return traits_type::eof();
+  }
+
+  if (parse_result<void> deadline{check_deadline(*m_ctx)};
+      deadline.has_value() == false) {
+    m_error = std::move(deadline.error());
+    return traits_type::eof();
+  }
+
+  const std::size_t size{m_buffer.size()};
+  m_buffer.resize(size + k_chunk_size);
+  const std::streamsize read_count{
+      m_source->sgetn(m_buffer.data() + size, k_chunk_size)};
+  m_buffer.resize(size + static_cast<std::size_t>(
+                             (read_count > 0) ? (read_count) : (0)));
+  char *const data{m_buffer.data()};
+
+  if (read_count <= 0) {
+    setg(data, data + size, data + size);
+    return traits_type::eof();
+  }
+
+  m_ctx->budget->input_bytes += static_cast<std::size_t>(read_count);
+  if (m_ctx->budget->input_bytes > m_ctx->options.max_input_bytes) {
+    m_buffer.resize(size);
+    setg(data, data + size, data + size);
+    m_error = make_parse_error(*m_ctx, error_messages::err_msg_3_1_1, size);
+    return traits_type::eof();
+  }
+
+  setg(data, data + size, data + size + read_count);
+  return traits_type::to_int_type(*gptr());
+}
+
+libconfigfile::parser::impl::lazy_container::lazy_container(
+    std::shared_ptr<const lazy_document> document,
+    const std::size_t begin_offset, const node_type type,
+    const std::string_view possible_terminating_chars,
+    const std::size_t enclosing_depth)
+    : m_document{std::move(document)}, m_begin_offset{begin_offset},
+      m_type{type}, m_possible_terminating_chars{possible_terminating_chars},
+      m_enclosing_depth{enclosing_depth} {}
+
+libconfigfile::parser::impl::lazy_container::~lazy_container() {}
+
+// Errors in the value, which was only scanned for its end on the first pass,
+// are thrown from here as a syntax_error. The nesting depth is counted from
+// the root, but the node count starts again from zero.
+void libconfigfile::parser::impl::lazy_container::materialize(
+    node &target) const {
+  source_streambuf source{m_document->text};
+  std::istream source_input_stream{&source};
+  parse_budget budget{0, 0, 0, 0};
+
+  context ctx{m_document->identifier,
+              source_input_stream,
+              source,
+              m_document->identifier_is_file_path,
+              nullptr,
+              m_document->options,
+              &budget,
+              nullptr,
+              0,
+              false,
+              false,
+              nullptr,
+              m_document,
+              m_enclosing_depth};
+  source.set_context(&ctx);
+  source.rewind(m_begin_offset);
+
+  parse_result<node_ptr<node>> value{
+      parse_container_value(ctx, m_type, m_possible_terminating_chars)};
+  if (value.has_value() == false) {
+    throw syntax_error{std::move(value.error())};
+  }
+
+  if (m_type == node_type::Map) {
+    static_cast<map_node &>(target) =
+        std::move(static_cast<map_node::base_t &>(
+            static_cast<map_node &>(*(value.value()))));
+  } else {
+    static_cast<array_node &>(target) =
+        std::move(static_cast<array_node::base_t &>(
+            static_cast<array_node &>(*(value.value()))));
   }
 }
 
-std::pair<std::string, libconfigfile::node_ptr<libconfigfile::node>>
+libconfigfile::parser::impl::parse_result<
+    std::pair<std::string, libconfigfile::node_ptr<libconfigfile::node>>>
 libconfigfile::parser::impl::parse_key_value(
     context &ctx, const std::string_view possible_terminating_chars,
     char *actual_terminating_char /*= nullptr*/) {
   std::pair<std::string, node_ptr<node>> ret_val{};
 
-  ret_val.first = parse_key_value_key(ctx);
-  ret_val.second = parse_key_value_value(ctx, possible_terminating_chars,
-                                         actual_terminating_char);
+  parse_result<std::string> key{parse_key_value_key(ctx)};
+  if (key.has_value() == false) {
+    return std::unexpected{std::move(key.error())};
+  }
+  ret_val.first = std::move(key.value());
+
+  parse_result<node_ptr<node>> value{parse_key_value_value(
+      ctx, possible_terminating_chars, actual_terminating_char)};
+  if (value.has_value() == false) {
+    return std::unexpected{std::move(value.error())};
+  }
+  ret_val.second = std::move(value.value());
 
   return ret_val;
 }
 
-std::string libconfigfile::parser::impl::parse_key_value_key(context &ctx) {
+libconfigfile::parser::impl::parse_result<std::string>
+libconfigfile::parser::impl::parse_key_value_key(context &ctx) {
   std::string key_name{};
 
   enum class key_name_location {
@@ -104,35 +594,32 @@ std::string libconfigfile::parser::impl::parse_key_value_key(context &ctx) {
     equal_sign,
   };
 
-  std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-      start_of_name_proper_pos_count{};
-
   for (key_name_location last_state{key_name_location::leading_whitespace};
        last_state != key_name_location::equal_sign;) {
 
     char cur_char{};
     bool eof{false};
     bool handled_comment_in_name_proper{};
-    std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-        pos_count_before_handled_comment_in_name_proper{};
+    std::size_t offset_before_handled_comment_in_name_proper{};
+    bool skipped_newline{false};
     while (true) {
       if (last_state == key_name_location::name_proper) {
-        pos_count_before_handled_comment_in_name_proper = {ctx.line_count,
-                                                           ctx.char_count};
-        handled_comment_in_name_proper = handle_comments(ctx);
-      } else {
-        handle_comments(ctx);
+        offset_before_handled_comment_in_name_proper = ctx.source.offset();
+      }
+      parse_result<bool> comment_result{handle_comments(ctx)};
+      if (comment_result.has_value() == false) {
+        return std::unexpected{std::move(comment_result.error())};
+      } else if (last_state == key_name_location::name_proper) {
+        handled_comment_in_name_proper = comment_result.value();
       }
       ctx.input_stream.get(cur_char);
       if (ctx.input_stream.eof() == true) {
         eof = true;
         break;
       } else if (cur_char == character_constants::k_newline) {
-        ++ctx.line_count;
-        ctx.char_count = 0;
+        skipped_newline = true;
         continue;
       } else {
-        ++ctx.char_count;
         break;
       }
     }
@@ -141,14 +628,12 @@ std::string libconfigfile::parser::impl::parse_key_value_key(context &ctx) {
 
     case key_name_location::leading_whitespace: {
       if (eof == true) {
-        throw syntax_error{error_messages::err_msg_1_2_4.message,
-                           error_messages::err_msg_1_2_4.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_2_4)};
       } else {
         if (is_whitespace(cur_char)) {
           ;
         } else {
-          start_of_name_proper_pos_count = {ctx.line_count, ctx.char_count};
           last_state = key_name_location::name_proper;
 
           if (is_invalid_character_valid_provided(
@@ -156,24 +641,18 @@ std::string libconfigfile::parser::impl::parse_key_value_key(context &ctx) {
             switch (cur_char) {
 
             case character_constants::k_key_value_assign: {
-              throw syntax_error{error_messages::err_msg_1_2_4.message,
-                                 error_messages::err_msg_1_2_4.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_2_4)};
             } break;
 
             case character_constants::k_key_value_terminate: {
-              throw syntax_error{error_messages::err_msg_1_2_4.message,
-                                 error_messages::err_msg_1_2_4.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_2_4)};
             } break;
 
             default: {
-              throw syntax_error{error_messages::err_msg_1_2_1.message,
-                                 error_messages::err_msg_1_2_1.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_2_1)};
             } break;
             }
 
@@ -186,9 +665,8 @@ std::string libconfigfile::parser::impl::parse_key_value_key(context &ctx) {
 
     case key_name_location::name_proper: {
       if (eof == true) {
-        throw syntax_error{error_messages::err_msg_1_2_5.message,
-                           error_messages::err_msg_1_2_5.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_2_5)};
       } else {
         if (is_whitespace(cur_char) == true) {
           last_state = key_name_location::trailing_whitespace;
@@ -196,29 +674,22 @@ std::string libconfigfile::parser::impl::parse_key_value_key(context &ctx) {
           if (cur_char == character_constants::k_key_value_assign) {
             last_state = key_name_location::equal_sign;
           } else if (cur_char == character_constants::k_key_value_terminate) {
-            throw syntax_error{error_messages::err_msg_1_2_5.message,
-                               error_messages::err_msg_1_2_5.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_2_5)};
           } else {
-            if (start_of_name_proper_pos_count.first != ctx.line_count) {
-              throw syntax_error{error_messages::err_msg_1_2_3.message,
-                                 error_messages::err_msg_1_2_3.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+            if (skipped_newline == true) {
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_2_3)};
             } else if (handled_comment_in_name_proper == true) {
-              throw syntax_error{
-                  error_messages::err_msg_1_2_2.message,
-                  error_messages::err_msg_1_2_2.category, ctx.identifier,
-                  pos_count_before_handled_comment_in_name_proper.first,
-                  pos_count_before_handled_comment_in_name_proper.second};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_2_2,
+                  offset_before_handled_comment_in_name_proper)};
             } else {
               if (is_invalid_character_valid_provided(
                       cur_char, character_constants::k_valid_name_chars) ==
                   true) {
-                throw syntax_error{error_messages::err_msg_1_2_1.message,
-                                   error_messages::err_msg_1_2_1.category,
-                                   ctx.identifier, ctx.line_count,
-                                   ctx.char_count};
+                return std::unexpected{make_parse_error(
+                    ctx, error_messages::err_msg_1_2_1)};
               } else {
                 key_name.push_back(cur_char);
               }
@@ -230,9 +701,8 @@ std::string libconfigfile::parser::impl::parse_key_value_key(context &ctx) {
 
     case key_name_location::trailing_whitespace: {
       if (eof == true) {
-        throw syntax_error{error_messages::err_msg_1_2_5.message,
-                           error_messages::err_msg_1_2_5.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_2_5)};
       } else {
         if (is_whitespace(cur_char) == true) {
           ;
@@ -241,15 +711,11 @@ std::string libconfigfile::parser::impl::parse_key_value_key(context &ctx) {
             last_state = key_name_location::equal_sign;
           } else {
             if (cur_char == character_constants::k_key_value_terminate) {
-              throw syntax_error{error_messages::err_msg_1_2_5.message,
-                                 error_messages::err_msg_1_2_5.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_2_5)};
             } else {
-              throw syntax_error{error_messages::err_msg_1_2_5.message,
-                                 error_messages::err_msg_1_2_5.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_2_5)};
             }
           }
         }
@@ -260,15 +726,34 @@ std::string libconfigfile::parser::impl::parse_key_value_key(context &ctx) {
       throw bits_and_bytes::unreachable_error{};
     } break;
     }
+
+    if (parse_result<void> checked{check_string_length(ctx, key_name)};
+        checked.has_value() == false) {
+      return std::unexpected{std::move(checked.error())};
+    }
   }
 
   return key_name;
 }
 
-libconfigfile::node_ptr<libconfigfile::node>
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::node>>
 libconfigfile::parser::impl::parse_key_value_value(
     context &ctx, const std::string_view possible_terminating_chars,
     char *actual_terminating_char /*= nullptr*/) {
+  if (parse_result<void> skipped{skip_to_key_value_value(
+          ctx, possible_terminating_chars, actual_terminating_char)};
+      skipped.has_value() == false) {
+    return std::unexpected{std::move(skipped.error())};
+  }
+  return call_appropriate_value_parse_func(ctx, possible_terminating_chars,
+                                           actual_terminating_char);
+}
+
+libconfigfile::parser::impl::parse_result<void>
+libconfigfile::parser::impl::skip_to_key_value_value(
+    context &ctx, const std::string_view possible_terminating_chars,
+    char *actual_terminating_char /*= nullptr*/) {
   bool first_loop{true};
   char cur_char{};
 
@@ -276,25 +761,24 @@ libconfigfile::parser::impl::parse_key_value_value(
 
     bool eof{false};
     while (true) {
-      handle_comments(ctx);
+      if (parse_result<bool> comment_result{handle_comments(ctx)};
+          comment_result.has_value() == false) {
+        return std::unexpected{std::move(comment_result.error())};
+      }
       ctx.input_stream.get(cur_char);
       if (ctx.input_stream.eof() == true) {
         eof = true;
         break;
       } else if (cur_char == character_constants::k_newline) {
-        ++ctx.line_count;
-        ctx.char_count = 0;
         continue;
       } else {
-        ++ctx.char_count;
         break;
       }
     }
 
     if (eof == true) {
-      throw syntax_error{error_messages::err_msg_1_2_5.message,
-                         error_messages::err_msg_1_2_5.category, ctx.identifier,
-                         ctx.line_count, ctx.char_count};
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_2_5)};
     } else if (is_whitespace(cur_char) == true) {
       continue;
     } else if ((cur_char == character_constants::k_key_value_assign) &&
@@ -305,19 +789,17 @@ libconfigfile::parser::impl::parse_key_value_value(
       if (actual_terminating_char != nullptr) {
         *actual_terminating_char = cur_char;
       };
-      throw syntax_error{error_messages::err_msg_1_2_5.message,
-                         error_messages::err_msg_1_2_5.category, ctx.identifier,
-                         ctx.line_count, ctx.char_count};
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_2_5)};
     } else {
       ctx.input_stream.unget();
-      --ctx.char_count;
-      return call_appropriate_value_parse_func(ctx, possible_terminating_chars,
-                                               actual_terminating_char);
+      return {};
     }
   }
 }
 
-libconfigfile::node_ptr<libconfigfile::string_node>
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::string_node>>
 libconfigfile::parser::impl::parse_string_value(
     context &ctx, const std::string_view possible_terminating_chars,
     char *actual_terminating_char /*= nullptr*/) {
@@ -325,56 +807,61 @@ libconfigfile::parser::impl::parse_string_value(
 
   std::string string_contents{};
 
-  std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-      last_opening_delimiter_pos_count{};
-
   for (;;) {
     char cur_char{};
     bool eof{false};
+    bool skipped_newline{false};
     while (true) {
       if (in_string == false) {
-        handle_comments(ctx);
+        if (parse_result<bool> comment_result{handle_comments(ctx)};
+            comment_result.has_value() == false) {
+          return std::unexpected{std::move(comment_result.error())};
+        }
       }
       ctx.input_stream.get(cur_char);
       if (ctx.input_stream.eof() == true) {
         eof = true;
         break;
       } else if (cur_char == character_constants::k_newline) {
-        ++ctx.line_count;
-        ctx.char_count = 0;
+        skipped_newline = true;
         continue;
       } else {
-        ++ctx.char_count;
         break;
       }
     }
 
     if (eof == true) {
       if (in_string == true) {
-        throw syntax_error{error_messages::err_msg_1_3_3.message,
-                           error_messages::err_msg_1_3_3.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_3_3)};
       } else {
-        throw syntax_error{error_messages::err_msg_1_2_6.message,
-                           error_messages::err_msg_1_2_6.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_2_6)};
       }
     } else {
       if (in_string == true) {
-        if (last_opening_delimiter_pos_count.first != ctx.line_count) {
-          throw syntax_error{error_messages::err_msg_1_3_2.message,
-                             error_messages::err_msg_1_3_2.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+        if (skipped_newline == true) {
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_3_2)};
         } else {
           if (cur_char == character_constants::k_string_delimiter) {
             in_string = false;
           } else if (cur_char == character_constants::k_escape_leader) {
             ctx.input_stream.unget();
-            --ctx.char_count;
-            string_contents.push_back(handle_escape_sequence(ctx));
+            const parse_result<char> escaped_char{handle_escape_sequence(ctx)};
+            if (escaped_char.has_value() == false) {
+              return std::unexpected{escaped_char.error()};
+            }
+            string_contents.push_back(escaped_char.value());
           } else {
             string_contents.push_back(cur_char);
           }
+
+          if (parse_result<void> checked{
+                  check_string_length(ctx, string_contents)};
+              checked.has_value() == false) {
+            return std::unexpected{std::move(checked.error())};
+          }
         }
       } else {
         if (possible_terminating_chars.find(cur_char) != std::string::npos) {
@@ -387,26 +874,26 @@ libconfigfile::parser::impl::parse_string_value(
                    true) {
         } else if (cur_char == character_constants::k_string_delimiter) {
           in_string = true;
-          last_opening_delimiter_pos_count = {ctx.line_count, ctx.char_count};
         } else {
-          throw syntax_error{error_messages::err_msg_1_3_1.message,
-                             error_messages::err_msg_1_3_1.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_3_1)};
         }
       }
     }
   }
 
   if (in_string == true) {
-    throw syntax_error{error_messages::err_msg_1_3_3.message,
-                       error_messages::err_msg_1_3_3.category, ctx.identifier,
-                       ctx.line_count, ctx.char_count};
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_1_3_3)};
+  } else if (is_validating(ctx) == true) {
+    return node_ptr<string_node>{nullptr};
   } else {
     return make_node_ptr<string_node>(std::move(string_contents));
   }
 }
 
-libconfigfile::node_ptr<libconfigfile::integer_node>
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::integer_node>>
 libconfigfile::parser::impl::parse_integer_value(
     context &ctx, const std::string_view possible_terminating_chars,
     char *actual_terminating_char /*= nullptr*/) {
@@ -416,8 +903,7 @@ libconfigfile::parser::impl::parse_integer_value(
   bool is_negative{false};
   const numeral_system *num_sys{nullptr};
 
-  const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-      pos_count_at_start{ctx.line_count, ctx.char_count};
+  const std::size_t offset_at_start{ctx.source.offset()};
 
   bool last_char_was_digit{false};
   bool any_digits_so_far{false};
@@ -429,7 +915,8 @@ libconfigfile::parser::impl::parse_integer_value(
 
   const auto default_char_behavior{
       [&ctx, &num_sys, &cur_char, &last_char_was_digit, &any_digits_so_far,
-       &last_char_was_leading_zero, &actual_digits]() {
+       &last_char_was_leading_zero,
+       &actual_digits]() -> parse_result<void> {
         if (num_sys == nullptr) {
           num_sys = &numeral_system_decimal;
         }
@@ -439,12 +926,12 @@ libconfigfile::parser::impl::parse_integer_value(
           any_digits_so_far = true;
           last_char_was_leading_zero = false;
           actual_digits.push_back(cur_char);
+          return {};
         } else {
           last_char_was_digit = false;
           last_char_was_leading_zero = false;
-          throw syntax_error{error_messages::err_msg_1_4_1.message,
-                             error_messages::err_msg_1_4_1.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_4_1)};
         }
       }};
 
@@ -452,59 +939,56 @@ libconfigfile::parser::impl::parse_integer_value(
   for (;; first_loop = false) {
     bool eof{false};
     bool handled_comment{};
-    std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-        pos_count_before_handled_comment{};
+    std::size_t offset_before_handled_comment{};
+    bool skipped_newline{false};
     while (true) {
-      pos_count_before_handled_comment = {ctx.line_count, ctx.char_count};
-      handled_comment = handle_comments(ctx);
+      offset_before_handled_comment = ctx.source.offset();
+      parse_result<bool> comment_result{handle_comments(ctx)};
+      if (comment_result.has_value() == false) {
+        return std::unexpected{std::move(comment_result.error())};
+      }
+      handled_comment = comment_result.value();
       ctx.input_stream.get(cur_char);
       if (ctx.input_stream.eof() == true) {
         eof = true;
         break;
       } else if (cur_char == character_constants::k_newline) {
-        ++ctx.line_count;
-        ctx.char_count = 0;
+        skipped_newline = true;
         continue;
       } else {
-        ++ctx.char_count;
         break;
       }
     }
 
     if (eof == true) {
-      throw syntax_error{error_messages::err_msg_1_2_6.message,
-                         error_messages::err_msg_1_2_6.category, ctx.identifier,
-                         ctx.line_count, ctx.char_count};
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_2_6)};
     } else if (possible_terminating_chars.find(cur_char) != std::string::npos) {
       if (actual_terminating_char != nullptr) {
         *actual_terminating_char = cur_char;
       };
       break;
-    } else if (pos_count_at_start.first != ctx.line_count) {
-      throw syntax_error{error_messages::err_msg_1_4_4.message,
-                         error_messages::err_msg_1_4_4.category, ctx.identifier,
-                         ctx.line_count, ctx.char_count};
+    } else if (skipped_newline == true) {
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_4_4)};
     } else if (handled_comment == true) {
-      throw syntax_error{error_messages::err_msg_1_4_3.message,
-                         error_messages::err_msg_1_4_3.category, ctx.identifier,
-                         pos_count_before_handled_comment.first,
-                         pos_count_before_handled_comment.second};
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_4_3,
+                                              offset_before_handled_comment)};
     } else if ((is_whitespace(cur_char) == true) &&
                (in_trailing_whitespace == false)) {
       in_trailing_whitespace = true;
     } else if ((is_whitespace(cur_char) == false) &&
                (in_trailing_whitespace == true)) {
-      throw syntax_error{error_messages::err_msg_1_4_9.message,
-                         error_messages::err_msg_1_4_9.category, ctx.identifier,
-                         ctx.line_count, ctx.char_count};
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_4_9)};
     } else {
       switch (cur_char) {
       case character_constants::k_num_digit_separator: {
         if ((last_char_was_digit == false) ||
             (ctx.input_stream.peek() == std::istream::traits_type::eof())) {
-          throw syntax_error{error_messages::err_msg_1_4_2.message,
-                             error_messages::err_msg_1_4_2.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_4_2)};
         } else {
           last_char_was_digit = false;
           last_char_was_leading_zero = false;
@@ -517,9 +1001,8 @@ libconfigfile::parser::impl::parse_integer_value(
           last_char_was_digit = false;
           last_char_was_leading_zero = false;
         } else {
-          throw syntax_error{error_messages::err_msg_1_4_8.message,
-                             error_messages::err_msg_1_4_8.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_4_8)};
         }
       } break;
 
@@ -529,9 +1012,8 @@ libconfigfile::parser::impl::parse_integer_value(
           last_char_was_digit = false;
           last_char_was_leading_zero = false;
         } else {
-          throw syntax_error{error_messages::err_msg_1_4_6.message,
-                             error_messages::err_msg_1_4_6.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_4_6)};
         }
       } break;
 
@@ -559,24 +1041,22 @@ libconfigfile::parser::impl::parse_integer_value(
 
                 num_sys = &numeral_system_binary;
               } else {
-                throw syntax_error{error_messages::err_msg_1_4_7.message,
-                                   error_messages::err_msg_1_4_7.category,
-                                   ctx.identifier, ctx.line_count,
-                                   ctx.char_count};
+                return std::unexpected{make_parse_error(
+                    ctx, error_messages::err_msg_1_4_7)};
               }
             } else {
-              throw syntax_error{error_messages::err_msg_1_4_1.message,
-                                 error_messages::err_msg_1_4_1.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_4_1)};
             }
           } else {
-            throw syntax_error{error_messages::err_msg_1_4_7.message,
-                               error_messages::err_msg_1_4_7.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_4_7)};
           }
         } else {
-          default_char_behavior();
+          if (parse_result<void> digit_result{default_char_behavior()};
+              digit_result.has_value() == false) {
+            return std::unexpected{std::move(digit_result.error())};
+          }
         }
       } break;
 
@@ -591,24 +1071,22 @@ libconfigfile::parser::impl::parse_integer_value(
 
                 num_sys = &numeral_system_octal;
               } else {
-                throw syntax_error{error_messages::err_msg_1_4_7.message,
-                                   error_messages::err_msg_1_4_7.category,
-                                   ctx.identifier, ctx.line_count,
-                                   ctx.char_count};
+                return std::unexpected{make_parse_error(
+                    ctx, error_messages::err_msg_1_4_7)};
               }
             } else {
-              throw syntax_error{error_messages::err_msg_1_4_1.message,
-                                 error_messages::err_msg_1_4_1.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_4_1)};
             }
           } else {
-            throw syntax_error{error_messages::err_msg_1_4_7.message,
-                               error_messages::err_msg_1_4_7.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_4_7)};
           }
         } else {
-          default_char_behavior();
+          if (parse_result<void> digit_result{default_char_behavior()};
+              digit_result.has_value() == false) {
+            return std::unexpected{std::move(digit_result.error())};
+          }
         }
       } break;
 
@@ -623,29 +1101,30 @@ libconfigfile::parser::impl::parse_integer_value(
 
                 num_sys = &numeral_system_hexadecimal;
               } else {
-                throw syntax_error{error_messages::err_msg_1_4_7.message,
-                                   error_messages::err_msg_1_4_7.category,
-                                   ctx.identifier, ctx.line_count,
-                                   ctx.char_count};
+                return std::unexpected{make_parse_error(
+                    ctx, error_messages::err_msg_1_4_7)};
               }
             } else {
-              throw syntax_error{error_messages::err_msg_1_4_1.message,
-                                 error_messages::err_msg_1_4_1.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_4_1)};
             }
           } else {
-            throw syntax_error{error_messages::err_msg_1_4_7.message,
-                               error_messages::err_msg_1_4_7.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_4_7)};
           }
         } else {
-          default_char_behavior();
+          if (parse_result<void> digit_result{default_char_behavior()};
+              digit_result.has_value() == false) {
+            return std::unexpected{std::move(digit_result.error())};
+          }
         }
       } break;
 
       default: {
-        default_char_behavior();
+        if (parse_result<void> digit_result{default_char_behavior()};
+            digit_result.has_value() == false) {
+          return std::unexpected{std::move(digit_result.error())};
+        }
       } break;
       }
     }
@@ -664,11 +1143,12 @@ libconfigfile::parser::impl::parse_integer_value(
   integer_node::base_t ret_val_value_buf{};
   if (std::from_chars(actual_digits.data(),
                       actual_digits.data() + actual_digits.size(),
-                      ret_val_value_buf)
+                      ret_val_value_buf, num_sys->base)
           .ec == std::errc::result_out_of_range) {
-    throw syntax_error{error_messages::err_msg_1_4_5.message,
-                       error_messages::err_msg_1_4_5.category, ctx.identifier,
-                       pos_count_at_start.first, pos_count_at_start.second};
+    return std::unexpected{make_parse_error(ctx, error_messages::err_msg_1_4_5,
+                                            offset_at_start)};
+  } else if (is_validating(ctx) == true) {
+    return ret_val;
   } else {
     ret_val = make_node_ptr<integer_node>(ret_val_value_buf, num_sys);
   }
@@ -680,15 +1160,13 @@ libconfigfile::parser::impl::parse_integer_value(
   return ret_val;
 }
 
-libconfigfile::node_ptr<libconfigfile::float_node>
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::float_node>>
 libconfigfile::parser::impl::parse_float_value(
     context &ctx, const std::string_view possible_terminating_chars,
     char *actual_terminating_char /*= nullptr*/) {
   std::string sanitized_string{};
 
-  const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-      pos_count_at_start{ctx.line_count, ctx.char_count};
-
   static const std::unordered_map<std::string, float_node::base_t>
       k_special_floats{{character_constants::k_float_infinity.second,
                         character_constants::k_float_infinity.first},
@@ -733,51 +1211,49 @@ libconfigfile::parser::impl::parse_float_value(
     char cur_char{};
     bool eof{false};
     bool handled_comment{};
-    std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-        pos_count_before_handled_comment{};
+    std::size_t offset_before_handled_comment{};
+    bool skipped_newline{false};
     while (true) {
-      pos_count_before_handled_comment = {ctx.line_count, ctx.char_count};
-      handled_comment = handle_comments(ctx);
+      offset_before_handled_comment = ctx.source.offset();
+      parse_result<bool> comment_result{handle_comments(ctx)};
+      if (comment_result.has_value() == false) {
+        return std::unexpected{std::move(comment_result.error())};
+      }
+      handled_comment = comment_result.value();
       ctx.input_stream.get(cur_char);
       if (ctx.input_stream.eof() == true) {
         eof = true;
         break;
       } else if (cur_char == character_constants::k_newline) {
-        ++ctx.line_count;
-        ctx.char_count = 0;
+        skipped_newline = true;
         continue;
       } else {
-        ++ctx.char_count;
         break;
       }
     }
 
     if (eof == true) {
-      throw syntax_error{error_messages::err_msg_1_2_6.message,
-                         error_messages::err_msg_1_2_6.category, ctx.identifier,
-                         ctx.line_count, ctx.char_count};
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_2_6)};
     } else if (possible_terminating_chars.find(cur_char) != std::string::npos) {
       if (actual_terminating_char != nullptr) {
         *actual_terminating_char = cur_char;
       };
       break;
-    } else if (pos_count_at_start.first != ctx.line_count) {
-      throw syntax_error{error_messages::err_msg_1_5_9.message,
-                         error_messages::err_msg_1_5_9.category, ctx.identifier,
-                         ctx.line_count, ctx.char_count};
+    } else if (skipped_newline == true) {
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_5_9)};
     } else if (handled_comment == true) {
-      throw syntax_error{error_messages::err_msg_1_5_8.message,
-                         error_messages::err_msg_1_5_8.category, ctx.identifier,
-                         pos_count_before_handled_comment.first,
-                         pos_count_before_handled_comment.second};
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_5_8,
+                                              offset_before_handled_comment)};
     } else if ((is_whitespace(cur_char) == true) &&
                (in_trailing_whitespace == false)) {
       in_trailing_whitespace = true;
     } else if ((is_whitespace(cur_char) == false) &&
                (in_trailing_whitespace == true)) {
-      throw syntax_error{error_messages::err_msg_1_5_13.message,
-                         error_messages::err_msg_1_5_13.category,
-                         ctx.identifier, ctx.line_count, ctx.char_count};
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_5_13)};
     } else {
 
       switch (cur_location) {
@@ -789,9 +1265,8 @@ libconfigfile::parser::impl::parse_float_value(
             character_constants::k_float_infinity.second.front()>():
         case libconfigfile::toupper<
             character_constants::k_float_infinity.second.front()>(): {
-          const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-              pos_count_at_start_of_special_float{ctx.line_count,
-                                                  ctx.char_count};
+          const std::size_t offset_at_start_of_special_float{
+              ctx.source.offset()};
 
           if ((last_char == char_type::start) ||
               (last_char == char_type::positive) ||
@@ -803,25 +1278,23 @@ libconfigfile::parser::impl::parse_float_value(
 
             while (true) {
               while (true) {
-                handle_comments(ctx);
+                if (parse_result<bool> comment_result{handle_comments(ctx)};
+                    comment_result.has_value() == false) {
+                  return std::unexpected{std::move(comment_result.error())};
+                }
                 ctx.input_stream.get(cur_char);
                 if (ctx.input_stream.eof() == true) {
                   eof = true;
                   break;
                 } else if (cur_char == character_constants::k_newline) {
-                  ++ctx.line_count;
-                  ctx.char_count = 0;
                   continue;
                 } else {
-                  ++ctx.char_count;
                   break;
                 }
               }
               if (eof == true) {
-                throw syntax_error{error_messages::err_msg_1_2_6.message,
-                                   error_messages::err_msg_1_2_6.category,
-                                   ctx.identifier, ctx.line_count,
-                                   ctx.char_count};
+                return std::unexpected{make_parse_error(
+                    ctx, error_messages::err_msg_1_2_6)};
               } else if (possible_terminating_chars.find(cur_char) !=
                          std::string::npos) {
                 if (actual_terminating_char != nullptr) {
@@ -838,7 +1311,9 @@ libconfigfile::parser::impl::parse_float_value(
                     character_constants::k_float_infinity.second) == true) {
               node_ptr<float_node> ret_val{nullptr};
 
-              if (last_char == char_type::negative) {
+              if (is_validating(ctx) == true) {
+                return ret_val;
+              } else if (last_char == char_type::negative) {
                 ret_val = make_node_ptr<float_node>(
                     -(character_constants::k_float_infinity.first));
               } else {
@@ -848,18 +1323,14 @@ libconfigfile::parser::impl::parse_float_value(
 
               return ret_val;
             } else {
-              throw syntax_error{error_messages::err_msg_1_5_1.message,
-                                 error_messages::err_msg_1_5_1.category,
-                                 ctx.identifier,
-                                 pos_count_at_start_of_special_float.first,
-                                 pos_count_at_start_of_special_float.second};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_5_1,
+                  offset_at_start_of_special_float)};
             }
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_1.message,
-                               error_messages::err_msg_1_5_1.category,
-                               ctx.identifier,
-                               pos_count_at_start_of_special_float.first,
-                               pos_count_at_start_of_special_float.second};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_1,
+                offset_at_start_of_special_float)};
           }
         } break;
 
@@ -867,9 +1338,8 @@ libconfigfile::parser::impl::parse_float_value(
             character_constants::k_float_not_a_number.second.front()>():
         case libconfigfile::toupper<
             character_constants::k_float_not_a_number.second.front()>(): {
-          const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-              pos_count_at_start_of_special_float{ctx.line_count,
-                                                  ctx.char_count};
+          const std::size_t offset_at_start_of_special_float{
+              ctx.source.offset()};
 
           if ((last_char == char_type::start) ||
               (last_char == char_type::positive) ||
@@ -881,25 +1351,23 @@ libconfigfile::parser::impl::parse_float_value(
 
             while (true) {
               while (true) {
-                handle_comments(ctx);
+                if (parse_result<bool> comment_result{handle_comments(ctx)};
+                    comment_result.has_value() == false) {
+                  return std::unexpected{std::move(comment_result.error())};
+                }
                 ctx.input_stream.get(cur_char);
                 if (ctx.input_stream.eof() == true) {
                   eof = true;
                   break;
                 } else if (cur_char == character_constants::k_newline) {
-                  ++ctx.line_count;
-                  ctx.char_count = 0;
                   continue;
                 } else {
-                  ++ctx.char_count;
                   break;
                 }
               }
               if (eof == true) {
-                throw syntax_error{error_messages::err_msg_1_2_6.message,
-                                   error_messages::err_msg_1_2_6.category,
-                                   ctx.identifier, ctx.line_count,
-                                   ctx.char_count};
+                return std::unexpected{make_parse_error(
+                    ctx, error_messages::err_msg_1_2_6)};
               } else if (possible_terminating_chars.find(cur_char) !=
                          std::string::npos) {
                 if (actual_terminating_char != nullptr) {
@@ -916,7 +1384,9 @@ libconfigfile::parser::impl::parse_float_value(
                     character_constants::k_float_not_a_number.second) == true) {
               node_ptr<float_node> ret_val{nullptr};
 
-              if (last_char == char_type::negative) {
+              if (is_validating(ctx) == true) {
+                return ret_val;
+              } else if (last_char == char_type::negative) {
                 ret_val = make_node_ptr<float_node>(
                     -(character_constants::k_float_not_a_number.first));
               } else {
@@ -926,18 +1396,14 @@ libconfigfile::parser::impl::parse_float_value(
 
               return ret_val;
             } else {
-              throw syntax_error{error_messages::err_msg_1_5_1.message,
-                                 error_messages::err_msg_1_5_1.category,
-                                 ctx.identifier,
-                                 pos_count_at_start_of_special_float.first,
-                                 pos_count_at_start_of_special_float.second};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_5_1,
+                  offset_at_start_of_special_float)};
             }
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_1.message,
-                               error_messages::err_msg_1_5_1.category,
-                               ctx.identifier,
-                               pos_count_at_start_of_special_float.first,
-                               pos_count_at_start_of_special_float.second};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_1,
+                offset_at_start_of_special_float)};
           }
         } break;
 
@@ -946,9 +1412,8 @@ libconfigfile::parser::impl::parse_float_value(
             last_char = char_type::positive;
             sanitized_string.push_back(cur_char);
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_12.message,
-                               error_messages::err_msg_1_5_12.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_12)};
           }
         } break;
 
@@ -957,9 +1422,8 @@ libconfigfile::parser::impl::parse_float_value(
             last_char = char_type::negative;
             sanitized_string.push_back(cur_char);
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_11.message,
-                               error_messages::err_msg_1_5_11.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_11)};
           }
         } break;
 
@@ -969,15 +1433,12 @@ libconfigfile::parser::impl::parse_float_value(
                     static_cast<char>(ctx.input_stream.peek()))) {
               last_char = char_type::separator;
             } else {
-              throw syntax_error{error_messages::err_msg_1_5_6.message,
-                                 error_messages::err_msg_1_5_6.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_5_6)};
             }
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_6.message,
-                               error_messages::err_msg_1_5_6.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_6)};
           }
         } break;
 
@@ -989,15 +1450,12 @@ libconfigfile::parser::impl::parse_float_value(
               cur_location = num_location::fractional;
               sanitized_string.push_back(cur_char);
             } else {
-              throw syntax_error{error_messages::err_msg_1_5_5.message,
-                                 error_messages::err_msg_1_5_5.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_5_5)};
             }
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_5.message,
-                               error_messages::err_msg_1_5_5.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_5)};
           }
         } break;
 
@@ -1012,15 +1470,12 @@ libconfigfile::parser::impl::parse_float_value(
               cur_location = num_location::exponent;
               sanitized_string.push_back(cur_char);
             } else {
-              throw syntax_error{error_messages::err_msg_1_5_7.message,
-                                 error_messages::err_msg_1_5_7.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_5_7)};
             }
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_7.message,
-                               error_messages::err_msg_1_5_7.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_7)};
           }
         } break;
 
@@ -1029,9 +1484,8 @@ libconfigfile::parser::impl::parse_float_value(
             last_char = char_type::digit;
             sanitized_string.push_back(cur_char);
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_1.message,
-                               error_messages::err_msg_1_5_1.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_1)};
           }
         } break;
         }
@@ -1041,15 +1495,13 @@ libconfigfile::parser::impl::parse_float_value(
         switch (cur_char) {
 
         case character_constants::k_num_positive_sign: {
-          throw syntax_error{error_messages::err_msg_1_5_12.message,
-                             error_messages::err_msg_1_5_12.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_5_12)};
         } break;
 
         case character_constants::k_num_negative_sign: {
-          throw syntax_error{error_messages::err_msg_1_5_11.message,
-                             error_messages::err_msg_1_5_11.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_5_11)};
         } break;
 
         case character_constants::k_num_digit_separator: {
@@ -1058,22 +1510,18 @@ libconfigfile::parser::impl::parse_float_value(
                     static_cast<char>(ctx.input_stream.peek()))) {
               last_char = char_type::separator;
             } else {
-              throw syntax_error{error_messages::err_msg_1_5_6.message,
-                                 error_messages::err_msg_1_5_6.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_5_6)};
             }
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_6.message,
-                               error_messages::err_msg_1_5_6.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_6)};
           }
         } break;
 
         case character_constants::k_float_decimal_point: {
-          throw syntax_error{error_messages::err_msg_1_5_2.message,
-                             error_messages::err_msg_1_5_2.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_5_2)};
         } break;
 
         case character_constants::k_float_exponent_sign_lower:
@@ -1087,15 +1535,12 @@ libconfigfile::parser::impl::parse_float_value(
               cur_location = num_location::exponent;
               sanitized_string.push_back(cur_char);
             } else {
-              throw syntax_error{error_messages::err_msg_1_5_7.message,
-                                 error_messages::err_msg_1_5_7.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_5_7)};
             }
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_7.message,
-                               error_messages::err_msg_1_5_7.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_7)};
           }
         } break;
 
@@ -1104,9 +1549,8 @@ libconfigfile::parser::impl::parse_float_value(
             last_char = char_type::digit;
             sanitized_string.push_back(cur_char);
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_1.message,
-                               error_messages::err_msg_1_5_1.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_1)};
           }
         } break;
         }
@@ -1120,9 +1564,8 @@ libconfigfile::parser::impl::parse_float_value(
             last_char = char_type::positive;
             sanitized_string.push_back(cur_char);
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_12.message,
-                               error_messages::err_msg_1_5_12.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_12)};
           }
         } break;
 
@@ -1131,9 +1574,8 @@ libconfigfile::parser::impl::parse_float_value(
             last_char = char_type::positive;
             sanitized_string.push_back(cur_char);
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_11.message,
-                               error_messages::err_msg_1_5_11.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_11)};
           }
         } break;
 
@@ -1143,29 +1585,24 @@ libconfigfile::parser::impl::parse_float_value(
                     static_cast<char>(ctx.input_stream.peek()))) {
               last_char = char_type::separator;
             } else {
-              throw syntax_error{error_messages::err_msg_1_5_6.message,
-                                 error_messages::err_msg_1_5_6.category,
-                                 ctx.identifier, ctx.line_count,
-                                 ctx.char_count};
+              return std::unexpected{make_parse_error(
+                  ctx, error_messages::err_msg_1_5_6)};
             }
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_6.message,
-                               error_messages::err_msg_1_5_6.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_6)};
           }
         } break;
 
         case character_constants::k_float_decimal_point: {
-          throw syntax_error{error_messages::err_msg_1_5_4.message,
-                             error_messages::err_msg_1_5_4.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_5_4)};
         } break;
 
         case character_constants::k_float_exponent_sign_lower:
         case character_constants::k_float_exponent_sign_upper: {
-          throw syntax_error{error_messages::err_msg_1_5_3.message,
-                             error_messages::err_msg_1_5_3.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_5_3)};
         } break;
 
         default: {
@@ -1173,9 +1610,8 @@ libconfigfile::parser::impl::parse_float_value(
             last_char = char_type::digit;
             sanitized_string.push_back(cur_char);
           } else {
-            throw syntax_error{error_messages::err_msg_1_5_1.message,
-                               error_messages::err_msg_1_5_1.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_5_1)};
           }
         } break;
         }
@@ -1198,382 +1634,1054 @@ libconfigfile::parser::impl::parse_float_value(
                       sanitized_string.data() + sanitized_string.size(),
                       ret_val_value_buf)
           .ec == std::errc::result_out_of_range) {
-    throw syntax_error{error_messages::err_msg_1_5_10.message,
-                       error_messages::err_msg_1_5_10.category, ctx.identifier,
-                       ctx.line_count, ctx.char_count};
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_1_5_10)};
 
-  } else {
+  } else if (is_validating(ctx) == false) {
     ret_val = make_node_ptr<float_node>(ret_val_value_buf);
   }
 
   return ret_val;
 }
 
-libconfigfile::node_ptr<libconfigfile::array_node>
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::array_node>>
 libconfigfile::parser::impl::parse_array_value(
     context &ctx, const std::string_view possible_terminating_chars,
     char *actual_terminating_char /*= nullptr*/) {
-  node_ptr<libconfigfile::array_node> ret_val{make_node_ptr<array_node>()};
+  parse_result<node_ptr<node>> value{parse_container_value(
+      ctx, node_type::Array, possible_terminating_chars,
+      actual_terminating_char)};
+  if (value.has_value() == false) {
+    return std::unexpected{std::move(value.error())};
+  }
+  return node_ptr_cast<array_node>(std::move(value.value()));
+}
+
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::map_node>>
+libconfigfile::parser::impl::parse_map_value(
+    context &ctx, const std::string_view possible_terminating_chars,
+    char *actual_terminating_char /*= nullptr*/,
+    const bool is_root_map /*= false*/) {
+  parse_result<node_ptr<node>> value{
+      parse_container_value(ctx, node_type::Map, possible_terminating_chars,
+                            actual_terminating_char, is_root_map)};
+  if (value.has_value() == false) {
+    return std::unexpected{std::move(value.error())};
+  }
+  return node_ptr_cast<map_node>(std::move(value.value()));
+}
 
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::node>>
+libconfigfile::parser::impl::parse_container_value(
+    context &ctx, const node_type type,
+    const std::string_view possible_terminating_chars,
+    char *actual_terminating_char /*= nullptr*/,
+    const bool is_root_map /*= false*/) {
+  static constexpr std::string_view k_possible_terminating_chars_for_members{
+      &character_constants::k_key_value_terminate, 1};
   static const std::string k_possible_terminating_chars_for_elements{
       std::string{} + character_constants::k_array_element_separator +
       character_constants::k_array_closing_delimiter};
 
-  enum class char_type {
-    leading_whitespace,
-    opening_delimiter,
-    element_separator,
-    closing_delimiter,
-  };
+  const auto make_frame{[&ctx](const node_type frame_type,
+                               const std::string_view frame_terminating_chars,
+                               const bool frame_is_root_map,
+                               const key_path_filter frame_filter,
+                               std::string frame_key_path) {
+    return container_frame{
+        ((is_validating(ctx) == true)
+             ? (node_ptr<node>{nullptr})
+             : ((frame_type == node_type::Map)
+                    ? (node_ptr<node>{make_node_ptr<map_node>()})
+                    : (node_ptr<node>{make_node_ptr<array_node>()}))),
+        ctx.source.offset(),
+        frame_terminating_chars,
+        std::string{},
+        {},
+        key_set{},
+        frame_filter,
+        key_path_filter::keep,
+        std::move(frame_key_path),
+        0,
+        frame_type,
+        ((frame_is_root_map == true) ? (container_char_type::opening_delimiter)
+                                     : (container_char_type::leading_whitespace)),
+        frame_is_root_map,
+        false,
+        0,
+        false};
+  }};
+  const key_path_filter root_filter{
+      ((is_root_map == true) && (ctx.validate_only == false) &&
+       (ctx.options.key_paths.empty() == false))
+          ? (key_path_filter::descend)
+          : (key_path_filter::keep)};
+
+  if (is_root_map == true) {
+    const typename std::istream::int_type first_char{ctx.input_stream.peek()};
+    if (first_char == std::istream::traits_type::eof()) {
+      return ((is_validating(ctx) == true)
+                  ? (node_ptr<node>{nullptr})
+                  : (node_ptr<node>{make_node_ptr<map_node>()}));
+    }
+  }
 
-  char_type last_char_type{char_type::leading_whitespace};
+  std::vector<container_frame> stack{};
+  if (parse_result<void> counted{count_node(ctx)};
+      counted.has_value() == false) {
+    if (ctx.errors == nullptr) {
+      return std::unexpected{std::move(counted.error())};
+    }
+    record_error(ctx, std::move(counted.error()));
+    return make_frame(type, possible_terminating_chars, is_root_map,
+                      root_filter, std::string{})
+        .value;
+  }
+  stack.push_back(make_frame(type, possible_terminating_chars, is_root_map,
+                             root_filter, std::string{}));
 
-  char cur_char{};
+  std::optional<std::size_t> last_error_offset{};
+
+  while (true) {
+    container_frame &top{stack.back()};
+    char frame_actual_terminating_char{};
+
+    parse_result<container_frame_result> frame_result{
+        ((top.type == node_type::Map)
+             ? (parse_map_frame(ctx, top, frame_actual_terminating_char))
+             : (parse_array_frame(ctx, top, frame_actual_terminating_char)))};
+    if (frame_result.has_value() == false) {
+      if (ctx.errors == nullptr) {
+        return std::unexpected{std::move(frame_result.error())};
+      }
+
+      // An error at the same input position as the previous one means the
+      // last resync made no progress, so it is not reported twice.
+      const bool made_progress{last_error_offset != ctx.source.offset()};
+      last_error_offset = ctx.source.offset();
+      const bool split_by_newline{
+          is_split_by_newline_error(frame_result.error())};
+      if ((made_progress == true) &&
+          (record_error(ctx, std::move(frame_result.error())) == false)) {
+        return close_container_frames(ctx, stack);
+      }
+
+      if (top.in_directive == true) {
+        // The directive may have been read past the end of its line, so the
+        // line is skipped from where the directive began.
+        top.in_directive = false;
+        skip_to_end_of_line(ctx, top.directive_offset);
+      } else if (split_by_newline == true) {
+        // The token was read up to the first character of a later line, so
+        // parsing resumes there, as though the line break ended the member.
+        ctx.source.rewind(ctx.source.offset() - 1);
+        ctx.input_stream.clear();
+        if (resync_container_frames(
+                ctx, stack,
+                ((top.type == node_type::Map)
+                     ? (character_constants::k_key_value_terminate)
+                     : (character_constants::k_array_element_separator))) ==
+            false) {
+          return close_container_frames(ctx, stack);
+        }
+      } else if (const std::optional<char> resync_char{
+                     skip_to_resync_char(ctx, top, made_progress)};
+                 resync_char.has_value() == false) {
+        return close_container_frames(ctx, stack);
+      } else if (resync_container_frames(ctx, stack, resync_char.value()) ==
+                 false) {
+        return close_container_frames(ctx, stack);
+      }
+      continue;
+    }
+    const container_frame_result res{frame_result.value()};
+
+    switch (res) {
+    case container_frame_result::completed: {
+      if (stack.size() == 1) {
+        if (actual_terminating_char != nullptr) {
+          *actual_terminating_char = frame_actual_terminating_char;
+        }
+        if (top.is_root_map == false) {
+          record_span(ctx, top.value.get(), top.begin_offset);
+        } else if (ctx.root_keys != nullptr) {
+          *(ctx.root_keys) = std::move(top.seen_keys);
+        }
+        return std::move(top.value);
+      }
+
+      if (parse_result<void> popped{pop_container_frame(ctx, stack)};
+          popped.has_value() == false) {
+        if (ctx.errors == nullptr) {
+          return std::unexpected{std::move(popped.error())};
+        } else if (record_error(ctx, std::move(popped.error())) == false) {
+          return close_container_frames(ctx, stack);
+        }
+      }
+      update_frame_after_member(stack.back(), frame_actual_terminating_char);
+    } break;
+
+    case container_frame_result::push_map:
+    case container_frame_result::push_array: {
+      std::optional<parse_error> limit_error{};
+      if ((ctx.enclosing_depth + stack.size()) >
+          ctx.options.max_nesting_depth) {
+        limit_error = make_parse_error(ctx, error_messages::err_msg_3_3_1);
+      } else if (parse_result<void> counted{count_node(ctx)};
+                 counted.has_value() == false) {
+        limit_error = std::move(counted.error());
+      }
+      if (limit_error.has_value() == true) {
+        if (ctx.errors == nullptr) {
+          return std::unexpected{std::move(limit_error.value())};
+        }
+        record_error(ctx, std::move(limit_error.value()));
+        return close_container_frames(ctx, stack);
+      }
+
+      const node_type child_type{((res == container_frame_result::push_map)
+                                      ? (node_type::Map)
+                                      : (node_type::Array))};
+      const std::string_view child_terminating_chars{
+          ((top.type == node_type::Map)
+               ? (k_possible_terminating_chars_for_members)
+               : (std::string_view{k_possible_terminating_chars_for_elements}))};
+      const key_path_filter child_filter{
+          ((top.filter == key_path_filter::descend) ? (top.member_filter)
+                                                    : (top.filter))};
+      const bool is_deferred{defers_container(ctx, top, child_filter)};
+      if ((is_deferred == true) &&
+          (ctx.options.check_skipped_values == false)) {
+        if (parse_result<void> deferred{
+                defer_container(ctx, top, child_type, child_terminating_chars,
+                                (ctx.enclosing_depth + stack.size()))};
+            deferred.has_value() == false) {
+          return std::unexpected{std::move(deferred.error())};
+        }
+        break;
+      }
+      if ((is_deferred == true) ||
+          ((top.filter == key_path_filter::descend) &&
+           (child_filter == key_path_filter::skip))) {
+        ctx.in_skipped_value = true;
+      }
+      stack.push_back(make_frame(
+          child_type, child_terminating_chars, false, child_filter,
+          ((child_filter == key_path_filter::descend)
+               ? (append_key_path(top.key_path, top.member_key))
+               : (std::string{}))));
+      stack.back().is_deferred = is_deferred;
+    } break;
+    }
+  }
+}
+
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::parser::impl::container_frame_result>
+libconfigfile::parser::impl::parse_map_frame(context &ctx,
+                                             container_frame &frame,
+                                             char &actual_terminating_char) {
+  static constexpr std::string_view k_possible_terminating_chars_for_members{
+      &character_constants::k_key_value_terminate, 1};
 
   for (;;) {
+    char cur_char{};
     bool eof{false};
     while (true) {
-      handle_comments(ctx);
+      if (parse_result<bool> comment_result{handle_comments(ctx)};
+          comment_result.has_value() == false) {
+        return std::unexpected{std::move(comment_result.error())};
+      }
       ctx.input_stream.get(cur_char);
       if (ctx.input_stream.eof() == true) {
         eof = true;
         break;
       } else if (cur_char == character_constants::k_newline) {
-        ++ctx.line_count;
-        ctx.char_count = 0;
         continue;
       } else {
-        ++ctx.char_count;
         break;
       }
     }
 
     if (eof == true) {
-      throw syntax_error{error_messages::err_msg_1_2_6.message,
-                         error_messages::err_msg_1_2_6.category, ctx.identifier,
-                         ctx.line_count, ctx.char_count};
-    } else if ((possible_terminating_chars.find(cur_char) !=
-                std::string::npos) &&
-               (last_char_type == char_type::closing_delimiter)) {
-      if (actual_terminating_char != nullptr) {
-        *actual_terminating_char = cur_char;
+      if (frame.is_root_map == true) {
+        return container_frame_result::completed;
+      } else {
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_2_6)};
       }
-      break;
+    } else if ((frame.possible_terminating_chars.find(cur_char)) !=
+               (std::string::npos)) {
+      actual_terminating_char = cur_char;
+      return container_frame_result::completed;
     } else if (is_whitespace(cur_char)) {
       continue;
     } else {
-      switch (last_char_type) {
+      if ((frame.is_root_map == true) &&
+          (cur_char != character_constants::k_directive_leader)) {
+        frame.last_non_whitespace_char_offset = ctx.source.offset();
+      }
 
-      case char_type::leading_whitespace: {
-        if (cur_char == character_constants::k_array_opening_delimiter) {
-          last_char_type = char_type::opening_delimiter;
+      switch (frame.last_char_type) {
+
+      case container_char_type::leading_whitespace: {
+        if (cur_char == character_constants::k_map_opening_delimiter) {
+          frame.last_char_type = container_char_type::opening_delimiter;
         } else {
-          throw syntax_error{error_messages::err_msg_1_6_1.message,
-                             error_messages::err_msg_1_6_1.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_7_1)};
         }
       } break;
 
-      case char_type::opening_delimiter: {
-        if (cur_char == character_constants::k_array_closing_delimiter) {
-          last_char_type = char_type::closing_delimiter;
-        } else if (cur_char == character_constants::k_array_element_separator) {
-          throw syntax_error{error_messages::err_msg_1_2_5.message,
-                             error_messages::err_msg_1_2_5.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+      case container_char_type::opening_delimiter:
+      case container_char_type::separator: {
+        if ((cur_char == character_constants::k_map_closing_delimiter) &&
+            (frame.is_root_map == false)) {
+          frame.last_char_type = container_char_type::closing_delimiter;
+        } else if (cur_char == character_constants::k_key_value_terminate) {
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_2_7)};
+        } else if (cur_char == character_constants::k_directive_leader) {
+          frame.in_directive = true;
+          frame.directive_offset = ctx.source.offset();
+          if (parse_result<void> handled_directive{
+                  handle_map_frame_directive(ctx, frame)};
+              handled_directive.has_value() == false) {
+            return std::unexpected{std::move(handled_directive.error())};
+          }
+          frame.in_directive = false;
         } else {
-          --ctx.char_count;
+          frame.member_key_offset = ctx.source.offset();
           ctx.input_stream.unget();
-          char element_actual_terminating_char{};
-          ret_val->push_back(call_appropriate_value_parse_func(
-              ctx, k_possible_terminating_chars_for_elements,
-              &element_actual_terminating_char));
-          switch (element_actual_terminating_char) {
-          case character_constants::k_array_element_separator: {
-            last_char_type = char_type::element_separator;
-          } break;
-          case character_constants::k_array_closing_delimiter: {
-            last_char_type = char_type::closing_delimiter;
-          } break;
-          default: {
-            throw bits_and_bytes::unreachable_error{};
-          } break;
+
+          parse_result<std::string> key{parse_key_value_key(ctx)};
+          if (key.has_value() == false) {
+            return std::unexpected{std::move(key.error())};
           }
-        }
-      } break;
+          frame.member_key = std::move(key.value());
 
-      case char_type::element_separator: {
-        if (cur_char == character_constants::k_array_closing_delimiter) {
-          last_char_type = char_type::closing_delimiter;
-        } else if (cur_char == character_constants::k_array_element_separator) {
-          throw syntax_error{error_messages::err_msg_1_2_5.message,
-                             error_messages::err_msg_1_2_5.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
-        } else {
-          --ctx.char_count;
-          ctx.input_stream.unget();
-          char element_actual_terminating_char{};
-          ret_val->push_back(call_appropriate_value_parse_func(
-              ctx, k_possible_terminating_chars_for_elements,
-              &element_actual_terminating_char));
-          switch (element_actual_terminating_char) {
-          case character_constants::k_array_element_separator: {
-            last_char_type = char_type::element_separator;
+          if (parse_result<void> skipped{skip_to_key_value_value(
+                  ctx, k_possible_terminating_chars_for_members)};
+              skipped.has_value() == false) {
+            return std::unexpected{std::move(skipped.error())};
+          }
+
+          const parse_result<node_type> value_type_result{
+              identify_key_value_value_type(
+                  ctx, k_possible_terminating_chars_for_members)};
+          if (value_type_result.has_value() == false) {
+            return std::unexpected{value_type_result.error()};
+          }
+          const node_type value_type{value_type_result.value()};
+          if (frame.filter == key_path_filter::descend) {
+            frame.member_filter =
+                filter_map_frame_member(ctx, frame, value_type);
+            if ((frame.member_filter == key_path_filter::skip) &&
+                (ctx.options.check_skipped_values == false)) {
+              if (parse_result<void> skipped{skip_map_member_value(ctx)};
+                  skipped.has_value() == false) {
+                return std::unexpected{std::move(skipped.error())};
+              } else if (parse_result<void> inserted{insert_map_frame_member(
+                             ctx, frame, node_ptr<node>{nullptr})};
+                         inserted.has_value() == false) {
+                return std::unexpected{std::move(inserted.error())};
+              }
+              frame.last_char_type = container_char_type::separator;
+              continue;
+            }
+          }
+
+          switch (value_type) {
+          case node_type::Map: {
+            return container_frame_result::push_map;
           } break;
-          case character_constants::k_array_closing_delimiter: {
-            last_char_type = char_type::closing_delimiter;
+
+          case node_type::Array: {
+            return container_frame_result::push_array;
           } break;
+
           default: {
-            throw bits_and_bytes::unreachable_error{};
+            const bool is_skipped_value{
+                (frame.filter == key_path_filter::descend) &&
+                (frame.member_filter == key_path_filter::skip)};
+            if (is_skipped_value == true) {
+              ctx.in_skipped_value = true;
+            }
+            const std::size_t value_offset{ctx.source.offset()};
+            parse_result<node_ptr<node>> value{
+                call_appropriate_scalar_value_parse_func(
+                    ctx, value_type, k_possible_terminating_chars_for_members)};
+            if (is_skipped_value == true) {
+              ctx.in_skipped_value = false;
+            }
+            if (value.has_value() == false) {
+              return std::unexpected{std::move(value.error())};
+            }
+            record_span(ctx, value.value().get(), value_offset);
+            if (parse_result<void> inserted{insert_map_frame_member(
+                    ctx, frame, std::move(value.value()))};
+                inserted.has_value() == false) {
+              return std::unexpected{std::move(inserted.error())};
+            }
+            frame.last_char_type = container_char_type::separator;
           } break;
           }
         }
       } break;
 
-      case char_type::closing_delimiter: {
-        throw syntax_error{error_messages::err_msg_1_6_3.message,
-                           error_messages::err_msg_1_6_3.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+      case container_char_type::closing_delimiter: {
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_7_3)};
       } break;
       }
     }
   }
-  return ret_val;
 }
 
-libconfigfile::node_ptr<libconfigfile::map_node>
-libconfigfile::parser::impl::parse_map_value(
-    context &ctx, const std::string_view possible_terminating_chars,
-    char *actual_terminating_char /*= nullptr*/,
-    const bool is_root_map /*= false*/) {
-  node_ptr<map_node> ret_val{make_node_ptr<map_node>()};
-
-  if (is_root_map == true) {
-    const typename std::istream::int_type first_char{ctx.input_stream.peek()};
-    if (first_char == std::istream::traits_type::eof()) {
-      return ret_val;
-    }
-  }
-
-  enum class char_type {
-    leading_whitespace,
-    opening_delimiter,
-    member_separator,
-    closing_delimiter,
-  };
-
-  char_type last_char_type{((is_root_map == true)
-                                ? (char_type::opening_delimiter)
-                                : (char_type::leading_whitespace))};
-
-  decltype(ctx.line_count) last_non_whitespace_char_line_pos_count{};
-
-  const auto handle_directive{[is_root_map,
-                               &last_non_whitespace_char_line_pos_count, &ctx,
-                               &ret_val]() {
-    if (is_root_map == false) {
-      throw syntax_error{error_messages::err_msg_1_8_15.message,
-                         error_messages::err_msg_1_8_15.category,
-                         ctx.identifier, ctx.line_count, ctx.char_count};
-    } else if (last_non_whitespace_char_line_pos_count == ctx.line_count) {
-      throw syntax_error{error_messages::err_msg_1_8_16.message,
-                         error_messages::err_msg_1_8_16.category,
-                         ctx.identifier, ctx.line_count, ctx.char_count};
-    } else {
-
-      const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-          start_pos_count;
-      ctx.input_stream.unget();
-      --ctx.char_count;
-      std::pair<directive, std::optional<node_ptr<map_node>>> dir_res{
-          parse_directive(ctx)};
-
-      switch (dir_res.first) {
-      case directive::null: {
-        throw bits_and_bytes::unreachable_error{};
-      } break;
-
-      case directive::version: {
-        ;
-      } break;
-
-      case directive::include: {
-        assert(dir_res.second);
-        for (auto i{dir_res.second.value()->begin()};
-             i != dir_res.second.value()->end(); ++i) {
-          if (ret_val->contains(i->first)) {
-            throw syntax_error{error_messages::err_msg_1_9_5.message,
-                               error_messages::err_msg_1_9_5.category,
-                               ctx.identifier, start_pos_count.first,
-                               start_pos_count.second};
-          }
-        }
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::parser::impl::container_frame_result>
+libconfigfile::parser::impl::parse_array_frame(context &ctx,
+                                               container_frame &frame,
+                                               char &actual_terminating_char) {
+  static const std::string k_possible_terminating_chars_for_elements{
+      std::string{} + character_constants::k_array_element_separator +
+      character_constants::k_array_closing_delimiter};
 
-        ret_val->insert(
-            std::make_move_iterator(dir_res.second.value()->begin()),
-            std::make_move_iterator(dir_res.second.value()->end()));
-      } break;
-      }
-    }
-  }};
+  char cur_char{};
 
   for (;;) {
-    char cur_char{};
     bool eof{false};
     while (true) {
-      handle_comments(ctx);
+      if (parse_result<bool> comment_result{handle_comments(ctx)};
+          comment_result.has_value() == false) {
+        return std::unexpected{std::move(comment_result.error())};
+      }
       ctx.input_stream.get(cur_char);
       if (ctx.input_stream.eof() == true) {
         eof = true;
         break;
       } else if (cur_char == character_constants::k_newline) {
-        ++ctx.line_count;
-        ctx.char_count = 0;
         continue;
       } else {
-        ++ctx.char_count;
         break;
       }
     }
 
     if (eof == true) {
-      if (is_root_map == true) {
-        break;
-      } else {
-        throw syntax_error{error_messages::err_msg_1_2_6.message,
-                           error_messages::err_msg_1_2_6.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
-      }
-    } else if ((possible_terminating_chars.find(cur_char)) !=
-               (std::string::npos)) {
-      if (actual_terminating_char != nullptr) {
-        *actual_terminating_char = cur_char;
-      }
-      break;
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_2_6)};
+    } else if ((frame.possible_terminating_chars.find(cur_char) !=
+                std::string::npos) &&
+               (frame.last_char_type == container_char_type::closing_delimiter)) {
+      actual_terminating_char = cur_char;
+      return container_frame_result::completed;
     } else if (is_whitespace(cur_char)) {
       continue;
     } else {
-      if ((is_root_map == true) &&
-          (cur_char != character_constants::k_directive_leader)) {
-        last_non_whitespace_char_line_pos_count = ctx.line_count;
-      }
+      switch (frame.last_char_type) {
 
-      switch (last_char_type) {
-
-      case char_type::leading_whitespace: {
-        if (cur_char == character_constants::k_map_opening_delimiter) {
-          last_char_type = char_type::opening_delimiter;
+      case container_char_type::leading_whitespace: {
+        if (cur_char == character_constants::k_array_opening_delimiter) {
+          frame.last_char_type = container_char_type::opening_delimiter;
         } else {
-          throw syntax_error{error_messages::err_msg_1_7_1.message,
-                             error_messages::err_msg_1_7_1.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_6_1)};
         }
       } break;
 
-      case char_type::opening_delimiter: {
-        if ((cur_char == character_constants::k_map_closing_delimiter) &&
-            (is_root_map == false)) {
-          last_char_type = char_type::closing_delimiter;
-        } else if (cur_char == character_constants::k_key_value_terminate) {
-          throw syntax_error{error_messages::err_msg_1_2_7.message,
-                             error_messages::err_msg_1_2_7.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
-        } else if (cur_char == character_constants::k_directive_leader) {
-          handle_directive();
+      case container_char_type::opening_delimiter:
+      case container_char_type::separator: {
+        if (cur_char == character_constants::k_array_closing_delimiter) {
+          frame.last_char_type = container_char_type::closing_delimiter;
+        } else if (cur_char == character_constants::k_array_element_separator) {
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_2_5)};
         } else {
-          const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-              start_pos_count{ctx.line_count, ctx.char_count};
           ctx.input_stream.unget();
-          --ctx.char_count;
 
-          std::pair<std::string, node_ptr<node>> new_key_value{parse_key_value(
-              ctx, std::string{character_constants::k_key_value_terminate})};
+          char element_actual_terminating_char{};
+          const parse_result<node_type> value_type_result{
+              identify_key_value_value_type(
+                  ctx, k_possible_terminating_chars_for_elements,
+                  &element_actual_terminating_char)};
+          if (value_type_result.has_value() == false) {
+            return std::unexpected{value_type_result.error()};
+          }
+          const node_type value_type{value_type_result.value()};
+          switch (value_type) {
+          case node_type::Map: {
+            return container_frame_result::push_map;
+          } break;
+
+          case node_type::Array: {
+            return container_frame_result::push_array;
+          } break;
 
-          if (ret_val->contains(new_key_value.first) == true) {
-            throw syntax_error{error_messages::err_msg_1_9_5.message,
-                               error_messages::err_msg_1_9_5.category,
-                               ctx.identifier, start_pos_count.first,
-                               start_pos_count.second};
-          } else {
-            ret_val->insert({std::move(new_key_value)});
+          default: {
+            const std::size_t value_offset{ctx.source.offset()};
+            parse_result<node_ptr<node>> value{
+                call_appropriate_scalar_value_parse_func(
+                    ctx, value_type, k_possible_terminating_chars_for_elements,
+                    &element_actual_terminating_char)};
+            if (value.has_value() == false) {
+              return std::unexpected{std::move(value.error())};
+            }
+            record_span(ctx, value.value().get(), value_offset);
+            if (is_validating(ctx) == false) {
+              static_cast<array_node *>(frame.value.get())
+                  ->push_back(std::move(value.value()));
+            }
+          } break;
+          }
+
+          switch (element_actual_terminating_char) {
+          case character_constants::k_array_element_separator: {
+            frame.last_char_type = container_char_type::separator;
+          } break;
+          case character_constants::k_array_closing_delimiter: {
+            frame.last_char_type = container_char_type::closing_delimiter;
+          } break;
+          default: {
+            throw bits_and_bytes::unreachable_error{};
+          } break;
           }
-          last_char_type = char_type::member_separator;
         }
       } break;
 
-      case char_type::member_separator: {
-        if ((cur_char == character_constants::k_map_closing_delimiter) &&
-            (is_root_map == false)) {
-          last_char_type = char_type::closing_delimiter;
-        } else if (cur_char == character_constants::k_key_value_terminate) {
-          throw syntax_error{error_messages::err_msg_1_2_7.message,
-                             error_messages::err_msg_1_2_7.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
-        } else if (cur_char == character_constants::k_directive_leader) {
-          handle_directive();
-        } else {
-          const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-              start_pos_count{ctx.line_count, ctx.char_count};
-          ctx.input_stream.unget();
-          --ctx.char_count;
+      case container_char_type::closing_delimiter: {
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_6_3)};
+      } break;
+      }
+    }
+  }
+}
 
-          std::pair<std::string, node_ptr<node>> new_key_value{parse_key_value(
-              ctx, std::string{character_constants::k_key_value_terminate})};
+libconfigfile::parser::impl::parse_result<void>
+libconfigfile::parser::impl::handle_map_frame_directive(
+    context &ctx, container_frame &frame) {
+  if (frame.is_root_map == false) {
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_1_8_15)};
+  } else if ((frame.last_non_whitespace_char_offset != 0) &&
+             (ctx.source.line(frame.last_non_whitespace_char_offset) ==
+              ctx.source.line(ctx.source.offset()))) {
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_1_8_16)};
+  } else {
 
-          if (ret_val->contains(new_key_value.first) == true) {
-            throw syntax_error{error_messages::err_msg_1_9_5.message,
-                               error_messages::err_msg_1_9_5.category,
-                               ctx.identifier, start_pos_count.first,
-                               start_pos_count.second};
-          } else {
-            ret_val->insert({std::move(new_key_value)});
+    const std::size_t start_offset{ctx.source.offset()};
+    key_set included_keys{};
+    ctx.input_stream.unget();
+    parse_result<std::pair<directive, std::optional<node_ptr<map_node>>>>
+        dir_result{parse_directive(
+            ctx, ((tracks_seen_keys(frame) == true) ? (&included_keys)
+                                                     : (nullptr)))};
+    if (dir_result.has_value() == false) {
+      return std::unexpected{std::move(dir_result.error())};
+    }
+    std::pair<directive, std::optional<node_ptr<map_node>>> &dir_res{
+        dir_result.value()};
+
+    switch (dir_res.first) {
+    case directive::null: {
+      throw bits_and_bytes::unreachable_error{};
+    } break;
+
+    case directive::version: {
+      ;
+    } break;
+
+    case directive::include: {
+      assert(dir_res.second);
+      if (tracks_seen_keys(frame) == true) {
+        for (const std::string &key : included_keys) {
+          if (frame.seen_keys.contains(key) == true) {
+            erase_spans(ctx, dir_res.second.value().get());
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_9_5, start_offset)};
           }
-          last_char_type = char_type::member_separator;
         }
-      } break;
+        frame.seen_keys.merge(included_keys);
+        if (frame.value.get() == nullptr) {
+          break;
+        }
+      }
 
-      case char_type::closing_delimiter: {
-        throw syntax_error{error_messages::err_msg_1_7_3.message,
-                           error_messages::err_msg_1_7_3.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
-      } break;
+      map_node *map{static_cast<map_node *>(frame.value.get())};
+      for (auto i{dir_res.second.value()->begin()};
+           i != dir_res.second.value()->end(); ++i) {
+        if (map->contains(i->first)) {
+          erase_spans(ctx, dir_res.second.value().get());
+          return std::unexpected{make_parse_error(ctx,
+                                                  error_messages::err_msg_1_9_5,
+                                                  start_offset)};
+        }
       }
+
+      map->insert(std::make_move_iterator(dir_res.second.value()->begin()),
+                  std::make_move_iterator(dir_res.second.value()->end()));
+    } break;
     }
+
+    return {};
   }
-  return ret_val;
 }
+
+libconfigfile::parser::impl::parse_result<void>
+libconfigfile::parser::impl::insert_map_frame_member(
+    context &ctx, container_frame &frame, node_ptr<node> &&value) {
+  if (tracks_seen_keys(frame) == true) {
+    if (frame.seen_keys.insert(frame.member_key).second == false) {
+      erase_spans(ctx, value.get());
+      return std::unexpected{make_parse_error(
+          ctx, error_messages::err_msg_1_9_5, frame.member_key_offset)};
+    } else if ((frame.value.get() != nullptr) && (value.get() != nullptr)) {
+      static_cast<map_node *>(frame.value.get())
+          ->insert({std::move(frame.member_key), std::move(value)});
+    } else {
+      erase_spans(ctx, value.get());
+    }
+    return {};
+  }
+
+  map_node *map{static_cast<map_node *>(frame.value.get())};
+  if (map->contains(frame.member_key) == true) {
+    erase_spans(ctx, value.get());
+    return std::unexpected{make_parse_error(ctx, error_messages::err_msg_1_9_5,
+                                            frame.member_key_offset)};
+  } else {
+    map->insert({std::move(frame.member_key), std::move(value)});
+    return {};
+  }
+}
+
+bool libconfigfile::parser::impl::tracks_seen_keys(
+    const container_frame &frame) {
+  return ((frame.value.get() == nullptr) ||
+          (frame.filter == key_path_filter::descend));
+}
+
+libconfigfile::parser::impl::key_path_filter
+libconfigfile::parser::impl::filter_map_frame_member(
+    const context &ctx, const container_frame &frame,
+    const node_type value_type) {
+  const std::string key_path{append_key_path(frame.key_path, frame.member_key)};
+
+  bool is_prefix{false};
+  for (const std::string &wanted : ctx.options.key_paths) {
+    if (wanted == key_path) {
+      return key_path_filter::keep;
+    } else if ((wanted.size() > key_path.size()) &&
+               (wanted.starts_with(key_path) == true) &&
+               (wanted[key_path.size()] ==
+                character_constants::k_key_path_separator)) {
+      is_prefix = true;
+    }
+  }
+
+  return (((is_prefix == true) && (value_type == node_type::Map))
+              ? (key_path_filter::descend)
+              : (key_path_filter::skip));
+}
+
+std::string
+libconfigfile::parser::impl::append_key_path(const std::string &key_path,
+                                             const std::string &key) {
+  if (key_path.empty() == true) {
+    return key;
+  } else {
+    return key_path + character_constants::k_key_path_separator + key;
+  }
+}
+
+// Skips a member's value without checking it, up to and including the `;`
+// ending it.
+libconfigfile::parser::impl::parse_result<void>
+libconfigfile::parser::impl::skip_map_member_value(context &ctx) {
+  static const std::string k_stop_chars{
+      std::string{} + character_constants::k_key_value_terminate +
+      character_constants::k_map_closing_delimiter +
+      character_constants::k_array_closing_delimiter};
+
+  parse_result<std::optional<char>> stop_char{
+      scan_to_unnested_char(ctx, k_stop_chars)};
+  if (stop_char.has_value() == false) {
+    return std::unexpected{std::move(stop_char.error())};
+  } else if (stop_char.value() != character_constants::k_key_value_terminate) {
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_1_2_6)};
+  } else {
+    return {};
+  }
+}
+
+bool libconfigfile::parser::impl::defers_container(
+    const context &ctx, const container_frame &parent,
+    const key_path_filter filter) {
+  return ((ctx.document != nullptr) && (is_validating(ctx) == false) &&
+          (parent.value.get() != nullptr) && (filter == key_path_filter::keep));
+}
+
+// Skips a nested container's value without checking it, up to and including
+// the character terminating it, and adds to `parent` a container that parses
+// the value when first accessed.
+libconfigfile::parser::impl::parse_result<void>
+libconfigfile::parser::impl::defer_container(
+    context &ctx, container_frame &parent, const node_type type,
+    const std::string_view possible_terminating_chars,
+    const std::size_t enclosing_depth) {
+  static const std::string k_stop_chars{
+      std::string{} + character_constants::k_key_value_terminate +
+      character_constants::k_map_closing_delimiter +
+      character_constants::k_array_closing_delimiter +
+      character_constants::k_array_element_separator};
+
+  const std::size_t begin_offset{ctx.source.offset()};
+  parse_result<std::optional<char>> terminating_char{
+      scan_to_unnested_char(ctx, k_stop_chars)};
+  if (terminating_char.has_value() == false) {
+    return std::unexpected{std::move(terminating_char.error())};
+  } else if ((terminating_char.value().has_value() == false) ||
+             (possible_terminating_chars.find(
+                  terminating_char.value().value()) ==
+              std::string_view::npos)) {
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_1_2_6)};
+  }
+
+  node_ptr<node> value{make_lazy_container(
+      ctx, type, begin_offset, possible_terminating_chars, enclosing_depth)};
+  record_span(ctx, value.get(), begin_offset);
+
+  if (parse_result<void> added{
+          add_container_frame_member(ctx, parent, std::move(value))};
+      added.has_value() == false) {
+    return added;
+  }
+  update_frame_after_member(parent, terminating_char.value().value());
+  return {};
+}
+
+libconfigfile::node_ptr<libconfigfile::node>
+libconfigfile::parser::impl::make_lazy_container(
+    const context &ctx, const node_type type, const std::size_t begin_offset,
+    const std::string_view possible_terminating_chars,
+    const std::size_t enclosing_depth) {
+  std::shared_ptr<const lazy_subtree> lazy{
+      std::make_shared<const lazy_container>(ctx.document, begin_offset, type,
+                                             possible_terminating_chars,
+                                             enclosing_depth)};
+  if (type == node_type::Map) {
+    node_ptr<map_node> map{make_node_ptr<map_node>()};
+    map->set_lazy_subtree(std::move(lazy));
+    return map;
+  } else {
+    node_ptr<array_node> array{make_node_ptr<array_node>()};
+    array->set_lazy_subtree(std::move(lazy));
+    return array;
+  }
+}
+
+libconfigfile::parser::impl::parse_result<void>
+libconfigfile::parser::impl::pop_container_frame(
+    context &ctx, std::vector<container_frame> &stack) {
+  container_frame &frame{stack.back()};
+  node_ptr<node> value{((frame.is_deferred == true)
+                            ? (make_lazy_container(
+                                  ctx, frame.type, frame.begin_offset,
+                                  frame.possible_terminating_chars,
+                                  (ctx.enclosing_depth + stack.size() - 1)))
+                            : (std::move(frame.value)))};
+  record_span(ctx, value.get(), frame.begin_offset);
+  const key_path_filter filter{frame.filter};
+  const bool is_deferred{frame.is_deferred};
+  stack.pop_back();
+
+  container_frame &parent{stack.back()};
+  if ((is_deferred == true) || ((parent.filter == key_path_filter::descend) &&
+                                (filter == key_path_filter::skip))) {
+    ctx.in_skipped_value = false;
+  }
+
+  return add_container_frame_member(ctx, parent, std::move(value));
+}
+
+libconfigfile::parser::impl::parse_result<void>
+libconfigfile::parser::impl::add_container_frame_member(
+    context &ctx, container_frame &frame, node_ptr<node> &&value) {
+  if (frame.type == node_type::Map) {
+    return insert_map_frame_member(ctx, frame, std::move(value));
+  } else if (is_validating(ctx) == true) {
+    return {};
+  } else {
+    static_cast<array_node *>(frame.value.get())->push_back(std::move(value));
+    return {};
+  }
+}
+
+void libconfigfile::parser::impl::update_frame_after_member(
+    container_frame &frame, const char terminating_char) {
+  if (frame.type == node_type::Map) {
+    frame.last_char_type = container_char_type::separator;
+  } else {
+    switch (terminating_char) {
+    case character_constants::k_array_element_separator: {
+      frame.last_char_type = container_char_type::separator;
+    } break;
+    case character_constants::k_array_closing_delimiter: {
+      frame.last_char_type = container_char_type::closing_delimiter;
+    } break;
+    default: {
+      throw bits_and_bytes::unreachable_error{};
+    } break;
+    }
+  }
+}
+
+bool libconfigfile::parser::impl::resync_container_frames(
+    context &ctx, std::vector<container_frame> &stack, const char resync_char) {
+  while (true) {
+    container_frame &top{stack.back()};
+
+    if (top.last_char_type == container_char_type::closing_delimiter) {
+      if (top.possible_terminating_chars.find(resync_char) !=
+          std::string::npos) {
+        if (parse_result<void> popped{pop_container_frame(ctx, stack)};
+            (popped.has_value() == false) &&
+            (record_error(ctx, std::move(popped.error())) == false)) {
+          return false;
+        }
+        update_frame_after_member(stack.back(), resync_char);
+        return true;
+      }
+    } else if (top.type == node_type::Map) {
+      if (resync_char == character_constants::k_key_value_terminate) {
+        top.last_char_type = container_char_type::separator;
+        return true;
+      } else if ((resync_char ==
+                  character_constants::k_map_closing_delimiter) &&
+                 (top.is_root_map == false)) {
+        top.last_char_type = container_char_type::closing_delimiter;
+        return true;
+      }
+    } else {
+      if (resync_char == character_constants::k_array_element_separator) {
+        top.last_char_type = container_char_type::separator;
+        return true;
+      } else if (resync_char ==
+                 character_constants::k_array_closing_delimiter) {
+        top.last_char_type = container_char_type::closing_delimiter;
+        return true;
+      }
+    }
+
+    // A closing delimiter with nothing left to close is skipped; anything
+    // else closes the current frame early and is handed to its parent.
+    if (top.is_root_map == true) {
+      return true;
+    } else if (parse_result<void> popped{pop_container_frame(ctx, stack)};
+               (popped.has_value() == false) &&
+               (record_error(ctx, std::move(popped.error())) == false)) {
+      return false;
+    }
+  }
+}
+
 libconfigfile::node_ptr<libconfigfile::node>
+libconfigfile::parser::impl::close_container_frames(
+    context &ctx, std::vector<container_frame> &stack) {
+  while (stack.size() > 1) {
+    if (parse_result<void> popped{pop_container_frame(ctx, stack)};
+        popped.has_value() == false) {
+      record_error(ctx, std::move(popped.error()));
+    }
+  }
+  return std::move(stack.back().value);
+}
+
+std::optional<char> libconfigfile::parser::impl::skip_to_resync_char(
+    context &ctx, const container_frame &frame, const bool check_last_char) {
+  static const std::string k_resync_chars{
+      std::string{} + character_constants::k_key_value_terminate +
+      character_constants::k_map_closing_delimiter +
+      character_constants::k_array_closing_delimiter};
+  static const std::string k_resync_chars_with_separator{
+      k_resync_chars + character_constants::k_array_element_separator};
+
+  const bool is_separator_resync_char{
+      (frame.type == node_type::Array) ||
+      ((frame.last_char_type == container_char_type::closing_delimiter) &&
+       (frame.possible_terminating_chars.find(
+            character_constants::k_array_element_separator) !=
+        std::string::npos))};
+  const std::string_view resync_chars{((is_separator_resync_char == true)
+                                           ? (k_resync_chars_with_separator)
+                                           : (k_resync_chars))};
+
+  if (ctx.input_stream.eof() == true) {
+    return std::nullopt;
+  }
+  ctx.input_stream.clear();
+
+  // The character that caused the error may itself end the value.
+  if (check_last_char == true) {
+    char last_char{};
+    if ((ctx.input_stream.unget().get(last_char)) &&
+        (resync_chars.find(last_char) != std::string_view::npos)) {
+      return last_char;
+    }
+    ctx.input_stream.clear();
+  }
+
+  parse_result<std::optional<char>> resync_char{
+      scan_to_unnested_char(ctx, resync_chars)};
+  if (resync_char.has_value() == false) {
+    record_error(ctx, std::move(resync_char.error()));
+    return std::nullopt;
+  } else {
+    return resync_char.value();
+  }
+}
+
+// Consumes input up to and including the first of `stop_chars` outside of any
+// nested map, array, string or comment, which is returned; std::nullopt is
+// returned at the end of the input.
+libconfigfile::parser::impl::parse_result<std::optional<char>>
+libconfigfile::parser::impl::scan_to_unnested_char(
+    context &ctx, const std::string_view stop_chars) {
+  std::size_t depth{0};
+  bool in_string{false};
+  bool in_escape_sequence{false};
+  char cur_char{};
+  while (true) {
+    if (in_string == false) {
+      if (parse_result<bool> comment_result{handle_comments(ctx)};
+          comment_result.has_value() == false) {
+        return std::unexpected{std::move(comment_result.error())};
+      }
+    }
+
+    ctx.input_stream.get(cur_char);
+    if (ctx.input_stream.eof() == true) {
+      return std::nullopt;
+    } else if (cur_char == character_constants::k_newline) {
+      in_string = false;
+      in_escape_sequence = false;
+      continue;
+    }
+
+    if (in_string == true) {
+      if (in_escape_sequence == true) {
+        in_escape_sequence = false;
+      } else if (cur_char == character_constants::k_escape_leader) {
+        in_escape_sequence = true;
+      } else if (cur_char == character_constants::k_string_delimiter) {
+        in_string = false;
+      }
+    } else if (cur_char == character_constants::k_string_delimiter) {
+      in_string = true;
+    } else if ((cur_char == character_constants::k_map_opening_delimiter) ||
+               (cur_char == character_constants::k_array_opening_delimiter)) {
+      ++depth;
+    } else if (depth > 0) {
+      if ((cur_char == character_constants::k_map_closing_delimiter) ||
+          (cur_char == character_constants::k_array_closing_delimiter)) {
+        --depth;
+      }
+    } else if (stop_chars.find(cur_char) != std::string_view::npos) {
+      return cur_char;
+    }
+  }
+}
+
+void libconfigfile::parser::impl::skip_to_end_of_line(
+    context &ctx, const std::size_t line_offset) {
+  ctx.source.rewind(line_offset);
+  ctx.input_stream.clear();
+
+  char cur_char{};
+  while (true) {
+    ctx.input_stream.get(cur_char);
+    if (ctx.input_stream.eof() == true) {
+      return;
+    } else if (cur_char == character_constants::k_newline) {
+      ctx.input_stream.unget();
+      return;
+    }
+  }
+}
+
+bool libconfigfile::parser::impl::is_split_by_newline_error(
+    const parse_error &error) {
+  switch (error.code()) {
+  case error_code::err_1_2_3:
+  case error_code::err_1_3_2:
+  case error_code::err_1_4_4:
+  case error_code::err_1_5_9: {
+    return true;
+  } break;
+  default: {
+    return false;
+  } break;
+  }
+}
+
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::node>>
 libconfigfile::parser::impl::call_appropriate_value_parse_func(
     context &ctx, const std::string_view possible_terminating_chars,
     char *actual_terminating_char /*= nullptr*/) {
 
-  node_type value_type{identify_key_value_value_type(
+  const parse_result<node_type> value_type_result{identify_key_value_value_type(
       ctx, possible_terminating_chars, actual_terminating_char)};
+  if (value_type_result.has_value() == false) {
+    return std::unexpected{value_type_result.error()};
+  }
+  const node_type value_type{value_type_result.value()};
 
   switch (value_type) {
-  case node_type::Map: {
-    return node_ptr_cast<node>(parse_map_value(ctx, possible_terminating_chars,
-                                               actual_terminating_char));
+  case node_type::Map:
+  case node_type::Array: {
+    return parse_container_value(ctx, value_type, possible_terminating_chars,
+                                 actual_terminating_char);
   } break;
 
-  case node_type::Array: {
-    return node_ptr_cast<node>(parse_array_value(
-        ctx, possible_terminating_chars, actual_terminating_char));
+  default: {
+    return call_appropriate_scalar_value_parse_func(
+        ctx, value_type, possible_terminating_chars, actual_terminating_char);
   } break;
+  }
+}
+
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::node>>
+libconfigfile::parser::impl::call_appropriate_scalar_value_parse_func(
+    context &ctx, const node_type type,
+    const std::string_view possible_terminating_chars,
+    char *actual_terminating_char /*= nullptr*/) {
+  if (parse_result<void> counted{count_node(ctx)};
+      counted.has_value() == false) {
+    return std::unexpected{std::move(counted.error())};
+  }
 
+  switch (type) {
   case node_type::String: {
-    return node_ptr_cast<node>(parse_string_value(
-        ctx, possible_terminating_chars, actual_terminating_char));
+    return parse_string_value(ctx, possible_terminating_chars,
+                              actual_terminating_char);
   } break;
 
   case node_type::Integer: {
-    return node_ptr_cast<node>(parse_integer_value(
-        ctx, possible_terminating_chars, actual_terminating_char));
+    return parse_integer_value(ctx, possible_terminating_chars,
+                               actual_terminating_char);
   } break;
 
   case node_type::Float: {
-    return node_ptr_cast<node>(parse_float_value(
-        ctx, possible_terminating_chars, actual_terminating_char));
+    return parse_float_value(ctx, possible_terminating_chars,
+                             actual_terminating_char);
   } break;
 
   default: {
@@ -1582,11 +2690,12 @@ libconfigfile::parser::impl::call_appropriate_value_parse_func(
   }
 }
 
-std::pair<libconfigfile::parser::impl::directive,
-          std::optional<libconfigfile::node_ptr<libconfigfile::map_node>>>
-libconfigfile::parser::impl::parse_directive(context &ctx) {
-  const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-      start_pos_count{ctx.line_count, ctx.char_count};
+libconfigfile::parser::impl::parse_result<
+    std::pair<libconfigfile::parser::impl::directive,
+              std::optional<libconfigfile::node_ptr<libconfigfile::map_node>>>>
+libconfigfile::parser::impl::parse_directive(
+    context &ctx, key_set *included_keys /*= nullptr*/) {
+  bool skipped_newline{false};
 
   std::string name{};
   name.reserve(character_constants::k_max_directive_name_length);
@@ -1604,26 +2713,25 @@ libconfigfile::parser::impl::parse_directive(context &ctx) {
     char cur_char{};
     bool eof{false};
     bool handled_comment_in_name_proper{};
-    std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-        pos_count_before_handled_comment_in_name_proper{};
+    std::size_t offset_before_handled_comment_in_name_proper{};
     while (true) {
       if (last_state == name_location::name_proper) {
-        pos_count_before_handled_comment_in_name_proper = {ctx.line_count,
-                                                           ctx.char_count};
-        handled_comment_in_name_proper = handle_comments(ctx);
-      } else {
-        handle_comments(ctx);
+        offset_before_handled_comment_in_name_proper = ctx.source.offset();
+      }
+      parse_result<bool> comment_result{handle_comments(ctx)};
+      if (comment_result.has_value() == false) {
+        return std::unexpected{std::move(comment_result.error())};
+      } else if (last_state == name_location::name_proper) {
+        handled_comment_in_name_proper = comment_result.value();
       }
       ctx.input_stream.get(cur_char);
       if (ctx.input_stream.eof() == true) {
         eof = true;
         break;
       } else if (cur_char == character_constants::k_newline) {
-        ++ctx.line_count;
-        ctx.char_count = 0;
+        skipped_newline = true;
         continue;
       } else {
-        ++ctx.char_count;
         break;
       }
     }
@@ -1632,9 +2740,8 @@ libconfigfile::parser::impl::parse_directive(context &ctx) {
 
     case name_location::directive_leader: {
       if (eof == true) {
-        throw syntax_error{error_messages::err_msg_1_8_3.message,
-                           error_messages::err_msg_1_8_3.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_8_3)};
       } else {
         if (cur_char == character_constants::k_directive_leader) {
           ;
@@ -1644,10 +2751,9 @@ libconfigfile::parser::impl::parse_directive(context &ctx) {
           last_state = name_location::leading_whitespace;
           ;
         } else {
-          if (ctx.line_count != start_pos_count.first) {
-            throw syntax_error{error_messages::err_msg_1_8_2.message,
-                               error_messages::err_msg_1_8_2.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+          if (skipped_newline == true) {
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_8_2)};
           } else {
             last_state = name_location::name_proper;
             name.push_back(cur_char);
@@ -1658,18 +2764,16 @@ libconfigfile::parser::impl::parse_directive(context &ctx) {
 
     case name_location::leading_whitespace: {
       if (eof == true) {
-        throw syntax_error{error_messages::err_msg_1_8_3.message,
-                           error_messages::err_msg_1_8_3.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_8_3)};
       } else {
         if (is_whitespace(cur_char, character_constants::k_whitespace_chars) ==
             true) {
           ;
         } else {
-          if (ctx.line_count != start_pos_count.first) {
-            throw syntax_error{error_messages::err_msg_1_8_2.message,
-                               error_messages::err_msg_1_8_2.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+          if (skipped_newline == true) {
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_8_2)};
           } else {
             last_state = name_location::name_proper;
             name.push_back(cur_char);
@@ -1686,16 +2790,13 @@ libconfigfile::parser::impl::parse_directive(context &ctx) {
             true) {
           last_state = name_location::done;
         } else {
-          if (ctx.line_count != start_pos_count.first) {
-            throw syntax_error{error_messages::err_msg_1_8_2.message,
-                               error_messages::err_msg_1_8_2.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+          if (skipped_newline == true) {
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_8_2)};
           } else if (handled_comment_in_name_proper == true) {
-            throw syntax_error{
-                error_messages::err_msg_1_8_4.message,
-                error_messages::err_msg_1_8_4.category, ctx.identifier,
-                pos_count_before_handled_comment_in_name_proper.first,
-                pos_count_before_handled_comment_in_name_proper.second};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_8_4,
+                offset_before_handled_comment_in_name_proper)};
           } else {
             name.push_back(cur_char);
           }
@@ -1707,6 +2808,11 @@ libconfigfile::parser::impl::parse_directive(context &ctx) {
       throw bits_and_bytes::unreachable_error{};
     } break;
     }
+
+    if (parse_result<void> checked{check_string_length(ctx, name)};
+        checked.has_value() == false) {
+      return std::unexpected{std::move(checked.error())};
+    }
   }
 
   directive directive_func_to_call{directive::null};
@@ -1716,18 +2822,27 @@ libconfigfile::parser::impl::parse_directive(context &ctx) {
   } else if (name == character_constants::k_include_directive_name) {
     directive_func_to_call = directive::include;
   } else {
-    throw syntax_error{error_messages::err_msg_1_8_1.message,
-                       error_messages::err_msg_1_8_1.category, ctx.identifier,
-                       ctx.line_count, ctx.char_count};
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_1_8_1)};
   }
 
   switch (directive_func_to_call) {
   case directive::version: {
-    parse_version_directive(ctx);
-    return {directive::version, std::nullopt};
+    if (parse_result<void> parsed{parse_version_directive(ctx)};
+        parsed.has_value() == false) {
+      return std::unexpected{std::move(parsed.error())};
+    }
+    return std::pair<directive, std::optional<node_ptr<map_node>>>{
+        directive::version, std::nullopt};
   } break;
   case directive::include: {
-    return {directive::include, parse_include_directive(ctx)};
+    parse_result<node_ptr<map_node>> included{
+        parse_include_directive(ctx, included_keys)};
+    if (included.has_value() == false) {
+      return std::unexpected{std::move(included.error())};
+    }
+    return std::pair<directive, std::optional<node_ptr<map_node>>>{
+        directive::include, std::move(included.value())};
   } break;
   default: {
     throw bits_and_bytes::unreachable_error{};
@@ -1735,9 +2850,9 @@ libconfigfile::parser::impl::parse_directive(context &ctx) {
   }
 }
 
-void libconfigfile::parser::impl::parse_version_directive(context &ctx) {
-  const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-      start_pos_count{ctx.line_count, ctx.char_count};
+libconfigfile::parser::impl::parse_result<void>
+libconfigfile::parser::impl::parse_version_directive(context &ctx) {
+  bool skipped_newline{false};
 
   std::string version_str{};
 
@@ -1750,8 +2865,7 @@ void libconfigfile::parser::impl::parse_version_directive(context &ctx) {
     done,
   };
 
-  std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-      start_of_version_str_pos_count{};
+  std::size_t start_of_version_str_offset{};
 
   for (args_location last_state{args_location::leading_whitespace};
        last_state != args_location::done;) {
@@ -1761,18 +2875,19 @@ void libconfigfile::parser::impl::parse_version_directive(context &ctx) {
     while (true) {
       if ((last_state != args_location::opening_delimiter) &&
           (last_state != args_location::version_str)) {
-        handle_comments(ctx);
+        if (parse_result<bool> comment_result{handle_comments(ctx)};
+            comment_result.has_value() == false) {
+          return std::unexpected{std::move(comment_result.error())};
+        }
       }
       ctx.input_stream.get(cur_char);
       if (ctx.input_stream.eof() == true) {
         eof = true;
         break;
       } else if (cur_char == character_constants::k_newline) {
-        ++ctx.line_count;
-        ctx.char_count = 0;
+        skipped_newline = true;
         continue;
       } else {
-        ++ctx.char_count;
         break;
       }
     }
@@ -1780,47 +2895,42 @@ void libconfigfile::parser::impl::parse_version_directive(context &ctx) {
 
     case args_location::leading_whitespace: {
       if (eof == true) {
-        throw syntax_error{error_messages::err_msg_1_8_13.message,
-                           error_messages::err_msg_1_8_13.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(
+            ctx, error_messages::err_msg_1_8_13)};
       } else {
         if (is_whitespace(cur_char, character_constants::k_whitespace_chars) ==
             true) {
           ;
         } else if (cur_char == character_constants::k_string_delimiter) {
-          if (start_pos_count.first != ctx.line_count) {
-            throw syntax_error{error_messages::err_msg_1_8_2.message,
-                               error_messages::err_msg_1_8_2.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+          if (skipped_newline == true) {
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_8_2)};
           } else {
             last_state = args_location::opening_delimiter;
           }
         } else {
-          throw syntax_error{error_messages::err_msg_1_8_13.message,
-                             error_messages::err_msg_1_8_13.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_8_13)};
         }
       }
     } break;
 
     case args_location::opening_delimiter: {
       if (eof == true) {
-        throw syntax_error{error_messages::err_msg_1_8_14.message,
-                           error_messages::err_msg_1_8_14.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(
+            ctx, error_messages::err_msg_1_8_14)};
       } else {
-        if (start_pos_count.first != ctx.line_count) {
-          throw syntax_error{error_messages::err_msg_1_8_2.message,
-                             error_messages::err_msg_1_8_2.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+        if (skipped_newline == true) {
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_8_2)};
         } else {
           if (cur_char == character_constants::k_string_delimiter) {
             last_state = args_location::closing_delimiter;
-            start_of_version_str_pos_count = {ctx.line_count, ctx.char_count};
+            start_of_version_str_offset = ctx.source.offset();
           } else {
             version_str.push_back(cur_char);
             last_state = args_location::version_str;
-            start_of_version_str_pos_count = {ctx.line_count, ctx.char_count};
+            start_of_version_str_offset = ctx.source.offset();
           }
         }
       }
@@ -1828,14 +2938,12 @@ void libconfigfile::parser::impl::parse_version_directive(context &ctx) {
 
     case args_location::version_str: {
       if (eof == true) {
-        throw syntax_error{error_messages::err_msg_1_8_14.message,
-                           error_messages::err_msg_1_8_14.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(
+            ctx, error_messages::err_msg_1_8_14)};
       } else {
-        if (start_pos_count.first != ctx.line_count) {
-          throw syntax_error{error_messages::err_msg_1_8_2.message,
-                             error_messages::err_msg_1_8_2.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+        if (skipped_newline == true) {
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_8_2)};
         } else {
           if (cur_char == character_constants::k_string_delimiter) {
             last_state = args_location::closing_delimiter;
@@ -1850,18 +2958,16 @@ void libconfigfile::parser::impl::parse_version_directive(context &ctx) {
       if (eof == true) {
         last_state = args_location::done;
       } else {
-        if (start_pos_count.first != ctx.line_count) {
+        if (skipped_newline == true) {
           last_state = args_location::done;
           ctx.input_stream.unget();
-          --ctx.char_count;
         } else {
           if (is_whitespace(cur_char,
                             character_constants::k_whitespace_chars) == true) {
             last_state = args_location::trailing_whitespace;
           } else {
-            throw syntax_error{error_messages::err_msg_1_8_11.message,
-                               error_messages::err_msg_1_8_11.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_8_11)};
           }
         }
       }
@@ -1871,18 +2977,16 @@ void libconfigfile::parser::impl::parse_version_directive(context &ctx) {
       if (eof == true) {
         last_state = args_location::done;
       } else {
-        if (start_pos_count.first != ctx.line_count) {
+        if (skipped_newline == true) {
           last_state = args_location::done;
           ctx.input_stream.unget();
-          --ctx.char_count;
         } else {
           if (is_whitespace(cur_char,
                             character_constants::k_whitespace_chars) == true) {
             ;
           } else {
-            throw syntax_error{error_messages::err_msg_1_8_11.message,
-                               error_messages::err_msg_1_8_11.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_8_11)};
           }
         }
       }
@@ -1892,28 +2996,32 @@ void libconfigfile::parser::impl::parse_version_directive(context &ctx) {
       throw bits_and_bytes::unreachable_error{};
     } break;
     }
+
+    if (parse_result<void> checked{check_string_length(ctx, version_str)};
+        checked.has_value() == false) {
+      return std::unexpected{std::move(checked.error())};
+    }
   }
 
   if (version_str.empty() == true) {
-    throw syntax_error{error_messages::err_msg_1_8_12.message,
-                       error_messages::err_msg_1_8_12.category, ctx.identifier,
-                       ctx.line_count, ctx.char_count};
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_1_8_12)};
   } else {
     if (version_str == k_version) {
-      return;
+      return {};
     } else {
-      throw syntax_error{error_messages::err_msg_1_8_10.message,
-                         error_messages::err_msg_1_8_10.category,
-                         ctx.identifier, start_of_version_str_pos_count.first,
-                         start_of_version_str_pos_count.second};
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_8_10,
+                                              start_of_version_str_offset)};
     }
   }
 }
 
-libconfigfile::node_ptr<libconfigfile::map_node>
-libconfigfile::parser::impl::parse_include_directive(context &ctx) {
-  const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-      start_pos_count{ctx.line_count, ctx.char_count};
+libconfigfile::parser::impl::parse_result<
+    libconfigfile::node_ptr<libconfigfile::map_node>>
+libconfigfile::parser::impl::parse_include_directive(
+    context &ctx, key_set *included_keys /*= nullptr*/) {
+  bool skipped_newline{false};
 
   std::string file_path_str{};
 
@@ -1926,8 +3034,7 @@ libconfigfile::parser::impl::parse_include_directive(context &ctx) {
     done,
   };
 
-  std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-      start_of_file_path_str_pos_count{};
+  std::size_t start_of_file_path_str_offset{};
 
   bool last_char_was_escape_leader{false};
 
@@ -1939,18 +3046,19 @@ libconfigfile::parser::impl::parse_include_directive(context &ctx) {
     while (true) {
       if ((last_state != args_location::opening_delimiter) &&
           (last_state != args_location::file_path)) {
-        handle_comments(ctx);
+        if (parse_result<bool> comment_result{handle_comments(ctx)};
+            comment_result.has_value() == false) {
+          return std::unexpected{std::move(comment_result.error())};
+        }
       }
       ctx.input_stream.get(cur_char);
       if (ctx.input_stream.eof() == true) {
         eof = true;
         break;
       } else if (cur_char == character_constants::k_newline) {
-        ++ctx.line_count;
-        ctx.char_count = 0;
+        skipped_newline = true;
         continue;
       } else {
-        ++ctx.char_count;
         break;
       }
     }
@@ -1959,52 +3067,47 @@ libconfigfile::parser::impl::parse_include_directive(context &ctx) {
 
     case args_location::leading_whitespace: {
       if (eof == true) {
-        throw syntax_error{error_messages::err_msg_1_8_7.message,
-                           error_messages::err_msg_1_8_7.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_8_7)};
       } else {
         if (is_whitespace(cur_char, character_constants::k_whitespace_chars) ==
             true) {
           ;
         } else if (cur_char == character_constants::k_string_delimiter) {
-          if (start_pos_count.first != ctx.line_count) {
-            throw syntax_error{error_messages::err_msg_1_8_2.message,
-                               error_messages::err_msg_1_8_2.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+          if (skipped_newline == true) {
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_8_2)};
           } else {
             last_state = args_location::opening_delimiter;
           }
         } else {
-          throw syntax_error{error_messages::err_msg_1_8_7.message,
-                             error_messages::err_msg_1_8_7.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_8_7)};
         }
       }
     } break;
 
     case args_location::opening_delimiter: {
       if (eof == true) {
-        throw syntax_error{error_messages::err_msg_1_8_8.message,
-                           error_messages::err_msg_1_8_8.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_8_8)};
       } else {
-        if (start_pos_count.first != ctx.line_count) {
-          throw syntax_error{error_messages::err_msg_1_8_2.message,
-                             error_messages::err_msg_1_8_2.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+        if (skipped_newline == true) {
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_8_2)};
         } else {
           if (cur_char == character_constants::k_string_delimiter) {
             last_state = args_location::closing_delimiter;
-            start_of_file_path_str_pos_count = {ctx.line_count, ctx.char_count};
+            start_of_file_path_str_offset = ctx.source.offset();
           } else if (cur_char == character_constants::k_escape_leader) {
             last_char_was_escape_leader = true;
             file_path_str.push_back(cur_char);
             last_state = args_location::file_path;
-            start_of_file_path_str_pos_count = {ctx.line_count, ctx.char_count};
+            start_of_file_path_str_offset = ctx.source.offset();
           } else {
             file_path_str.push_back(cur_char);
             last_state = args_location::file_path;
-            start_of_file_path_str_pos_count = {ctx.line_count, ctx.char_count};
+            start_of_file_path_str_offset = ctx.source.offset();
           }
         }
       }
@@ -2012,14 +3115,12 @@ libconfigfile::parser::impl::parse_include_directive(context &ctx) {
 
     case args_location::file_path: {
       if (eof == true) {
-        throw syntax_error{error_messages::err_msg_1_8_8.message,
-                           error_messages::err_msg_1_8_8.category,
-                           ctx.identifier, ctx.line_count, ctx.char_count};
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_8_8)};
       } else {
-        if (start_pos_count.first != ctx.line_count) {
-          throw syntax_error{error_messages::err_msg_1_8_2.message,
-                             error_messages::err_msg_1_8_2.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+        if (skipped_newline == true) {
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_8_2)};
         } else {
           if (cur_char == character_constants::k_string_delimiter) {
             if (last_char_was_escape_leader == true) {
@@ -2045,18 +3146,16 @@ libconfigfile::parser::impl::parse_include_directive(context &ctx) {
       if (eof == true) {
         last_state = args_location::done;
       } else {
-        if (start_pos_count.first != ctx.line_count) {
+        if (skipped_newline == true) {
           last_state = args_location::done;
           ctx.input_stream.unget();
-          --ctx.char_count;
         } else {
           if (is_whitespace(cur_char,
                             character_constants::k_whitespace_chars) == true) {
             last_state = args_location::trailing_whitespace;
           } else {
-            throw syntax_error{error_messages::err_msg_1_8_9.message,
-                               error_messages::err_msg_1_8_9.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_8_9)};
           }
         }
       }
@@ -2066,18 +3165,16 @@ libconfigfile::parser::impl::parse_include_directive(context &ctx) {
       if (eof == true) {
         last_state = args_location::done;
       } else {
-        if (start_pos_count.first != ctx.line_count) {
+        if (skipped_newline == true) {
           last_state = args_location::done;
           ctx.input_stream.unget();
-          --ctx.char_count;
         } else {
           if (is_whitespace(cur_char,
                             character_constants::k_whitespace_chars) == true) {
             ;
           } else {
-            throw syntax_error{error_messages::err_msg_1_8_9.message,
-                               error_messages::err_msg_1_8_9.category,
-                               ctx.identifier, ctx.line_count, ctx.char_count};
+            return std::unexpected{make_parse_error(
+                ctx, error_messages::err_msg_1_8_9)};
           }
         }
       }
@@ -2087,42 +3184,61 @@ libconfigfile::parser::impl::parse_include_directive(context &ctx) {
       throw bits_and_bytes::unreachable_error{};
     } break;
     }
+
+    if (parse_result<void> checked{check_string_length(ctx, file_path_str)};
+        checked.has_value() == false) {
+      return std::unexpected{std::move(checked.error())};
+    }
   }
 
   if (file_path_str.empty() == true) {
-    throw syntax_error{error_messages::err_msg_1_8_6.message,
-                       error_messages::err_msg_1_8_6.category, ctx.identifier,
-                       ctx.line_count, ctx.char_count};
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_1_8_6)};
   } else {
     std::variant<std::string, std::string::size_type> file_path_escaped{
         replace_escape_sequences(file_path_str)};
 
     switch (file_path_escaped.index()) {
     case 0: {
-      std::filesystem::path const file_path{
+      std::filesystem::path file_path{
           std::get<std::string>(std::move(file_path_escaped))};
-      if (file_path.is_absolute()) {
-        return parser::parse_file(file_path);
-      } else if (ctx.identifier_is_file_path == true) {
-        return parser::parse_file(std::filesystem::path{
-            std::filesystem::path{ctx.identifier}.parent_path() / file_path});
-      } else {
-        return parser::parse_file(file_path);
+      if ((file_path.is_relative()) &&
+          (ctx.identifier_is_file_path == true)) {
+        file_path =
+            std::filesystem::path{ctx.identifier}.parent_path() / file_path;
+      }
+      if ((++(ctx.budget->include_count)) > ctx.options.max_include_count) {
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_3_4_1)};
+      } else if (ctx.budget->include_depth >= ctx.options.max_include_depth) {
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_3_4_2)};
+      } else if (parse_result<void> in_time{check_deadline(ctx)};
+                 in_time.has_value() == false) {
+        return std::unexpected{std::move(in_time.error())};
+      }
+
+      if (ctx.included_file_paths != nullptr) {
+        ctx.included_file_paths->push_back(file_path);
       }
+
+      ++(ctx.budget->include_depth);
+      parse_result<node_ptr<map_node>> ret_val{
+          impl::parse_file(file_path, ctx.options, ctx.included_file_paths,
+                           ctx.budget, ctx.errors, included_keys,
+                           ctx.validate_only)};
+      --(ctx.budget->include_depth);
+      return ret_val;
     } break;
 
     case 1: {
-      const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-          invalid_escape_sequence_pos_count{
-              start_of_file_path_str_pos_count.first,
-              static_cast<decltype(ctx.char_count)>(
-                  start_of_file_path_str_pos_count.second +
-                  std::get<std::string::size_type>(file_path_escaped))};
-
-      throw syntax_error{error_messages::err_msg_1_8_5.message,
-                         error_messages::err_msg_1_8_5.category, ctx.identifier,
-                         invalid_escape_sequence_pos_count.first,
-                         invalid_escape_sequence_pos_count.second};
+      const std::size_t invalid_escape_sequence_offset{
+          start_of_file_path_str_offset +
+          std::get<std::string::size_type>(file_path_escaped)};
+
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_8_5,
+                                              invalid_escape_sequence_offset)};
     } break;
 
     default: {
@@ -2132,7 +3248,8 @@ libconfigfile::parser::impl::parse_include_directive(context &ctx) {
   }
 }
 
-bool libconfigfile::parser::impl::handle_comments(context &ctx) {
+libconfigfile::parser::impl::parse_result<bool>
+libconfigfile::parser::impl::handle_comments(context &ctx) {
   static_assert(character_constants::k_comment_cpp.front() ==
                 character_constants::k_comment_c_start.front());
   static_assert(character_constants::k_comment_cpp.size() == 2);
@@ -2148,11 +3265,9 @@ bool libconfigfile::parser::impl::handle_comments(context &ctx) {
 
   case character_constants::k_comment_script: {
     ctx.input_stream.get(cur_char);
-    ++ctx.char_count;
 
     while (true) {
       ctx.input_stream.get(cur_char);
-      ++ctx.char_count;
       if (ctx.input_stream.eof() == true) {
         return true;
       } else if (cur_char == character_constants::k_newline) {
@@ -2164,17 +3279,14 @@ bool libconfigfile::parser::impl::handle_comments(context &ctx) {
 
   case k_c_or_cpp_comment_leader: {
     ctx.input_stream.get(cur_char);
-    ++ctx.char_count;
     peek_char = (ctx.input_stream.peek());
 
     switch (peek_char) {
     case character_constants::k_comment_cpp.back(): {
       ctx.input_stream.get(cur_char);
-      ++ctx.char_count;
 
       while (true) {
         ctx.input_stream.get(cur_char);
-        ++ctx.char_count;
         if (ctx.input_stream.eof() == true) {
           return true;
         } else if (cur_char == character_constants::k_newline) {
@@ -2187,22 +3299,15 @@ bool libconfigfile::parser::impl::handle_comments(context &ctx) {
 
     case character_constants::k_comment_c_start.back(): {
       ctx.input_stream.get(cur_char);
-      ++ctx.char_count;
       while (true) {
         ctx.input_stream.get(cur_char);
-        ++ctx.char_count;
         if (ctx.input_stream.eof() == true) {
-          throw syntax_error{error_messages::err_msg_1_1_1.message,
-                             error_messages::err_msg_1_1_1.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
-        } else if (cur_char == character_constants::k_newline) {
-          ++ctx.line_count;
-          ctx.char_count = 0;
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_1_1)};
         } else if (cur_char == character_constants::k_comment_c_end.front()) {
           if (static_cast<char>(ctx.input_stream.peek()) ==
               character_constants::k_comment_c_end.back()) {
             ctx.input_stream.get();
-            ++ctx.char_count;
             return true;
           }
         }
@@ -2211,7 +3316,6 @@ bool libconfigfile::parser::impl::handle_comments(context &ctx) {
 
     default: {
       ctx.input_stream.unget();
-      --ctx.char_count;
       return false;
     } break;
     }
@@ -2223,55 +3327,41 @@ bool libconfigfile::parser::impl::handle_comments(context &ctx) {
   }
 }
 
-char libconfigfile::parser::impl::handle_escape_sequence(context &ctx) {
+libconfigfile::parser::impl::parse_result<char>
+libconfigfile::parser::impl::handle_escape_sequence(context &ctx) {
   char escape_leader_char{};
   ctx.input_stream.get(escape_leader_char);
-  if (ctx.input_stream.eof() == false) {
-    ++ctx.char_count;
-  }
 
   if (escape_leader_char == character_constants::k_escape_leader) {
     char escape_char_1{};
     ctx.input_stream.get(escape_char_1);
 
     if (ctx.input_stream.eof() == true) {
-      throw syntax_error{error_messages::err_msg_1_9_1.message,
-                         error_messages::err_msg_1_9_1.category, ctx.identifier,
-                         ctx.line_count, ctx.char_count};
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_9_1)};
     } else if (escape_char_1 == character_constants::k_newline) {
-      throw syntax_error{error_messages::err_msg_1_9_1.message,
-                         error_messages::err_msg_1_9_1.category, ctx.identifier,
-                         ctx.line_count, ctx.char_count};
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_9_1)};
     } else {
-      ++ctx.char_count;
-
       if (escape_char_1 == character_constants::k_hex_escape_char) {
         char hex_digit_1{};
         ctx.input_stream.get(hex_digit_1);
         if (ctx.input_stream.eof() == true) {
-          throw syntax_error{error_messages::err_msg_1_9_1.message,
-                             error_messages::err_msg_1_9_1.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_9_1)};
         } else if (hex_digit_1 == character_constants::k_newline) {
-          throw syntax_error{error_messages::err_msg_1_9_1.message,
-                             error_messages::err_msg_1_9_1.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
-        } else {
-          ++ctx.char_count;
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_9_1)};
         }
 
         char hex_digit_2{};
         ctx.input_stream.get(hex_digit_2);
         if (ctx.input_stream.eof() == true) {
-          throw syntax_error{error_messages::err_msg_1_9_1.message,
-                             error_messages::err_msg_1_9_1.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_9_1)};
         } else if (hex_digit_2 == character_constants::k_newline) {
-          throw syntax_error{error_messages::err_msg_1_9_1.message,
-                             error_messages::err_msg_1_9_1.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
-        } else {
-          ++ctx.char_count;
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_9_1)};
         }
 
         if ((numeral_system_hexadecimal.is_digit(hex_digit_1)) &&
@@ -2284,90 +3374,72 @@ char libconfigfile::parser::impl::handle_escape_sequence(context &ctx) {
                           numeral_system_hexadecimal.base);
           return static_cast<char>(ret_val);
         } else {
-          throw syntax_error{error_messages::err_msg_1_9_4.message,
-                             error_messages::err_msg_1_9_4.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_9_4)};
         }
       } else {
         if (character_constants::k_basic_escape_chars.contains(escape_char_1)) {
           return character_constants::k_basic_escape_chars.at(escape_char_1);
         } else {
-          throw syntax_error{error_messages::err_msg_1_9_2.message,
-                             error_messages::err_msg_1_9_2.category,
-                             ctx.identifier, ctx.line_count, ctx.char_count};
+          return std::unexpected{make_parse_error(
+              ctx, error_messages::err_msg_1_9_2)};
         }
       }
     }
   } else {
-    throw syntax_error{error_messages::err_msg_1_9_3.message,
-                       error_messages::err_msg_1_9_3.category, ctx.identifier,
-                       ctx.line_count, ctx.char_count};
+    return std::unexpected{make_parse_error(ctx,
+                                            error_messages::err_msg_1_9_3)};
   }
 }
 
-libconfigfile::node_type
+libconfigfile::parser::impl::parse_result<libconfigfile::node_type>
 libconfigfile::parser::impl::identify_key_value_value_type(
     context &ctx, const std::string_view possible_terminating_chars,
     char *actual_terminating_char /*= nullptr*/) {
 
-  std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-      pos_count_at_start{ctx.line_count, ctx.char_count};
+  const std::size_t offset_at_start{ctx.source.offset()};
 
-  std::string gotten_chars{};
   char cur_char{};
   bool eof{false};
 
-  const auto reset_context{[&ctx, &gotten_chars, &pos_count_at_start]() {
-    if (gotten_chars.empty() == false) {
-      for (auto i{gotten_chars.rbegin()}; i != gotten_chars.rend(); ++i) {
-        ctx.input_stream.putback(*i);
-      }
-    }
-    ctx.line_count = pos_count_at_start.first;
-    ctx.char_count = pos_count_at_start.second;
+  const auto reset_context{[&ctx, offset_at_start]() {
+    ctx.source.rewind(offset_at_start);
+    ctx.input_stream.clear();
   }};
 
   while (true) {
     while (true) {
-      handle_comments(ctx);
+      if (parse_result<bool> comment_result{handle_comments(ctx)};
+          comment_result.has_value() == false) {
+        return std::unexpected{std::move(comment_result.error())};
+      }
       ctx.input_stream.get(cur_char);
       if (ctx.input_stream.eof() == true) {
         eof = true;
         break;
       } else if (cur_char == character_constants::k_newline) {
-        ++ctx.line_count;
-        ctx.char_count = 0;
         continue;
       } else {
-        ++ctx.char_count;
         break;
       }
     }
 
     if (eof == true) {
-      const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-          pos_count_at_error{ctx.line_count, ctx.char_count};
-
       reset_context();
 
-      throw syntax_error{error_messages::err_msg_1_2_5.message,
-                         error_messages::err_msg_1_2_5.category, ctx.identifier,
-                         ctx.line_count, ctx.char_count};
+      return std::unexpected{make_parse_error(ctx,
+                                              error_messages::err_msg_1_2_5)};
     } else {
-      gotten_chars.push_back(cur_char);
-
       if (is_whitespace(cur_char) == true) {
         continue;
       } else if (cur_char == character_constants::k_key_value_terminate) {
-        const std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-            pos_count_at_error{ctx.line_count, ctx.char_count};
+        const std::size_t offset_at_error{ctx.source.offset()};
 
         reset_context();
 
-        throw syntax_error{error_messages::err_msg_1_2_5.message,
-                           error_messages::err_msg_1_2_5.category,
-                           ctx.identifier, pos_count_at_start.first,
-                           pos_count_at_error.second};
+        return std::unexpected{make_parse_error(ctx,
+                                                error_messages::err_msg_1_2_5,
+                                                offset_at_error)};
       } else {
         reset_context();
 
@@ -2394,28 +3466,27 @@ libconfigfile::parser::impl::identify_key_value_value_type(
   }
 }
 
-libconfigfile::node_type
+libconfigfile::parser::impl::parse_result<libconfigfile::node_type>
 libconfigfile::parser::impl::identify_key_value_numeric_value_type(
     context &ctx, const std::string_view possible_terminating_chars,
     char *actual_terminating_char /*= nullptr*/) {
 
   std::string gotten_chars{};
-  std::pair<decltype(ctx.line_count), decltype(ctx.char_count)>
-      pos_count_at_start{ctx.line_count, ctx.char_count};
+  const std::size_t offset_at_start{ctx.source.offset()};
   char cur_char{};
   while (true) {
-    handle_comments(ctx);
+    if (parse_result<bool> comment_result{handle_comments(ctx)};
+        comment_result.has_value() == false) {
+      return std::unexpected{std::move(comment_result.error())};
+    }
     ctx.input_stream.get(cur_char);
     if (ctx.input_stream.eof() == true) {
       break;
     } else {
       gotten_chars.push_back(cur_char);
       if (cur_char == character_constants::k_newline) {
-        ++ctx.line_count;
-        ctx.char_count = 0;
         continue;
       } else {
-        ++ctx.char_count;
         if (possible_terminating_chars.find(cur_char) != std::string::npos) {
           if (actual_terminating_char != nullptr) {
             *actual_terminating_char = cur_char;
@@ -2426,14 +3497,9 @@ libconfigfile::parser::impl::identify_key_value_numeric_value_type(
     }
   }
 
-  const auto reset_context{[&ctx, &gotten_chars, &pos_count_at_start]() {
-    if (gotten_chars.empty() == false) {
-      for (auto i{gotten_chars.rbegin()}; i != gotten_chars.rend(); ++i) {
-        ctx.input_stream.putback(*i);
-      }
-    }
-    ctx.line_count = pos_count_at_start.first;
-    ctx.char_count = pos_count_at_start.second;
+  const auto reset_context{[&ctx, offset_at_start]() {
+    ctx.source.rewind(offset_at_start);
+    ctx.input_stream.clear();
   }};
 
   const auto cleanup_and_return{[&reset_context](const node_type ret_val) {
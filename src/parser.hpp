@@ -3,38 +3,214 @@
 
 #include "array_node.hpp"
 #include "character_constants.hpp"
+#include "error_messages.hpp"
 #include "float_node.hpp"
 #include "integer_node.hpp"
+#include "key_hash.hpp"
+#include "lazy_subtree.hpp"
 #include "map_node.hpp"
+#include "newline_index.hpp"
 #include "node.hpp"
 #include "node_ptr.hpp"
 #include "node_types.hpp"
+#include "parse_error.hpp"
+#include "source_map.hpp"
 #include "string_node.hpp"
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
 #include <filesystem>
+#include <functional>
 #include <istream>
+#include <limits>
+#include <memory>
 #include <optional>
+#include <streambuf>
 #include <string>
 #include <string_view>
+#include <unordered_set>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace libconfigfile {
 namespace parser {
+struct parse_options {
+  static constexpr std::size_t k_unlimited{
+      std::numeric_limits<std::size_t>::max()};
+  static constexpr std::size_t k_default_max_nesting_depth{256};
+  static constexpr std::size_t k_default_max_include_depth{64};
+  static constexpr std::size_t k_default_max_error_count{100};
+
+  // Parsing doesn't recurse, but destroying, copying, serializing, hashing
+  // and comparing the tree do, once per level, so this also bounds their
+  // stack use.
+  std::size_t max_nesting_depth{k_default_max_nesting_depth};
+  std::size_t max_input_bytes{k_unlimited};
+  std::size_t max_node_count{k_unlimited};
+  std::size_t max_include_count{k_unlimited};
+  std::size_t max_include_depth{k_default_max_include_depth};
+  std::size_t max_string_length{k_unlimited};
+  std::optional<std::chrono::steady_clock::time_point> deadline{};
+  std::size_t max_error_count{k_default_max_error_count};
+  source_map *spans{nullptr};
+  std::vector<std::string> key_paths{};
+  bool check_skipped_values{true};
+  bool lazy_containers{false};
+  bool use_cache{false};
+};
+
+struct recovery_result {
+  node_ptr<map_node> value;
+  std::vector<parse_error> errors;
+};
+
 node_ptr<map_node> parse(const std::string &identifier,
                          std::istream &input_stream,
-                         const bool identifier_is_file_path = false);
-node_ptr<map_node> parse_file(const char *file_path);
-node_ptr<map_node> parse_file(const std::string &file_path);
-node_ptr<map_node> parse_file(const std::filesystem::path &file_path);
+                         const bool identifier_is_file_path = false,
+                         const parse_options &options = parse_options{});
+node_ptr<map_node> parse_file(const char *file_path,
+                              const parse_options &options = parse_options{});
+node_ptr<map_node> parse_file(const std::string &file_path,
+                              const parse_options &options = parse_options{});
+node_ptr<map_node> parse_file(const std::filesystem::path &file_path,
+                              const parse_options &options = parse_options{});
+node_ptr<map_node>
+parse_file(const std::filesystem::path &file_path,
+           std::vector<std::filesystem::path> &included_file_paths,
+           const parse_options &options = parse_options{});
+
+std::expected<node_ptr<map_node>, parse_error>
+try_parse(const std::string &identifier, std::istream &input_stream,
+          const bool identifier_is_file_path = false,
+          const parse_options &options = parse_options{});
+std::expected<node_ptr<map_node>, parse_error>
+try_parse_file(const char *file_path,
+               const parse_options &options = parse_options{});
+std::expected<node_ptr<map_node>, parse_error>
+try_parse_file(const std::string &file_path,
+               const parse_options &options = parse_options{});
+std::expected<node_ptr<map_node>, parse_error>
+try_parse_file(const std::filesystem::path &file_path,
+               const parse_options &options = parse_options{});
+std::expected<node_ptr<map_node>, parse_error>
+try_parse_file(const std::filesystem::path &file_path,
+               std::vector<std::filesystem::path> &included_file_paths,
+               const parse_options &options = parse_options{});
+
+recovery_result
+parse_with_recovery(const std::string &identifier, std::istream &input_stream,
+                    const bool identifier_is_file_path = false,
+                    const parse_options &options = parse_options{});
+recovery_result
+parse_file_with_recovery(const std::filesystem::path &file_path,
+                         const parse_options &options = parse_options{});
+
+void validate(const std::string &identifier, std::istream &input_stream,
+              const bool identifier_is_file_path = false,
+              const parse_options &options = parse_options{});
+void validate_file(const std::filesystem::path &file_path,
+                   const parse_options &options = parse_options{});
 
 namespace impl {
+template <typename t_value>
+using parse_result = std::expected<t_value, parse_error>;
+
+// Shared by a file and every file it (transitively) includes.
+struct parse_budget {
+  std::size_t input_bytes;
+  std::size_t node_count;
+  std::size_t include_count;
+  std::size_t include_depth;
+};
+
+using key_set = std::unordered_set<std::string, key_hash, std::equal_to<>>;
+
+// The input of a parse made with parse_options::lazy_containers, kept alive by
+// the containers still to be materialized from it.
+struct lazy_document {
+  std::string identifier;
+  bool identifier_is_file_path;
+  std::string text;
+  parse_options options;
+};
+
+class source_streambuf;
 
 struct context {
   std::string identifier;
   std::istream &input_stream;
+  source_streambuf &source;
   bool identifier_is_file_path;
-  long long line_count;
-  long long char_count;
+  std::vector<std::filesystem::path> *included_file_paths;
+  const parse_options &options;
+  parse_budget *budget;
+  // Non-null when recovering from errors rather than stopping at the first.
+  std::vector<parse_error> *errors;
+  std::uint32_t file_id;
+  // When validating, no nodes are built; instead, the keys of each map are
+  // kept in a key_set to detect duplicates. The same is done for maps
+  // filtered by parse_options::key_paths, whose skipped members are
+  // validated.
+  bool validate_only;
+  bool in_skipped_value;
+  // Non-null when the root map's keys are wanted, i.e. for an included file
+  // whose includer tracks its keys in a key_set.
+  key_set *root_keys;
+  // Non-null when nested containers are left unparsed; see lazy_container.
+  std::shared_ptr<const lazy_document> document;
+  // The containers enclosing the first one parsed: none for a whole input,
+  // or those enclosing a lazy_container being materialized.
+  std::size_t enclosing_depth;
+};
+
+// Reads from another stream buffer in fixed-size chunks and keeps everything
+// read so far, so that the parser's position is just an offset into the
+// buffer and it can rewind to any earlier offset. Line and character numbers
+// are only worked out, from a lazily built newline index, when an error is
+// reported. The input size and deadline limits are checked once per chunk. A
+// violated limit is recorded and reported as end-of-file; the parser then
+// returns the recorded error in place of whatever it made of the truncated
+// input.
+class source_streambuf : public std::streambuf {
+private:
+  static constexpr std::size_t k_chunk_size{4096};
+
+private:
+  std::streambuf *m_source;
+  const context *m_ctx;
+  std::string m_buffer;
+  std::string_view m_text;
+  mutable newline_index m_newline_index;
+  std::optional<parse_error> m_error;
+
+public:
+  explicit source_streambuf(std::streambuf *source);
+  // Reads from `text`, which must outlive this, without copying it.
+  explicit source_streambuf(const std::string_view text);
+  source_streambuf(const source_streambuf &other) = delete;
+  source_streambuf(source_streambuf &&other) = delete;
+
+  virtual ~source_streambuf() override;
+
+public:
+  source_streambuf &operator=(const source_streambuf &other) = delete;
+  source_streambuf &operator=(source_streambuf &&other) = delete;
+
+public:
+  void set_context(const context *ctx);
+  const std::optional<parse_error> &error() const;
+  std::string_view text() const;
+  std::string take_text();
+  std::size_t offset() const;
+  void rewind(const std::size_t offset);
+  std::pair<long long, long long> position(const std::size_t offset) const;
+  long long line(const std::size_t offset) const;
+
+protected:
+  virtual int_type underflow() override;
 };
 
 enum class directive {
@@ -43,57 +219,222 @@ enum class directive {
   include,
 };
 
-node_ptr<map_node> parse(const std::string &identifier,
-                         std::istream &input_stream,
-                         const bool identifier_is_file_path = false);
+enum class key_path_filter {
+  keep,
+  descend,
+  skip,
+};
+
+enum class container_char_type {
+  leading_whitespace,
+  opening_delimiter,
+  separator,
+  closing_delimiter,
+};
+
+// One level of map/array nesting. These live in a heap-allocated stack so
+// that nesting depth is bounded by parse_options rather than the call stack.
+struct container_frame {
+  node_ptr<node> value;
+  std::size_t begin_offset;
+  std::string_view possible_terminating_chars;
+  std::string member_key;
+  std::size_t member_key_offset;
+  key_set seen_keys;
+  key_path_filter filter;
+  key_path_filter member_filter;
+  std::string key_path;
+  std::size_t last_non_whitespace_char_offset;
+  node_type type;
+  container_char_type last_char_type;
+  bool is_root_map;
+  bool in_directive;
+  std::size_t directive_offset;
+  // Set for a container that is only validated on the first pass, and left
+  // to a lazy_container to build.
+  bool is_deferred;
+};
+
+enum class container_frame_result {
+  completed,
+  push_map,
+  push_array,
+};
+
+// A map or array recorded on the first pass as the offset of its value in a
+// lazy_document, and parsed from there when first accessed. Containers nested
+// in it are deferred in turn.
+class lazy_container : public lazy_subtree {
+private:
+  std::shared_ptr<const lazy_document> m_document;
+  std::size_t m_begin_offset;
+  node_type m_type;
+  std::string_view m_possible_terminating_chars;
+  std::size_t m_enclosing_depth;
+
+public:
+  lazy_container(std::shared_ptr<const lazy_document> document,
+                 const std::size_t begin_offset, const node_type type,
+                 const std::string_view possible_terminating_chars,
+                 const std::size_t enclosing_depth);
+  lazy_container(const lazy_container &other) = delete;
+  lazy_container(lazy_container &&other) = delete;
+
+  virtual ~lazy_container() override;
+
+public:
+  lazy_container &operator=(const lazy_container &other) = delete;
+  lazy_container &operator=(lazy_container &&other) = delete;
 
-std::pair<std::string, node_ptr<node>>
+public:
+  virtual void materialize(node &target) const override;
+};
+
+parse_result<node_ptr<map_node>>
+parse(const std::string &identifier, std::istream &input_stream,
+      const bool identifier_is_file_path, const parse_options &options,
+      std::vector<std::filesystem::path> *included_file_paths = nullptr,
+      parse_budget *budget = nullptr,
+      std::vector<parse_error> *errors = nullptr,
+      key_set *root_keys = nullptr,
+      const bool validate_only = false);
+parse_result<node_ptr<map_node>> parse_file(
+    const std::filesystem::path &file_path, const parse_options &options,
+    std::vector<std::filesystem::path> *included_file_paths = nullptr,
+    parse_budget *budget = nullptr,
+    std::vector<parse_error> *errors = nullptr,
+    key_set *root_keys = nullptr,
+    const bool validate_only = false);
+parse_result<node_ptr<map_node>> parse_root_map(context &ctx);
+
+node_ptr<map_node> value_or_throw(parse_result<node_ptr<map_node>> &&result);
+[[noreturn]] void throw_parse_error(parse_error &&error);
+
+parse_error make_parse_error(const context &ctx,
+                             const error_messages::error_message &error);
+parse_error make_parse_error(const context &ctx,
+                             const error_messages::error_message &error,
+                             const std::size_t offset);
+parse_result<void> count_node(context &ctx);
+parse_result<void> check_deadline(const context &ctx);
+bool record_error(context &ctx, parse_error &&error);
+bool is_validating(const context &ctx);
+parse_result<void> check_string_length(const context &ctx,
+                                       const std::string_view str);
+void record_span(const context &ctx, const node *value,
+                 const std::size_t begin_offset);
+void erase_spans(const context &ctx, const node *value);
+
+parse_result<std::pair<std::string, node_ptr<node>>>
 parse_key_value(context &ctx, const std::string_view possible_terminating_chars,
                 char *actual_terminating_char = nullptr);
-std::string parse_key_value_key(context &ctx);
-node_ptr<node>
+parse_result<std::string> parse_key_value_key(context &ctx);
+parse_result<node_ptr<node>>
 parse_key_value_value(context &ctx,
                       const std::string_view possible_terminating_chars,
                       char *actual_terminating_char = nullptr);
+parse_result<void>
+skip_to_key_value_value(context &ctx,
+                        const std::string_view possible_terminating_chars,
+                        char *actual_terminating_char = nullptr);
 
-node_ptr<string_node>
+parse_result<node_ptr<string_node>>
 parse_string_value(context &ctx,
                    const std::string_view possible_terminating_chars,
                    char *actual_terminating_char = nullptr);
-node_ptr<integer_node>
+parse_result<node_ptr<integer_node>>
 parse_integer_value(context &ctx,
                     const std::string_view possible_terminating_chars,
                     char *actual_terminating_char = nullptr);
-node_ptr<float_node>
+parse_result<node_ptr<float_node>>
 parse_float_value(context &ctx,
                   const std::string_view possible_terminating_chars,
                   char *actual_terminating_char = nullptr);
-node_ptr<array_node>
+parse_result<node_ptr<array_node>>
 parse_array_value(context &ctx,
                   const std::string_view possible_terminating_chars,
                   char *actual_terminating_char = nullptr);
-node_ptr<map_node>
+parse_result<node_ptr<map_node>>
 parse_map_value(context &ctx, const std::string_view possible_terminating_chars,
                 char *actual_terminating_char = nullptr,
                 const bool is_root_map = false);
 
-node_ptr<node> call_appropriate_value_parse_func(
+parse_result<node_ptr<node>>
+parse_container_value(context &ctx, const node_type type,
+                      const std::string_view possible_terminating_chars,
+                      char *actual_terminating_char = nullptr,
+                      const bool is_root_map = false);
+parse_result<container_frame_result>
+parse_map_frame(context &ctx, container_frame &frame,
+                char &actual_terminating_char);
+parse_result<container_frame_result>
+parse_array_frame(context &ctx, container_frame &frame,
+                  char &actual_terminating_char);
+parse_result<void> handle_map_frame_directive(context &ctx,
+                                              container_frame &frame);
+parse_result<void> insert_map_frame_member(context &ctx,
+                                           container_frame &frame,
+                                           node_ptr<node> &&value);
+bool tracks_seen_keys(const container_frame &frame);
+key_path_filter filter_map_frame_member(const context &ctx,
+                                        const container_frame &frame,
+                                        const node_type value_type);
+std::string append_key_path(const std::string &key_path,
+                            const std::string &key);
+parse_result<void> skip_map_member_value(context &ctx);
+bool defers_container(const context &ctx, const container_frame &parent,
+                      const key_path_filter filter);
+parse_result<void>
+defer_container(context &ctx, container_frame &parent, const node_type type,
+                const std::string_view possible_terminating_chars,
+                const std::size_t enclosing_depth);
+node_ptr<node>
+make_lazy_container(const context &ctx, const node_type type,
+                    const std::size_t begin_offset,
+                    const std::string_view possible_terminating_chars,
+                    const std::size_t enclosing_depth);
+parse_result<void> pop_container_frame(context &ctx,
+                                       std::vector<container_frame> &stack);
+parse_result<void> add_container_frame_member(context &ctx,
+                                              container_frame &frame,
+                                              node_ptr<node> &&value);
+void update_frame_after_member(container_frame &frame,
+                               const char terminating_char);
+bool resync_container_frames(context &ctx,
+                             std::vector<container_frame> &stack,
+                             const char resync_char);
+node_ptr<node> close_container_frames(context &ctx,
+                                      std::vector<container_frame> &stack);
+std::optional<char> skip_to_resync_char(context &ctx,
+                                        const container_frame &frame,
+                                        const bool check_last_char);
+void skip_to_end_of_line(context &ctx, const std::size_t line_offset);
+bool is_split_by_newline_error(const parse_error &error);
+parse_result<std::optional<char>>
+scan_to_unnested_char(context &ctx, const std::string_view stop_chars);
+
+parse_result<node_ptr<node>> call_appropriate_value_parse_func(
     context &ctx, const std::string_view possible_terminating_chars,
     char *actual_terminating_char = nullptr);
+parse_result<node_ptr<node>> call_appropriate_scalar_value_parse_func(
+    context &ctx, const node_type type,
+    const std::string_view possible_terminating_chars,
+    char *actual_terminating_char = nullptr);
 
-std::pair<directive, std::optional<node_ptr<map_node>>>
-parse_directive(context &ctx);
-void parse_version_directive(context &ctx);
-node_ptr<map_node> parse_include_directive(context &ctx);
+parse_result<std::pair<directive, std::optional<node_ptr<map_node>>>>
+parse_directive(context &ctx, key_set *included_keys = nullptr);
+parse_result<void> parse_version_directive(context &ctx);
+parse_result<node_ptr<map_node>>
+parse_include_directive(context &ctx, key_set *included_keys = nullptr);
 
-bool handle_comments(context &ctx);
-char handle_escape_sequence(context &ctx);
+parse_result<bool> handle_comments(context &ctx);
+parse_result<char> handle_escape_sequence(context &ctx);
 
-node_type
+parse_result<node_type>
 identify_key_value_value_type(context &ctx,
                               const std::string_view possible_terminating_chars,
                               char *actual_terminating_char = nullptr);
-node_type identify_key_value_numeric_value_type(
+parse_result<node_type> identify_key_value_numeric_value_type(
     context &ctx, const std::string_view possible_terminating_chars,
     char *actual_terminating_char = nullptr);
 
@@ -119,6 +460,14 @@ case_insensitive_string_find(const std::string_view str,
 } // namespace parser
 using parser::parse;
 using parser::parse_file;
+using parser::parse_file_with_recovery;
+using parser::parse_options;
+using parser::parse_with_recovery;
+using parser::recovery_result;
+using parser::try_parse;
+using parser::try_parse_file;
+using parser::validate;
+using parser::validate_file;
 } // namespace libconfigfile
 
 #endif
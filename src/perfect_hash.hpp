@@ -0,0 +1,125 @@
+#ifndef LIBCONFIGFILE_PERFECT_HASH_HPP
+#define LIBCONFIGFILE_PERFECT_HASH_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace libconfigfile {
+namespace impl {
+// Minimal perfect hashing of a fixed set of distinct keys, usable in constant
+// expressions: keys are hashed into buckets, and each bucket gets the first
+// pilot value that moves all of its keys into slots that are still free.
+// Buckets are placed largest first, and there are twice as many slots as
+// buckets, which keeps the searches short. A lookup costs one hash of the key
+// and one comparison with the only key it could be.
+constexpr std::size_t perfect_hash_bucket_count(const std::size_t key_count) {
+  return std::bit_ceil(std::max<std::size_t>(key_count, 1));
+}
+
+constexpr std::size_t perfect_hash_slot_count(const std::size_t key_count) {
+  return (perfect_hash_bucket_count(key_count) * 2);
+}
+
+// FNV-1a.
+constexpr std::uint64_t perfect_hash_key(const std::string_view key) {
+  std::uint64_t ret_val{0xcbf29ce484222325};
+  for (const char ch : key) {
+    ret_val ^= static_cast<unsigned char>(ch);
+    ret_val *= 0x100000001b3;
+  }
+  return ret_val;
+}
+
+// The finalizer of MurmurHash3, so that every pilot scatters the keys anew.
+constexpr std::size_t perfect_hash_slot(const std::uint64_t key_hash,
+                                        const std::uint32_t pilot,
+                                        const std::size_t slot_count) {
+  std::uint64_t ret_val{key_hash ^ (pilot * 0x9e3779b97f4a7c15)};
+  ret_val ^= (ret_val >> 33);
+  ret_val *= 0xff51afd7ed558ccd;
+  ret_val ^= (ret_val >> 33);
+  ret_val *= 0xc4ceb9fe1a85ec53;
+  ret_val ^= (ret_val >> 33);
+  return static_cast<std::size_t>(ret_val & (slot_count - 1));
+}
+
+// Fills `pilots` and `slots`, sized by perfect_hash_bucket_count() and
+// perfect_hash_slot_count(), so that each key's slot holds its position in
+// `keys`; empty slots hold npos. Returns false if no pilot could be found for
+// some bucket, which only happens if two keys are the same.
+constexpr bool build_perfect_hash(const std::span<const std::string_view> keys,
+                                  const std::span<std::uint32_t> pilots,
+                                  const std::span<std::size_t> slots) {
+  constexpr std::uint32_t k_max_pilot{1 << 20};
+
+  std::fill(pilots.begin(), pilots.end(), 0);
+  std::fill(slots.begin(), slots.end(), std::string_view::npos);
+
+  std::vector<std::vector<std::size_t>> buckets(pilots.size());
+  for (std::size_t i{0}; i < keys.size(); ++i) {
+    buckets[perfect_hash_key(keys[i]) & (pilots.size() - 1)].push_back(i);
+  }
+  std::vector<std::size_t> order(pilots.size());
+  for (std::size_t i{0}; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(),
+            [&buckets](const std::size_t x, const std::size_t y) {
+              return ((buckets[x].size() != buckets[y].size())
+                          ? (buckets[x].size() > buckets[y].size())
+                          : (x < y));
+            });
+
+  std::vector<std::size_t> bucket_slots{};
+  for (const std::size_t bucket : order) {
+    if (buckets[bucket].empty() == true) {
+      break;
+    }
+    std::uint32_t pilot{0};
+    for (; pilot < k_max_pilot; ++pilot) {
+      bucket_slots.clear();
+      for (const std::size_t key : buckets[bucket]) {
+        const std::size_t pos{perfect_hash_slot(perfect_hash_key(keys[key]),
+                                                pilot, slots.size())};
+        if ((slots[pos] != std::string_view::npos) ||
+            (std::find(bucket_slots.begin(), bucket_slots.end(), pos) !=
+             bucket_slots.end())) {
+          break;
+        }
+        bucket_slots.push_back(pos);
+      }
+      if (bucket_slots.size() == buckets[bucket].size()) {
+        break;
+      }
+    }
+    if (pilot == k_max_pilot) {
+      return false;
+    }
+
+    pilots[bucket] = pilot;
+    for (std::size_t i{0}; i < bucket_slots.size(); ++i) {
+      slots[bucket_slots[i]] = buckets[bucket][i];
+    }
+  }
+  return true;
+}
+
+// Returns the position of the only key that `key` could be, or npos; the
+// caller compares them.
+constexpr std::size_t
+find_perfect_hash(const std::string_view key,
+                  const std::span<const std::uint32_t> pilots,
+                  const std::span<const std::size_t> slots) {
+  const std::uint64_t key_hash{perfect_hash_key(key)};
+  return slots[perfect_hash_slot(
+      key_hash, pilots[key_hash & (pilots.size() - 1)], slots.size())];
+}
+} // namespace impl
+} // namespace libconfigfile
+
+#endif
@@ -0,0 +1,920 @@
+#include "persistent_nodes.hpp"
+
+#include "array_node.hpp"
+#include "key_hash.hpp"
+#include "map_node.hpp"
+#include "node.hpp"
+#include "node_ptr.hpp"
+#include "node_types.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace libconfigfile {
+namespace impl {
+static constexpr unsigned int k_hamt_bits_per_level{5};
+static constexpr std::uint64_t k_hamt_level_mask{
+    (1u << k_hamt_bits_per_level) - 1};
+static constexpr unsigned int k_hamt_hash_bits{64};
+
+using hamt_entry_ptr = std::shared_ptr<const persistent_map::value_type>;
+
+struct hamt_slot {
+  std::shared_ptr<const hamt_node> child;
+  hamt_entry_ptr entry;
+  std::uint64_t hash;
+};
+
+struct hamt_node {
+  std::uint32_t bitmap{0};
+  std::vector<hamt_slot> slots{};
+  // Only used once every bit of the hash has been consumed.
+  std::vector<hamt_entry_ptr> collisions{};
+};
+
+static constexpr unsigned int k_vector_bits_per_level{5};
+static constexpr std::size_t k_vector_branching_factor{
+    std::size_t{1} << k_vector_bits_per_level};
+static constexpr std::size_t k_vector_level_mask{k_vector_branching_factor -
+                                                 1};
+
+struct vector_trie_node {
+  std::vector<std::shared_ptr<const vector_trie_node>> children{};
+  std::vector<persistent_value> values{};
+};
+
+static std::uint64_t hamt_hash(const std::string_view key) {
+  return impl::key_hash_value(key);
+}
+
+static std::size_t hamt_slot_pos(const hamt_node &node,
+                                 const std::uint32_t bit) {
+  return static_cast<std::size_t>(std::popcount(node.bitmap & (bit - 1)));
+}
+
+static const persistent_value *hamt_find(const hamt_node *node,
+                                         const std::uint64_t hash,
+                                         const std::string_view key) {
+  for (unsigned int shift{0}; node != nullptr;
+       shift += k_hamt_bits_per_level) {
+    if (shift >= k_hamt_hash_bits) {
+      for (const hamt_entry_ptr &entry : node->collisions) {
+        if (entry->first == key) {
+          return &(entry->second);
+        }
+      }
+      return nullptr;
+    }
+
+    const std::uint32_t bit{std::uint32_t{1}
+                            << ((hash >> shift) & k_hamt_level_mask)};
+    if ((node->bitmap & bit) == 0) {
+      return nullptr;
+    }
+
+    const hamt_slot &slot{node->slots[hamt_slot_pos(*node, bit)]};
+    if (slot.child != nullptr) {
+      node = slot.child.get();
+    } else if ((slot.hash == hash) && (slot.entry->first == key)) {
+      return &(slot.entry->second);
+    } else {
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+static std::shared_ptr<const hamt_node>
+hamt_set(const hamt_node *node, const std::uint64_t hash,
+         hamt_entry_ptr entry, const unsigned int shift, bool &added) {
+  auto ret_val{((node == nullptr) ? (std::make_shared<hamt_node>())
+                                  : (std::make_shared<hamt_node>(*node)))};
+
+  if (shift >= k_hamt_hash_bits) {
+    for (hamt_entry_ptr &e : ret_val->collisions) {
+      if (e->first == entry->first) {
+        e = std::move(entry);
+        added = false;
+        return ret_val;
+      }
+    }
+    ret_val->collisions.push_back(std::move(entry));
+    added = true;
+    return ret_val;
+  }
+
+  const std::uint32_t bit{std::uint32_t{1}
+                          << ((hash >> shift) & k_hamt_level_mask)};
+  const std::size_t pos{hamt_slot_pos(*ret_val, bit)};
+
+  if ((ret_val->bitmap & bit) == 0) {
+    ret_val->bitmap |= bit;
+    ret_val->slots.insert(ret_val->slots.begin() + pos,
+                          hamt_slot{nullptr, std::move(entry), hash});
+    added = true;
+  } else {
+    hamt_slot &slot{ret_val->slots[pos]};
+    if (slot.child != nullptr) {
+      slot.child = hamt_set(slot.child.get(), hash, std::move(entry),
+                            shift + k_hamt_bits_per_level, added);
+    } else if ((slot.hash == hash) && (slot.entry->first == entry->first)) {
+      slot.entry = std::move(entry);
+      added = false;
+    } else {
+      bool ignored{};
+      std::shared_ptr<const hamt_node> child{
+          hamt_set(nullptr, slot.hash, std::move(slot.entry),
+                   shift + k_hamt_bits_per_level, ignored)};
+      child = hamt_set(child.get(), hash, std::move(entry),
+                       shift + k_hamt_bits_per_level, added);
+      slot = hamt_slot{std::move(child), nullptr, 0};
+    }
+  }
+
+  return ret_val;
+}
+
+static std::shared_ptr<const hamt_node>
+hamt_erase(const std::shared_ptr<const hamt_node> &node,
+           const std::uint64_t hash, const std::string_view key,
+           const unsigned int shift, bool &removed) {
+  removed = false;
+
+  if (node == nullptr) {
+    return node;
+  }
+
+  if (shift >= k_hamt_hash_bits) {
+    for (std::size_t i{0}; i < node->collisions.size(); ++i) {
+      if (node->collisions[i]->first == key) {
+        removed = true;
+        if (node->collisions.size() == 1) {
+          return nullptr;
+        } else {
+          auto ret_val{std::make_shared<hamt_node>(*node)};
+          ret_val->collisions.erase(ret_val->collisions.begin() + i);
+          return ret_val;
+        }
+      }
+    }
+    return node;
+  }
+
+  const std::uint32_t bit{std::uint32_t{1}
+                          << ((hash >> shift) & k_hamt_level_mask)};
+  if ((node->bitmap & bit) == 0) {
+    return node;
+  }
+
+  const std::size_t pos{hamt_slot_pos(*node, bit)};
+  const hamt_slot &slot{node->slots[pos]};
+
+  std::shared_ptr<const hamt_node> new_child{nullptr};
+  if (slot.child != nullptr) {
+    new_child = hamt_erase(slot.child, hash, key,
+                           shift + k_hamt_bits_per_level, removed);
+    if (removed == false) {
+      return node;
+    }
+  } else if ((slot.hash == hash) && (slot.entry->first == key)) {
+    removed = true;
+  } else {
+    return node;
+  }
+
+  auto ret_val{std::make_shared<hamt_node>(*node)};
+  if (new_child == nullptr) {
+    ret_val->bitmap &= ~bit;
+    ret_val->slots.erase(ret_val->slots.begin() + pos);
+    if (ret_val->slots.empty() == true) {
+      return nullptr;
+    }
+  } else if ((new_child->slots.size() == 1) &&
+             (new_child->slots.front().child == nullptr)) {
+    ret_val->slots[pos] = new_child->slots.front();
+  } else {
+    ret_val->slots[pos].child = std::move(new_child);
+  }
+  return ret_val;
+}
+
+static std::shared_ptr<const vector_trie_node>
+vector_new_path(const unsigned int level,
+                std::shared_ptr<const vector_trie_node> node) {
+  if (level == 0) {
+    return node;
+  } else {
+    auto ret_val{std::make_shared<vector_trie_node>()};
+    ret_val->children.push_back(
+        vector_new_path(level - k_vector_bits_per_level, std::move(node)));
+    return ret_val;
+  }
+}
+
+static std::shared_ptr<const vector_trie_node>
+vector_push_tail(const std::size_t size, const unsigned int level,
+                 const vector_trie_node &parent,
+                 std::shared_ptr<const vector_trie_node> tail) {
+  const std::size_t sub_index{((size - 1) >> level) & k_vector_level_mask};
+  auto ret_val{std::make_shared<vector_trie_node>(parent)};
+
+  std::shared_ptr<const vector_trie_node> to_insert{nullptr};
+  if (level == k_vector_bits_per_level) {
+    to_insert = std::move(tail);
+  } else if (sub_index < parent.children.size()) {
+    to_insert = vector_push_tail(size, level - k_vector_bits_per_level,
+                                 *(parent.children[sub_index]),
+                                 std::move(tail));
+  } else {
+    to_insert =
+        vector_new_path(level - k_vector_bits_per_level, std::move(tail));
+  }
+
+  if (sub_index < ret_val->children.size()) {
+    ret_val->children[sub_index] = std::move(to_insert);
+  } else {
+    ret_val->children.push_back(std::move(to_insert));
+  }
+  return ret_val;
+}
+
+static std::shared_ptr<const vector_trie_node>
+vector_pop_tail(const std::size_t size, const unsigned int level,
+                const vector_trie_node &node) {
+  const std::size_t sub_index{((size - 2) >> level) & k_vector_level_mask};
+  if (level > k_vector_bits_per_level) {
+    std::shared_ptr<const vector_trie_node> new_child{vector_pop_tail(
+        size, level - k_vector_bits_per_level, *(node.children[sub_index]))};
+    if ((new_child == nullptr) && (sub_index == 0)) {
+      return nullptr;
+    } else {
+      auto ret_val{std::make_shared<vector_trie_node>(node)};
+      if (new_child == nullptr) {
+        ret_val->children.pop_back();
+      } else {
+        ret_val->children[sub_index] = std::move(new_child);
+      }
+      return ret_val;
+    }
+  } else if (sub_index == 0) {
+    return nullptr;
+  } else {
+    auto ret_val{std::make_shared<vector_trie_node>(node)};
+    ret_val->children.pop_back();
+    return ret_val;
+  }
+}
+
+static std::shared_ptr<const vector_trie_node>
+vector_set(const unsigned int level, const vector_trie_node &node,
+           const std::size_t pos, persistent_value value) {
+  auto ret_val{std::make_shared<vector_trie_node>(node)};
+  if (level == 0) {
+    ret_val->values[pos & k_vector_level_mask] = std::move(value);
+  } else {
+    const std::size_t sub_index{(pos >> level) & k_vector_level_mask};
+    ret_val->children[sub_index] =
+        vector_set(level - k_vector_bits_per_level,
+                   *(node.children[sub_index]), pos, std::move(value));
+  }
+  return ret_val;
+}
+} // namespace impl
+} // namespace libconfigfile
+
+libconfigfile::persistent_map::const_iterator::const_iterator()
+    : m_stack{}, m_cur{nullptr} {}
+
+libconfigfile::persistent_map::const_iterator::const_iterator(
+    const impl::hamt_node *root)
+    : m_stack{}, m_cur{nullptr} {
+  if (root != nullptr) {
+    m_stack.push_back({root, 0});
+    advance();
+  }
+}
+
+libconfigfile::persistent_map::const_iterator::reference
+libconfigfile::persistent_map::const_iterator::operator*() const {
+  return *m_cur;
+}
+
+libconfigfile::persistent_map::const_iterator::pointer
+libconfigfile::persistent_map::const_iterator::operator->() const {
+  return m_cur;
+}
+
+libconfigfile::persistent_map::const_iterator &
+libconfigfile::persistent_map::const_iterator::operator++() {
+  advance();
+  return *this;
+}
+
+libconfigfile::persistent_map::const_iterator
+libconfigfile::persistent_map::const_iterator::operator++(int) {
+  const_iterator temp{*this};
+  advance();
+  return temp;
+}
+
+void libconfigfile::persistent_map::const_iterator::advance() {
+  m_cur = nullptr;
+  while (m_stack.empty() == false) {
+    auto &[node, index]{m_stack.back()};
+    if (index < node->slots.size()) {
+      const impl::hamt_slot &slot{node->slots[index++]};
+      if (slot.child != nullptr) {
+        m_stack.push_back({slot.child.get(), 0});
+      } else {
+        m_cur = slot.entry.get();
+        return;
+      }
+    } else if ((index - node->slots.size()) < node->collisions.size()) {
+      m_cur = node->collisions[(index++) - node->slots.size()].get();
+      return;
+    } else {
+      m_stack.pop_back();
+    }
+  }
+}
+
+bool libconfigfile::operator==(const persistent_map::const_iterator &x,
+                               const persistent_map::const_iterator &y) {
+  return x.m_cur == y.m_cur;
+}
+
+bool libconfigfile::operator!=(const persistent_map::const_iterator &x,
+                               const persistent_map::const_iterator &y) {
+  return (!(x == y));
+}
+
+libconfigfile::persistent_map::persistent_map(
+    std::shared_ptr<const impl::hamt_node> root, const size_type size)
+    : m_root{std::move(root)}, m_size{size} {}
+
+libconfigfile::persistent_map::persistent_map() : m_root{nullptr}, m_size{0} {}
+
+libconfigfile::persistent_map::persistent_map(const map_node &node)
+    : m_root{nullptr}, m_size{0} {
+  for (auto p{node.begin()}; p != node.end(); ++p) {
+    *this = set(p->first, persistent_value{*(p->second)});
+  }
+}
+
+libconfigfile::persistent_map::persistent_map(const persistent_map &other)
+    : m_root{other.m_root}, m_size{other.m_size} {}
+
+libconfigfile::persistent_map::persistent_map(persistent_map &&other) noexcept
+    : m_root{std::move(other.m_root)}, m_size{other.m_size} {
+  other.m_size = 0;
+}
+
+libconfigfile::persistent_map::~persistent_map() {}
+
+libconfigfile::persistent_map &
+libconfigfile::persistent_map::operator=(const persistent_map &other) {
+  m_root = other.m_root;
+  m_size = other.m_size;
+  return *this;
+}
+
+libconfigfile::persistent_map &
+libconfigfile::persistent_map::operator=(persistent_map &&other) noexcept {
+  if (this != &other) {
+    m_root = std::move(other.m_root);
+    m_size = other.m_size;
+    other.m_size = 0;
+  }
+  return *this;
+}
+
+libconfigfile::persistent_map::size_type
+libconfigfile::persistent_map::size() const {
+  return m_size;
+}
+
+bool libconfigfile::persistent_map::empty() const { return m_size == 0; }
+
+const libconfigfile::persistent_value *
+libconfigfile::persistent_map::find(const std::string_view key) const {
+  return impl::hamt_find(m_root.get(), impl::hamt_hash(key), key);
+}
+
+bool libconfigfile::persistent_map::contains(const std::string_view key) const {
+  return find(key) != nullptr;
+}
+
+const libconfigfile::persistent_value &
+libconfigfile::persistent_map::at(const std::string_view key) const {
+  const persistent_value *ret_val{find(key)};
+  if (ret_val == nullptr) {
+    throw std::out_of_range{"persistent_map::at"};
+  } else {
+    return *ret_val;
+  }
+}
+
+const libconfigfile::persistent_value *libconfigfile::persistent_map::find_in(
+    const std::vector<std::string_view> &key_path) const {
+  const persistent_map *cur_map{this};
+  const persistent_value *ret_val{nullptr};
+  for (auto p{key_path.begin()}; p != key_path.end(); ++p) {
+    ret_val = cur_map->find(*p);
+    if (ret_val == nullptr) {
+      return nullptr;
+    } else if ((p + 1) != key_path.end()) {
+      if (ret_val->is_map() == false) {
+        return nullptr;
+      }
+      cur_map = &(ret_val->as_map());
+    }
+  }
+  return ret_val;
+}
+
+libconfigfile::persistent_map
+libconfigfile::persistent_map::set(std::string key,
+                                   persistent_value value) const {
+  const std::uint64_t hash{impl::hamt_hash(key)};
+  bool added{false};
+  std::shared_ptr<const impl::hamt_node> new_root{impl::hamt_set(
+      m_root.get(), hash,
+      std::make_shared<const value_type>(std::move(key), std::move(value)), 0,
+      added)};
+  return persistent_map{std::move(new_root),
+                        ((added == true) ? (m_size + 1) : (m_size))};
+}
+
+libconfigfile::persistent_map
+libconfigfile::persistent_map::erase(const std::string_view key) const {
+  bool removed{false};
+  std::shared_ptr<const impl::hamt_node> new_root{
+      impl::hamt_erase(m_root, impl::hamt_hash(key), key, 0, removed)};
+  if (removed == true) {
+    return persistent_map{std::move(new_root), m_size - 1};
+  } else {
+    return *this;
+  }
+}
+
+libconfigfile::persistent_map libconfigfile::persistent_map::set_in(
+    const std::vector<std::string_view> &key_path,
+    persistent_value value) const {
+  if (key_path.empty() == true) {
+    throw std::invalid_argument{"persistent_map::set_in: key path is empty"};
+  } else if (key_path.size() == 1) {
+    return set(std::string{key_path.front()}, std::move(value));
+  } else {
+    const persistent_value *child{find(key_path.front())};
+    persistent_map child_map{};
+    if (child != nullptr) {
+      if (child->is_map() == false) {
+        throw std::invalid_argument{
+            "persistent_map::set_in: key path goes through a non-map value"};
+      }
+      child_map = child->as_map();
+    }
+    return set(std::string{key_path.front()},
+               child_map.set_in(std::vector<std::string_view>{
+                                    key_path.begin() + 1, key_path.end()},
+                                std::move(value)));
+  }
+}
+
+libconfigfile::persistent_map::const_iterator
+libconfigfile::persistent_map::begin() const {
+  return const_iterator{m_root.get()};
+}
+
+libconfigfile::persistent_map::const_iterator
+libconfigfile::persistent_map::end() const {
+  return const_iterator{};
+}
+
+libconfigfile::node_ptr<libconfigfile::map_node>
+libconfigfile::persistent_map::to_map_node() const {
+  node_ptr<map_node> ret_val{make_node_ptr<map_node>()};
+  ret_val->set_is_root_map(true);
+  ret_val->reserve(m_size);
+  for (auto p{begin()}; p != end(); ++p) {
+    ret_val->insert({p->first, p->second.to_node()});
+  }
+  return ret_val;
+}
+
+bool libconfigfile::operator==(const persistent_map &x,
+                               const persistent_map &y) {
+  if (x.m_root == y.m_root) {
+    return true;
+  } else if (x.m_size != y.m_size) {
+    return false;
+  } else {
+    for (auto p{x.begin()}; p != x.end(); ++p) {
+      const persistent_value *other{y.find(p->first)};
+      if ((other == nullptr) || ((*other) != (p->second))) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+bool libconfigfile::operator!=(const persistent_map &x,
+                               const persistent_map &y) {
+  return (!(x == y));
+}
+
+libconfigfile::persistent_array::const_iterator::const_iterator()
+    : m_array{nullptr}, m_index{0} {}
+
+libconfigfile::persistent_array::const_iterator::const_iterator(
+    const persistent_array *array, const size_type index)
+    : m_array{array}, m_index{index} {}
+
+libconfigfile::persistent_array::const_iterator::reference
+libconfigfile::persistent_array::const_iterator::operator*() const {
+  return (*m_array)[m_index];
+}
+
+libconfigfile::persistent_array::const_iterator::pointer
+libconfigfile::persistent_array::const_iterator::operator->() const {
+  return &((*m_array)[m_index]);
+}
+
+libconfigfile::persistent_array::const_iterator &
+libconfigfile::persistent_array::const_iterator::operator++() {
+  ++m_index;
+  return *this;
+}
+
+libconfigfile::persistent_array::const_iterator
+libconfigfile::persistent_array::const_iterator::operator++(int) {
+  const_iterator temp{*this};
+  ++m_index;
+  return temp;
+}
+
+bool libconfigfile::operator==(const persistent_array::const_iterator &x,
+                               const persistent_array::const_iterator &y) {
+  return ((x.m_array == y.m_array) && (x.m_index == y.m_index));
+}
+
+bool libconfigfile::operator!=(const persistent_array::const_iterator &x,
+                               const persistent_array::const_iterator &y) {
+  return (!(x == y));
+}
+
+libconfigfile::persistent_array::persistent_array(
+    std::shared_ptr<const impl::vector_trie_node> root,
+    std::shared_ptr<const impl::vector_trie_node> tail, const size_type size,
+    const unsigned int shift)
+    : m_root{std::move(root)}, m_tail{std::move(tail)}, m_size{size},
+      m_shift{shift} {}
+
+libconfigfile::persistent_array::persistent_array()
+    : m_root{std::make_shared<const impl::vector_trie_node>()},
+      m_tail{std::make_shared<const impl::vector_trie_node>()}, m_size{0},
+      m_shift{impl::k_vector_bits_per_level} {}
+
+libconfigfile::persistent_array::persistent_array(const array_node &node)
+    : persistent_array{} {
+  for (auto p{node.begin()}; p != node.end(); ++p) {
+    *this = push_back(persistent_value{**p});
+  }
+}
+
+libconfigfile::persistent_array::persistent_array(
+    const persistent_array &other)
+    : m_root{other.m_root}, m_tail{other.m_tail}, m_size{other.m_size},
+      m_shift{other.m_shift} {}
+
+libconfigfile::persistent_array::persistent_array(
+    persistent_array &&other) noexcept
+    : persistent_array{} {
+  m_root.swap(other.m_root);
+  m_tail.swap(other.m_tail);
+  std::swap(m_size, other.m_size);
+  std::swap(m_shift, other.m_shift);
+}
+
+libconfigfile::persistent_array::~persistent_array() {}
+
+libconfigfile::persistent_array &
+libconfigfile::persistent_array::operator=(const persistent_array &other) {
+  m_root = other.m_root;
+  m_tail = other.m_tail;
+  m_size = other.m_size;
+  m_shift = other.m_shift;
+  return *this;
+}
+
+libconfigfile::persistent_array &
+libconfigfile::persistent_array::operator=(persistent_array &&other) noexcept {
+  if (this != &other) {
+    m_root.swap(other.m_root);
+    m_tail.swap(other.m_tail);
+    std::swap(m_size, other.m_size);
+    std::swap(m_shift, other.m_shift);
+  }
+  return *this;
+}
+
+libconfigfile::persistent_array::size_type
+libconfigfile::persistent_array::size() const {
+  return m_size;
+}
+
+bool libconfigfile::persistent_array::empty() const { return m_size == 0; }
+
+const libconfigfile::persistent_value &
+libconfigfile::persistent_array::operator[](const size_type pos) const {
+  if (pos >= tail_offset()) {
+    return m_tail->values[pos & impl::k_vector_level_mask];
+  } else {
+    const impl::vector_trie_node *node{m_root.get()};
+    for (unsigned int level{m_shift}; level > 0;
+         level -= impl::k_vector_bits_per_level) {
+      node = node->children[(pos >> level) & impl::k_vector_level_mask].get();
+    }
+    return node->values[pos & impl::k_vector_level_mask];
+  }
+}
+
+const libconfigfile::persistent_value &
+libconfigfile::persistent_array::at(const size_type pos) const {
+  if (pos >= m_size) {
+    throw std::out_of_range{"persistent_array::at"};
+  } else {
+    return (*this)[pos];
+  }
+}
+
+libconfigfile::persistent_array
+libconfigfile::persistent_array::push_back(persistent_value value) const {
+  if ((m_size - tail_offset()) < impl::k_vector_branching_factor) {
+    auto new_tail{std::make_shared<impl::vector_trie_node>(*m_tail)};
+    new_tail->values.push_back(std::move(value));
+    return persistent_array{m_root, std::move(new_tail), m_size + 1, m_shift};
+  } else {
+    std::shared_ptr<const impl::vector_trie_node> new_root{nullptr};
+    unsigned int new_shift{m_shift};
+
+    if ((m_size >> impl::k_vector_bits_per_level) >
+        (std::size_t{1} << m_shift)) {
+      auto root{std::make_shared<impl::vector_trie_node>()};
+      root->children.push_back(m_root);
+      root->children.push_back(impl::vector_new_path(m_shift, m_tail));
+      new_root = std::move(root);
+      new_shift += impl::k_vector_bits_per_level;
+    } else {
+      new_root = impl::vector_push_tail(m_size, m_shift, *m_root, m_tail);
+    }
+
+    auto new_tail{std::make_shared<impl::vector_trie_node>()};
+    new_tail->values.push_back(std::move(value));
+    return persistent_array{std::move(new_root), std::move(new_tail),
+                            m_size + 1, new_shift};
+  }
+}
+
+libconfigfile::persistent_array
+libconfigfile::persistent_array::pop_back() const {
+  if (m_size == 0) {
+    throw std::out_of_range{"persistent_array::pop_back"};
+  } else if (m_size == 1) {
+    return persistent_array{};
+  } else if ((m_size - tail_offset()) > 1) {
+    auto new_tail{std::make_shared<impl::vector_trie_node>(*m_tail)};
+    new_tail->values.pop_back();
+    return persistent_array{m_root, std::move(new_tail), m_size - 1, m_shift};
+  } else {
+    const impl::vector_trie_node *leaf{m_root.get()};
+    for (unsigned int level{m_shift}; level > 0;
+         level -= impl::k_vector_bits_per_level) {
+      leaf = leaf->children[((m_size - 2) >> level) &
+                            impl::k_vector_level_mask]
+                 .get();
+    }
+    auto new_tail{std::make_shared<const impl::vector_trie_node>(*leaf)};
+
+    std::shared_ptr<const impl::vector_trie_node> new_root{
+        impl::vector_pop_tail(m_size, m_shift, *m_root)};
+    unsigned int new_shift{m_shift};
+    if (new_root == nullptr) {
+      new_root = std::make_shared<const impl::vector_trie_node>();
+    }
+    if ((new_shift > impl::k_vector_bits_per_level) &&
+        (new_root->children.size() == 1)) {
+      new_root = new_root->children.front();
+      new_shift -= impl::k_vector_bits_per_level;
+    }
+    return persistent_array{std::move(new_root), std::move(new_tail),
+                            m_size - 1, new_shift};
+  }
+}
+
+libconfigfile::persistent_array
+libconfigfile::persistent_array::set(const size_type pos,
+                                     persistent_value value) const {
+  if (pos >= m_size) {
+    throw std::out_of_range{"persistent_array::set"};
+  } else if (pos >= tail_offset()) {
+    auto new_tail{std::make_shared<impl::vector_trie_node>(*m_tail)};
+    new_tail->values[pos & impl::k_vector_level_mask] = std::move(value);
+    return persistent_array{m_root, std::move(new_tail), m_size, m_shift};
+  } else {
+    return persistent_array{
+        impl::vector_set(m_shift, *m_root, pos, std::move(value)), m_tail,
+        m_size, m_shift};
+  }
+}
+
+libconfigfile::persistent_array::const_iterator
+libconfigfile::persistent_array::begin() const {
+  return const_iterator{this, 0};
+}
+
+libconfigfile::persistent_array::const_iterator
+libconfigfile::persistent_array::end() const {
+  return const_iterator{this, m_size};
+}
+
+libconfigfile::node_ptr<libconfigfile::array_node>
+libconfigfile::persistent_array::to_array_node() const {
+  node_ptr<array_node> ret_val{make_node_ptr<array_node>()};
+  ret_val->reserve(m_size);
+  for (auto p{begin()}; p != end(); ++p) {
+    ret_val->push_back(p->to_node());
+  }
+  return ret_val;
+}
+
+libconfigfile::persistent_array::size_type
+libconfigfile::persistent_array::tail_offset() const {
+  return ((m_size < impl::k_vector_branching_factor)
+              ? (0)
+              : (((m_size - 1) >> impl::k_vector_bits_per_level)
+                 << impl::k_vector_bits_per_level));
+}
+
+bool libconfigfile::operator==(const persistent_array &x,
+                               const persistent_array &y) {
+  if ((x.m_root == y.m_root) && (x.m_tail == y.m_tail)) {
+    return true;
+  } else if (x.m_size != y.m_size) {
+    return false;
+  } else {
+    for (persistent_array::size_type i{0}; i < x.m_size; ++i) {
+      if (x[i] != y[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+bool libconfigfile::operator!=(const persistent_array &x,
+                               const persistent_array &y) {
+  return (!(x == y));
+}
+
+libconfigfile::persistent_value::persistent_value()
+    : m_value{std::shared_ptr<const node>{nullptr}} {}
+
+libconfigfile::persistent_value::persistent_value(const node &node)
+    : m_value{} {
+  switch (node.get_node_type()) {
+  case node_type::Map: {
+    m_value = persistent_map{static_cast<const map_node &>(node)};
+  } break;
+  case node_type::Array: {
+    m_value = persistent_array{static_cast<const array_node &>(node)};
+  } break;
+  default: {
+    m_value = std::shared_ptr<const libconfigfile::node>{node_clone(node)};
+  } break;
+  }
+}
+
+libconfigfile::persistent_value::persistent_value(persistent_map map)
+    : m_value{std::move(map)} {}
+
+libconfigfile::persistent_value::persistent_value(persistent_array array)
+    : m_value{std::move(array)} {}
+
+libconfigfile::persistent_value::persistent_value(
+    const persistent_value &other)
+    : m_value{other.m_value} {}
+
+libconfigfile::persistent_value::persistent_value(
+    persistent_value &&other) noexcept
+    : m_value{std::move(other.m_value)} {}
+
+libconfigfile::persistent_value::~persistent_value() {}
+
+libconfigfile::persistent_value &
+libconfigfile::persistent_value::operator=(const persistent_value &other) {
+  m_value = other.m_value;
+  return *this;
+}
+
+libconfigfile::persistent_value &
+libconfigfile::persistent_value::operator=(persistent_value &&other) noexcept {
+  m_value = std::move(other.m_value);
+  return *this;
+}
+
+libconfigfile::node_type libconfigfile::persistent_value::get_node_type() const {
+  switch (m_value.index()) {
+  case 1: {
+    return node_type::Map;
+  } break;
+  case 2: {
+    return node_type::Array;
+  } break;
+  default: {
+    const node *leaf{get_node()};
+    return ((leaf == nullptr) ? (node_type::Null) : (leaf->get_node_type()));
+  } break;
+  }
+}
+
+bool libconfigfile::persistent_value::is_map() const {
+  return std::holds_alternative<persistent_map>(m_value);
+}
+
+bool libconfigfile::persistent_value::is_array() const {
+  return std::holds_alternative<persistent_array>(m_value);
+}
+
+const libconfigfile::node *libconfigfile::persistent_value::get_node() const {
+  const auto *leaf{std::get_if<std::shared_ptr<const node>>(&m_value)};
+  return ((leaf == nullptr) ? (nullptr) : (leaf->get()));
+}
+
+const libconfigfile::persistent_map &
+libconfigfile::persistent_value::as_map() const {
+  return std::get<persistent_map>(m_value);
+}
+
+const libconfigfile::persistent_array &
+libconfigfile::persistent_value::as_array() const {
+  return std::get<persistent_array>(m_value);
+}
+
+libconfigfile::node_ptr<libconfigfile::node>
+libconfigfile::persistent_value::to_node() const {
+  switch (m_value.index()) {
+  case 1: {
+    node_ptr<map_node> ret_val{as_map().to_map_node()};
+    ret_val->set_is_root_map(false);
+    return ret_val;
+  } break;
+  case 2: {
+    return as_array().to_array_node();
+  } break;
+  default: {
+    const node *leaf{get_node()};
+    return node_ptr<node>{((leaf == nullptr) ? (nullptr)
+                                             : (node_clone(*leaf)))};
+  } break;
+  }
+}
+
+bool libconfigfile::operator==(const persistent_value &x,
+                               const persistent_value &y) {
+  if (x.m_value.index() != y.m_value.index()) {
+    return false;
+  } else {
+    switch (x.m_value.index()) {
+    case 1: {
+      return x.as_map() == y.as_map();
+    } break;
+    case 2: {
+      return x.as_array() == y.as_array();
+    } break;
+    default: {
+      const node *x_leaf{x.get_node()};
+      const node *y_leaf{y.get_node()};
+      if ((x_leaf == nullptr) || (y_leaf == nullptr)) {
+        return x_leaf == y_leaf;
+      } else {
+        return node_val_equal_to(*x_leaf, *y_leaf);
+      }
+    } break;
+    }
+  }
+}
+
+bool libconfigfile::operator!=(const persistent_value &x,
+                               const persistent_value &y) {
+  return (!(x == y));
+}
@@ -0,0 +1,269 @@
+#ifndef LIBCONFIGFILE_PERSISTENT_NODES_HPP
+#define LIBCONFIGFILE_PERSISTENT_NODES_HPP
+
+#include "array_node.hpp"
+#include "map_node.hpp"
+#include "node.hpp"
+#include "node_ptr.hpp"
+#include "node_types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace libconfigfile {
+class persistent_value;
+
+namespace impl {
+struct hamt_node;
+struct vector_trie_node;
+} // namespace impl
+
+// Immutable, structurally shared containers for keeping many versions of a
+// config; see the README. They are not node classes, so a tree is converted
+// to and from map_node/array_node, which copies it.
+class persistent_map {
+public:
+  using key_type = std::string;
+  using mapped_type = persistent_value;
+  using value_type = std::pair<const std::string, persistent_value>;
+  using size_type = std::size_t;
+
+public:
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = persistent_map::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+  private:
+    std::vector<std::pair<const impl::hamt_node *, std::size_t>> m_stack;
+    const value_type *m_cur;
+
+  public:
+    const_iterator();
+    explicit const_iterator(const impl::hamt_node *root);
+
+  public:
+    reference operator*() const;
+    pointer operator->() const;
+    const_iterator &operator++();
+    const_iterator operator++(int);
+
+  public:
+    friend bool operator==(const const_iterator &x, const const_iterator &y);
+    friend bool operator!=(const const_iterator &x, const const_iterator &y);
+
+  private:
+    void advance();
+  };
+
+  using iterator = const_iterator;
+
+private:
+  std::shared_ptr<const impl::hamt_node> m_root;
+  size_type m_size;
+
+private:
+  persistent_map(std::shared_ptr<const impl::hamt_node> root,
+                 const size_type size);
+
+public:
+  persistent_map();
+  explicit persistent_map(const map_node &node);
+  persistent_map(const persistent_map &other);
+  persistent_map(persistent_map &&other) noexcept;
+
+  ~persistent_map();
+
+public:
+  persistent_map &operator=(const persistent_map &other);
+  persistent_map &operator=(persistent_map &&other) noexcept;
+
+public:
+  size_type size() const;
+  bool empty() const;
+
+  const persistent_value *find(const std::string_view key) const;
+  bool contains(const std::string_view key) const;
+  const persistent_value &at(const std::string_view key) const;
+
+  const persistent_value *
+  find_in(const std::vector<std::string_view> &key_path) const;
+
+  [[nodiscard]] persistent_map set(std::string key,
+                                   persistent_value value) const;
+  [[nodiscard]] persistent_map erase(const std::string_view key) const;
+  [[nodiscard]] persistent_map
+  set_in(const std::vector<std::string_view> &key_path,
+         persistent_value value) const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  // The map becomes the root map of the tree, as if it had been parsed.
+  node_ptr<map_node> to_map_node() const;
+
+public:
+  friend bool operator==(const persistent_map &x, const persistent_map &y);
+  friend bool operator!=(const persistent_map &x, const persistent_map &y);
+};
+
+class persistent_array {
+public:
+  using value_type = persistent_value;
+  using size_type = std::size_t;
+
+public:
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = persistent_array::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+  private:
+    const persistent_array *m_array;
+    size_type m_index;
+
+  public:
+    const_iterator();
+    const_iterator(const persistent_array *array, const size_type index);
+
+  public:
+    reference operator*() const;
+    pointer operator->() const;
+    const_iterator &operator++();
+    const_iterator operator++(int);
+
+  public:
+    friend bool operator==(const const_iterator &x, const const_iterator &y);
+    friend bool operator!=(const const_iterator &x, const const_iterator &y);
+  };
+
+  using iterator = const_iterator;
+
+private:
+  std::shared_ptr<const impl::vector_trie_node> m_root;
+  std::shared_ptr<const impl::vector_trie_node> m_tail;
+  size_type m_size;
+  unsigned int m_shift;
+
+private:
+  persistent_array(std::shared_ptr<const impl::vector_trie_node> root,
+                   std::shared_ptr<const impl::vector_trie_node> tail,
+                   const size_type size, const unsigned int shift);
+
+public:
+  persistent_array();
+  explicit persistent_array(const array_node &node);
+  persistent_array(const persistent_array &other);
+  persistent_array(persistent_array &&other) noexcept;
+
+  ~persistent_array();
+
+public:
+  persistent_array &operator=(const persistent_array &other);
+  persistent_array &operator=(persistent_array &&other) noexcept;
+
+public:
+  size_type size() const;
+  bool empty() const;
+
+  const persistent_value &operator[](const size_type pos) const;
+  const persistent_value &at(const size_type pos) const;
+
+  [[nodiscard]] persistent_array push_back(persistent_value value) const;
+  [[nodiscard]] persistent_array pop_back() const;
+  [[nodiscard]] persistent_array set(const size_type pos,
+                                     persistent_value value) const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  node_ptr<array_node> to_array_node() const;
+
+private:
+  size_type tail_offset() const;
+
+public:
+  friend bool operator==(const persistent_array &x, const persistent_array &y);
+  friend bool operator!=(const persistent_array &x, const persistent_array &y);
+};
+
+class persistent_value {
+private:
+  std::variant<std::shared_ptr<const node>, persistent_map, persistent_array>
+      m_value;
+
+public:
+  persistent_value();
+  explicit persistent_value(const node &node);
+  persistent_value(persistent_map map);
+  persistent_value(persistent_array array);
+  template <concept_node_type t_node, bool t_compare_equality_by_value>
+  persistent_value(node_ptr<t_node, t_compare_equality_by_value> &&np)
+      : m_value{} {
+    if ((np.get() == nullptr) ||
+        (np->get_node_type() == node_type::Map) ||
+        (np->get_node_type() == node_type::Array)) {
+      *this = ((np.get() == nullptr) ? (persistent_value{})
+                                     : (persistent_value{*np}));
+    } else {
+      m_value = std::shared_ptr<const node>{np.release()};
+    }
+  }
+  persistent_value(const persistent_value &other);
+  persistent_value(persistent_value &&other) noexcept;
+
+  ~persistent_value();
+
+public:
+  persistent_value &operator=(const persistent_value &other);
+  persistent_value &operator=(persistent_value &&other) noexcept;
+
+public:
+  node_type get_node_type() const;
+
+  bool is_map() const;
+  bool is_array() const;
+
+  const node *get_node() const;
+  const persistent_map &as_map() const;
+  const persistent_array &as_array() const;
+
+  node_ptr<node> to_node() const;
+
+public:
+  friend bool operator==(const persistent_value &x, const persistent_value &y);
+  friend bool operator!=(const persistent_value &x, const persistent_value &y);
+};
+
+bool operator==(const persistent_map::const_iterator &x,
+                const persistent_map::const_iterator &y);
+bool operator!=(const persistent_map::const_iterator &x,
+                const persistent_map::const_iterator &y);
+bool operator==(const persistent_map &x, const persistent_map &y);
+bool operator!=(const persistent_map &x, const persistent_map &y);
+
+bool operator==(const persistent_array::const_iterator &x,
+                const persistent_array::const_iterator &y);
+bool operator!=(const persistent_array::const_iterator &x,
+                const persistent_array::const_iterator &y);
+bool operator==(const persistent_array &x, const persistent_array &y);
+bool operator!=(const persistent_array &x, const persistent_array &y);
+
+bool operator==(const persistent_value &x, const persistent_value &y);
+bool operator!=(const persistent_value &x, const persistent_value &y);
+} // namespace libconfigfile
+
+#endif
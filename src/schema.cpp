@@ -0,0 +1,624 @@
+#include "schema.hpp"
+
+#include "array_node.hpp"
+#include "error_messages.hpp"
+#include "event_parser.hpp"
+#include "float_node.hpp"
+#include "integer_node.hpp"
+#include "map_node.hpp"
+#include "node.hpp"
+#include "node_types.hpp"
+#include "node_view.hpp"
+#include "numeral_system.hpp"
+#include "parse_error.hpp"
+#include "parser.hpp"
+#include "perfect_hash.hpp"
+#include "string_node.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace libconfigfile {
+namespace impl {
+static constexpr std::uint8_t schema_type_bit(const node_type type) {
+  return static_cast<std::uint8_t>(1 << static_cast<int>(type));
+}
+
+static constexpr std::uint8_t k_schema_any_type{
+    schema_type_bit(node_type::String) | schema_type_bit(node_type::Integer) |
+    schema_type_bit(node_type::Float) | schema_type_bit(node_type::Array) |
+    schema_type_bit(node_type::Map) | schema_type_bit(node_type::Null)};
+
+static constexpr std::uint8_t k_schema_number_types{
+    schema_type_bit(node_type::Integer) | schema_type_bit(node_type::Float)};
+
+[[noreturn]] static void throw_schema_error(const std::string &path,
+                                            const std::string &what) {
+  throw std::runtime_error{
+      ((path.empty() == true) ? (std::string{"schema root"})
+                              : ("schema field \"" + path + "\"")) +
+      " " + what};
+}
+
+static std::uint8_t schema_type_bit(const std::string_view type_name,
+                                    const std::string &path) {
+  if (type_name == "string") {
+    return schema_type_bit(node_type::String);
+  } else if (type_name == "integer") {
+    return schema_type_bit(node_type::Integer);
+  } else if (type_name == "float") {
+    return schema_type_bit(node_type::Float);
+  } else if (type_name == "array") {
+    return schema_type_bit(node_type::Array);
+  } else if (type_name == "map") {
+    return schema_type_bit(node_type::Map);
+  } else {
+    throw_schema_error(path,
+                       "has unknown type \"" + std::string{type_name} + "\"");
+  }
+}
+
+static bool read_schema_flag(const map_view spec, const std::string_view name,
+                             const std::string &path) {
+  const node_view<node> flag{spec[name]};
+  if (!flag) {
+    return false;
+  }
+  const std::optional<int> value{flag.try_get<int>()};
+  if ((value.has_value() == false) ||
+      ((value.value() != 0) && (value.value() != 1))) {
+    throw_schema_error(path, "has a " + std::string{name} +
+                                 " property that isn't 0 or 1");
+  }
+  return (value.value() == 1);
+}
+
+// Prepends a key or an "[index]" to a key path built from the inside out.
+static void prepend_key_path(std::string &key_path,
+                             const std::string &component) {
+  if ((key_path.empty() == false) && (key_path.front() != '[')) {
+    key_path.insert(0, 1, '.');
+  }
+  key_path.insert(0, component);
+}
+} // namespace impl
+} // namespace libconfigfile
+
+// Checks the values read by an event_parser against a schema as they are
+// read; the maps and arrays being parsed are kept as a stack of the rules of
+// their members.
+class libconfigfile::schema::stream_validator {
+private:
+  struct frame {
+    // npos if the contents may be anything.
+    std::size_t rule;
+    bool is_map;
+    // The field that the current key selected, for maps.
+    std::size_t field;
+    std::size_t required_seen;
+  };
+
+private:
+  const schema &m_schema;
+  std::vector<frame> m_frames;
+
+public:
+  explicit stream_validator(const schema &validator_schema)
+      : m_schema{validator_schema}, m_frames{} {}
+
+public:
+  const error_messages::error_message *
+  begin_map(const std::size_t /*offset*/) {
+    if (m_frames.empty() == true) {
+      m_frames.push_back(
+          frame{m_schema.m_root, true, std::string_view::npos, 0});
+      return nullptr;
+    }
+    return begin_container(node_type::Map);
+  }
+
+  const error_messages::error_message *end_map(const std::size_t /*offset*/) {
+    const frame top{m_frames.back()};
+    m_frames.pop_back();
+    if ((top.rule != std::string_view::npos) &&
+        (top.required_seen != m_schema.m_rules[top.rule].required_count)) {
+      return &error_messages::err_msg_2_3_1;
+    }
+    return nullptr;
+  }
+
+  const error_messages::error_message *
+  begin_array(const std::size_t /*offset*/) {
+    return begin_container(node_type::Array);
+  }
+
+  const error_messages::error_message *
+  end_array(const std::size_t /*offset*/) {
+    m_frames.pop_back();
+    return nullptr;
+  }
+
+  const error_messages::error_message *key(const std::string_view key,
+                                           const std::size_t /*offset*/) {
+    frame &top{m_frames.back()};
+    if (top.rule == std::string_view::npos) {
+      return nullptr;
+    }
+    top.field = m_schema.find_field(top.rule, key);
+    if (top.field != std::string_view::npos) {
+      const field &f{m_schema.m_fields[top.field]};
+      if (f.is_forbidden == true) {
+        return &error_messages::err_msg_2_3_2;
+      } else if (f.is_required == true) {
+        ++top.required_seen;
+      }
+    }
+    return nullptr;
+  }
+
+  const error_messages::error_message *
+  string_value(const std::string_view /*value*/,
+               const std::size_t /*offset*/) {
+    return check(node_type::String, 0, 0.0);
+  }
+
+  const error_messages::error_message *
+  integer_value(const std::int64_t value, const numeral_system & /*num_sys*/,
+                const std::size_t /*offset*/) {
+    return check(node_type::Integer, value, 0.0);
+  }
+
+  const error_messages::error_message *
+  float_value(const double value, const std::size_t /*offset*/) {
+    return check(node_type::Float, 0, value);
+  }
+
+private:
+  std::size_t child_rule() const {
+    const frame &top{m_frames.back()};
+    if (top.rule == std::string_view::npos) {
+      return std::string_view::npos;
+    } else if (top.is_map == true) {
+      return ((top.field == std::string_view::npos)
+                  ? (std::string_view::npos)
+                  : (m_schema.m_fields[top.field].rule));
+    } else {
+      return m_schema.m_rules[top.rule].element;
+    }
+  }
+
+  const error_messages::error_message *
+  check(const node_type type, const std::int64_t integer,
+        const double floating) const {
+    const std::size_t rule_index{child_rule()};
+    return ((rule_index == std::string_view::npos)
+                ? (nullptr)
+                : (m_schema.check_value(rule_index, type, integer, floating)));
+  }
+
+  const error_messages::error_message *
+  begin_container(const node_type type) {
+    const std::size_t rule_index{child_rule()};
+    m_frames.push_back(frame{rule_index, (type == node_type::Map),
+                             std::string_view::npos, 0});
+    return ((rule_index == std::string_view::npos)
+                ? (nullptr)
+                : (m_schema.check_value(rule_index, type, 0, 0.0)));
+  }
+};
+
+libconfigfile::schema_violation::schema_violation(
+    const error_messages::error_message &error, const std::string &key_path)
+    : m_code{error.code}, m_key_path{key_path} {}
+
+libconfigfile::schema_violation::schema_violation(
+    const schema_violation &other)
+    : m_code{other.m_code}, m_key_path{other.m_key_path} {}
+
+libconfigfile::schema_violation::schema_violation(
+    schema_violation &&other) noexcept
+    : m_code{std::move(other.m_code)},
+      m_key_path{std::move(other.m_key_path)} {}
+
+libconfigfile::schema_violation::~schema_violation() {}
+
+libconfigfile::schema_violation &
+libconfigfile::schema_violation::operator=(const schema_violation &other) {
+  if (this != &other) {
+    m_code = other.m_code;
+    m_key_path = other.m_key_path;
+  }
+  return *this;
+}
+
+libconfigfile::schema_violation &
+libconfigfile::schema_violation::operator=(schema_violation &&other) noexcept {
+  if (this != &other) {
+    m_code = std::move(other.m_code);
+    m_key_path = std::move(other.m_key_path);
+  }
+  return *this;
+}
+
+libconfigfile::error_code libconfigfile::schema_violation::code() const {
+  return m_code;
+}
+
+std::string_view libconfigfile::schema_violation::message() const {
+  return error_messages::find_error_message(m_code)->message;
+}
+
+std::string_view libconfigfile::schema_violation::category() const {
+  return error_messages::find_error_message(m_code)->category;
+}
+
+const std::string &libconfigfile::schema_violation::key_path() const {
+  return m_key_path;
+}
+
+libconfigfile::schema::schema(const map_node &spec)
+    : m_rules{}, m_fields{}, m_pilots{}, m_slots{},
+      m_root{std::string_view::npos} {
+  rule root{impl::schema_type_bit(node_type::Map),
+            false,
+            std::numeric_limits<std::int64_t>::min(),
+            std::numeric_limits<std::int64_t>::max(),
+            -std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::infinity(),
+            std::string_view::npos,
+            0,
+            0,
+            0,
+            0,
+            0};
+  compile_fields(spec, "", root);
+  m_root = m_rules.size();
+  m_rules.push_back(root);
+}
+
+libconfigfile::schema::schema(const schema &other)
+    : m_rules{other.m_rules}, m_fields{other.m_fields},
+      m_pilots{other.m_pilots}, m_slots{other.m_slots},
+      m_root{other.m_root} {}
+
+libconfigfile::schema::schema(schema &&other) noexcept
+    : m_rules{std::move(other.m_rules)}, m_fields{std::move(other.m_fields)},
+      m_pilots{std::move(other.m_pilots)}, m_slots{std::move(other.m_slots)},
+      m_root{std::move(other.m_root)} {}
+
+libconfigfile::schema::~schema() {}
+
+libconfigfile::schema &
+libconfigfile::schema::operator=(const schema &other) {
+  if (this != &other) {
+    m_rules = other.m_rules;
+    m_fields = other.m_fields;
+    m_pilots = other.m_pilots;
+    m_slots = other.m_slots;
+    m_root = other.m_root;
+  }
+  return *this;
+}
+
+libconfigfile::schema &
+libconfigfile::schema::operator=(schema &&other) noexcept {
+  if (this != &other) {
+    m_rules = std::move(other.m_rules);
+    m_fields = std::move(other.m_fields);
+    m_pilots = std::move(other.m_pilots);
+    m_slots = std::move(other.m_slots);
+    m_root = std::move(other.m_root);
+  }
+  return *this;
+}
+
+std::expected<void, libconfigfile::schema_violation>
+libconfigfile::schema::validate(const map_node &root) const {
+  std::string key_path{};
+  const error_messages::error_message *error{
+      validate_node(m_root, &root, key_path)};
+  if (error != nullptr) {
+    return std::unexpected{schema_violation{*error, key_path}};
+  }
+  return {};
+}
+
+std::expected<void, libconfigfile::parse_error>
+libconfigfile::schema::validate(const std::string &identifier,
+                                std::istream &input_stream,
+                                const bool identifier_is_file_path
+                                /*= false*/) const {
+  stream_validator validator{*this};
+  return impl::parse_events(validator, identifier, input_stream,
+                            identifier_is_file_path,
+                            parse_options::k_default_max_nesting_depth);
+}
+
+std::expected<void, libconfigfile::parse_error>
+libconfigfile::schema::validate_file(
+    const std::filesystem::path &file_path) const {
+  std::ifstream input_stream{file_path};
+  return validate(file_path.string(), input_stream, true);
+}
+
+std::size_t libconfigfile::schema::compile_rule(const map_node &spec,
+                                                const std::string &path,
+                                                const bool is_field) {
+  for (const auto &member : spec) {
+    if ((member.first != "type") && (member.first != "min") &&
+        (member.first != "max") && (member.first != "element") &&
+        (member.first != "fields") &&
+        (((member.first != "required") && (member.first != "forbidden")) ||
+         (is_field == false))) {
+      impl::throw_schema_error(path, "has unknown property \"" +
+                                         member.first + "\"");
+    }
+  }
+
+  const map_view spec_view{spec};
+  rule ret_val{impl::k_schema_any_type,
+               false,
+               std::numeric_limits<std::int64_t>::min(),
+               std::numeric_limits<std::int64_t>::max(),
+               -std::numeric_limits<double>::infinity(),
+               std::numeric_limits<double>::infinity(),
+               std::string_view::npos,
+               0,
+               0,
+               0,
+               0,
+               0};
+
+  if (const node_view<node> type{spec_view["type"]}; type) {
+    if (const std::optional<std::string_view> type_name{
+            type.try_get<std::string_view>()};
+        type_name.has_value() == true) {
+      ret_val.type_mask = impl::schema_type_bit(type_name.value(), path);
+    } else if (type.is<array_node>() == true) {
+      ret_val.type_mask = 0;
+      for (const auto &element : *(type.as<array_node>().get())) {
+        const std::optional<std::string_view> element_name{
+            node_view<node>{element}.try_get<std::string_view>()};
+        if (element_name.has_value() == false) {
+          impl::throw_schema_error(path, "has a type that isn't a string");
+        }
+        ret_val.type_mask |= impl::schema_type_bit(element_name.value(), path);
+      }
+      if (ret_val.type_mask == 0) {
+        impl::throw_schema_error(path, "has an empty array of types");
+      }
+    } else {
+      impl::throw_schema_error(path, "has a type that isn't a string or an "
+                                     "array of strings");
+    }
+  }
+
+  for (const std::string_view bound : {"min", "max"}) {
+    const node_view<node> value{spec_view[bound]};
+    if (!value) {
+      continue;
+    } else if ((ret_val.type_mask & impl::k_schema_number_types) == 0) {
+      impl::throw_schema_error(path, "has a " + std::string{bound} +
+                                         " but isn't an integer or float");
+    }
+    const bool is_min{bound == "min"};
+    if (const std::optional<std::int64_t> integer{
+            value.try_get<std::int64_t>()};
+        integer.has_value() == true) {
+      (is_min ? ret_val.integer_min : ret_val.integer_max) = integer.value();
+      (is_min ? ret_val.float_min : ret_val.float_max) =
+          static_cast<double>(integer.value());
+    } else if (const std::optional<double> floating{value.try_get<double>()};
+               floating.has_value() == true) {
+      if ((ret_val.type_mask &
+           impl::schema_type_bit(node_type::Integer)) != 0) {
+        impl::throw_schema_error(path, "has a float " + std::string{bound} +
+                                           " but allows integers");
+      }
+      (is_min ? ret_val.float_min : ret_val.float_max) = floating.value();
+    } else {
+      impl::throw_schema_error(path, "has a " + std::string{bound} +
+                                         " that isn't an integer or float");
+    }
+    ret_val.is_float_bounded = true;
+  }
+  if ((ret_val.integer_min > ret_val.integer_max) ||
+      (ret_val.float_min > ret_val.float_max)) {
+    impl::throw_schema_error(path, "has a min greater than its max");
+  }
+
+  if (const node_view<node> element{spec_view["element"]}; element) {
+    if ((ret_val.type_mask & impl::schema_type_bit(node_type::Array)) == 0) {
+      impl::throw_schema_error(path, "has an element type but isn't an array");
+    } else if (element.is<map_node>() == false) {
+      impl::throw_schema_error(path, "has an element type that isn't a map");
+    }
+    ret_val.element =
+        compile_rule(*(element.as<map_node>().get()), path + "[]", false);
+  }
+
+  if (const node_view<node> fields{spec_view["fields"]}; fields) {
+    if ((ret_val.type_mask & impl::schema_type_bit(node_type::Map)) == 0) {
+      impl::throw_schema_error(path, "has fields but isn't a map");
+    } else if (fields.is<map_node>() == false) {
+      impl::throw_schema_error(path, "has fields that aren't a map");
+    }
+    compile_fields(*(fields.as<map_node>().get()), path, ret_val);
+  }
+
+  m_rules.push_back(ret_val);
+  return (m_rules.size() - 1);
+}
+
+void libconfigfile::schema::compile_fields(const map_node &fields,
+                                           const std::string &path,
+                                           rule &map_rule) {
+  std::vector<std::string> keys{};
+  for (const auto &member : fields) {
+    keys.push_back(member.first);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  // The rules of the fields are compiled first, as they add fields of their
+  // own, so that these end up next to each other.
+  std::vector<field> compiled{};
+  for (const std::string &key : keys) {
+    const std::string field_path{((path.empty() == true) ? (key)
+                                                         : (path + "." + key))};
+    const map_view spec{
+        node_view<node>{fields.find(key)->second}.as<map_node>()};
+    if (spec.get() == nullptr) {
+      impl::throw_schema_error(field_path, "isn't a map");
+    }
+    field f{key, std::string_view::npos,
+            impl::read_schema_flag(spec, "required", field_path),
+            impl::read_schema_flag(spec, "forbidden", field_path)};
+    if ((f.is_required == true) && (f.is_forbidden == true)) {
+      impl::throw_schema_error(field_path, "is both required and forbidden");
+    }
+    f.rule = compile_rule(*(spec.get()), field_path, true);
+    if (f.is_required == true) {
+      ++map_rule.required_count;
+    }
+    compiled.push_back(std::move(f));
+  }
+
+  map_rule.first_field = m_fields.size();
+  map_rule.field_count = compiled.size();
+  std::vector<std::string_view> names{};
+  for (field &f : compiled) {
+    m_fields.push_back(std::move(f));
+  }
+  for (std::size_t i{0}; i < map_rule.field_count; ++i) {
+    names.push_back(m_fields[map_rule.first_field + i].key);
+  }
+
+  map_rule.first_pilot = m_pilots.size();
+  map_rule.first_slot = m_slots.size();
+  m_pilots.resize(m_pilots.size() +
+                  impl::perfect_hash_bucket_count(map_rule.field_count));
+  m_slots.resize(m_slots.size() +
+                 impl::perfect_hash_slot_count(map_rule.field_count));
+  if (impl::build_perfect_hash(
+          names, std::span{m_pilots}.subspan(map_rule.first_pilot),
+          std::span{m_slots}.subspan(map_rule.first_slot)) == false) {
+    impl::throw_schema_error(path, "has fields for which no perfect hash was "
+                                   "found");
+  }
+}
+
+std::size_t
+libconfigfile::schema::find_field(const std::size_t rule_index,
+                                  const std::string_view key) const {
+  const rule &r{m_rules[rule_index]};
+  if (r.field_count == 0) {
+    return std::string_view::npos;
+  }
+  const std::size_t pos{impl::find_perfect_hash(
+      key,
+      std::span{m_pilots}.subspan(
+          r.first_pilot, impl::perfect_hash_bucket_count(r.field_count)),
+      std::span{m_slots}.subspan(
+          r.first_slot, impl::perfect_hash_slot_count(r.field_count)))};
+  return (((pos != std::string_view::npos) &&
+           (m_fields[r.first_field + pos].key == key))
+              ? (r.first_field + pos)
+              : (std::string_view::npos));
+}
+
+const libconfigfile::error_messages::error_message *
+libconfigfile::schema::check_value(const std::size_t rule_index,
+                                   const node_type type,
+                                   const std::int64_t integer,
+                                   const double floating) const {
+  const rule &r{m_rules[rule_index]};
+  if ((r.type_mask & impl::schema_type_bit(type)) == 0) {
+    return &error_messages::err_msg_2_1_1;
+  } else if ((type == node_type::Integer) &&
+             ((integer < r.integer_min) || (integer > r.integer_max))) {
+    return &error_messages::err_msg_2_2_1;
+  } else if ((type == node_type::Float) && (r.is_float_bounded == true) &&
+             (((floating >= r.float_min) && (floating <= r.float_max)) ==
+              false)) {
+    return &error_messages::err_msg_2_2_2;
+  }
+  return nullptr;
+}
+
+const libconfigfile::error_messages::error_message *
+libconfigfile::schema::validate_node(const std::size_t rule_index,
+                                     const node *value,
+                                     std::string &key_path) const {
+  const node_type type{((value == nullptr) ? (node_type::Null)
+                                           : (value->get_node_type()))};
+  const error_messages::error_message *ret_val{check_value(
+      rule_index, type,
+      ((type == node_type::Integer)
+           ? (static_cast<const integer_node *>(value)->get())
+           : (0)),
+      ((type == node_type::Float)
+           ? (static_cast<const float_node *>(value)->get())
+           : (0.0)))};
+  if (ret_val != nullptr) {
+    return ret_val;
+  }
+
+  const rule &r{m_rules[rule_index]};
+  if ((type == node_type::Array) && (r.element != std::string_view::npos)) {
+    const array_node &array{*static_cast<const array_node *>(value)};
+    for (std::size_t i{0}; i < array.size(); ++i) {
+      ret_val = validate_node(r.element, array[i].get(), key_path);
+      if (ret_val != nullptr) {
+        impl::prepend_key_path(key_path, "[" + std::to_string(i) + "]");
+        return ret_val;
+      }
+    }
+  } else if (type == node_type::Map) {
+    const map_node &map{*static_cast<const map_node *>(value)};
+    std::size_t required_seen{0};
+    for (const auto &member : map) {
+      const std::size_t field_index{find_field(rule_index, member.first)};
+      if (field_index == std::string_view::npos) {
+        continue;
+      }
+      const field &f{m_fields[field_index]};
+      if (f.is_forbidden == true) {
+        ret_val = &error_messages::err_msg_2_3_2;
+      } else {
+        if (f.is_required == true) {
+          ++required_seen;
+        }
+        ret_val = validate_node(f.rule, member.second.get(), key_path);
+      }
+      if (ret_val != nullptr) {
+        impl::prepend_key_path(key_path, member.first);
+        return ret_val;
+      }
+    }
+
+    if (required_seen != r.required_count) {
+      for (std::size_t i{0}; i < r.field_count; ++i) {
+        const field &f{m_fields[r.first_field + i]};
+        if ((f.is_required == true) && (map.contains(f.key) == false)) {
+          key_path = f.key;
+          return &error_messages::err_msg_2_3_1;
+        }
+      }
+    }
+  }
+  return nullptr;
+}
@@ -0,0 +1,145 @@
+#ifndef LIBCONFIGFILE_SCHEMA_HPP
+#define LIBCONFIGFILE_SCHEMA_HPP
+
+#include "error_messages.hpp"
+#include "map_node.hpp"
+#include "node.hpp"
+#include "node_types.hpp"
+#include "parse_error.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libconfigfile {
+// A value of a tree that doesn't match a schema. The key path names it from
+// the root, e.g. "upstreams[2].port".
+class schema_violation {
+private:
+  error_code m_code;
+  std::string m_key_path;
+
+public:
+  explicit schema_violation(const error_messages::error_message &error,
+                            const std::string &key_path);
+
+  schema_violation(const schema_violation &other);
+  schema_violation(schema_violation &&other) noexcept;
+
+  ~schema_violation();
+
+public:
+  schema_violation &operator=(const schema_violation &other);
+  schema_violation &operator=(schema_violation &&other) noexcept;
+
+public:
+  error_code code() const;
+  std::string_view message() const;
+  std::string_view category() const;
+  const std::string &key_path() const;
+};
+
+// Rules for the contents of a config, written in the config syntax and
+// compiled once into flat tables: a bitmask of the allowed types and the
+// bounds of each value, and a perfect hash table of the fields of each map.
+//
+// The root map of the schema holds the fields of the config's root map. Each
+// field is a map holding:
+//   type = "string";      or an array of type names; any type if absent
+//   min = NUMBER;         for integers and floats, the smallest value allowed
+//   max = NUMBER;         for integers and floats, the largest value allowed
+//   required = 1;         to reject maps without the key
+//   forbidden = 1;        to reject maps with the key
+//   element = { ... };    for arrays, the rules of their elements
+//   fields = { ... };     for maps, their fields
+// e.g.
+//   port = { type = "integer"; min = 1; max = 65535; required = 1; };
+//   ratio = { type = ["integer", "float"]; min = 0; max = 1; };
+//   hosts = { type = "array"; element = { type = "string"; }; };
+// Keys that aren't fields of their map are allowed and not checked.
+//
+// A tree is validated in one pass over its nodes. A config can also be
+// validated while it is parsed, without building any nodes, by validate()
+// with a stream and validate_file(); violations are then reported like the
+// errors of try_parse(), in the /error/semantic/ categories, and `@include`
+// is not supported.
+class schema {
+private:
+  struct rule {
+    // Bit n is set if node_type n is allowed.
+    std::uint8_t type_mask;
+    bool is_float_bounded;
+    std::int64_t integer_min;
+    std::int64_t integer_max;
+    double float_min;
+    double float_max;
+    // The rule of an array's elements, or npos if they may be anything.
+    std::size_t element;
+    // A map's fields, in m_fields, and their hash table, in m_pilots and
+    // m_slots.
+    std::size_t first_field;
+    std::size_t field_count;
+    std::size_t required_count;
+    std::size_t first_pilot;
+    std::size_t first_slot;
+  };
+
+  struct field {
+    std::string key;
+    std::size_t rule;
+    bool is_required;
+    bool is_forbidden;
+  };
+
+  class stream_validator;
+
+private:
+  std::vector<rule> m_rules;
+  std::vector<field> m_fields;
+  std::vector<std::uint32_t> m_pilots;
+  std::vector<std::size_t> m_slots;
+  std::size_t m_root;
+
+public:
+  // Throws std::runtime_error if `spec` isn't a valid schema.
+  explicit schema(const map_node &spec);
+
+  schema(const schema &other);
+  schema(schema &&other) noexcept;
+
+  ~schema();
+
+public:
+  schema &operator=(const schema &other);
+  schema &operator=(schema &&other) noexcept;
+
+public:
+  std::expected<void, schema_violation> validate(const map_node &root) const;
+  std::expected<void, parse_error>
+  validate(const std::string &identifier, std::istream &input_stream,
+           const bool identifier_is_file_path = false) const;
+  std::expected<void, parse_error>
+  validate_file(const std::filesystem::path &file_path) const;
+
+private:
+  std::size_t compile_rule(const map_node &spec, const std::string &path,
+                           const bool is_field);
+  void compile_fields(const map_node &fields, const std::string &path,
+                      rule &map_rule);
+  std::size_t find_field(const std::size_t rule_index,
+                         const std::string_view key) const;
+  const error_messages::error_message *
+  check_value(const std::size_t rule_index, const node_type type,
+              const std::int64_t integer, const double floating) const;
+  const error_messages::error_message *
+  validate_node(const std::size_t rule_index, const node *value,
+                std::string &key_path) const;
+};
+} // namespace libconfigfile
+
+#endif
@@ -0,0 +1,347 @@
+#include "shared_config.hpp"
+
+#include "config_image.hpp"
+#include "map_node.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace libconfigfile {
+namespace impl {
+static constexpr char k_shared_config_magic[8]{'L', 'C', 'F', 'S',
+                                               'H', 'M', '\0', '\0'};
+static constexpr std::uint32_t k_shared_config_version{1};
+
+struct shared_config_control {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t reserved_1;
+  std::uint64_t generation;
+};
+
+static_assert(std::atomic_ref<std::uint64_t>::is_always_lock_free,
+              "the generation must be lock-free to be shared between "
+              "processes");
+
+static std::atomic_ref<std::uint64_t>
+shared_generation(const void *control) {
+  return std::atomic_ref<std::uint64_t>{
+      const_cast<shared_config_control *>(
+          static_cast<const shared_config_control *>(control))
+          ->generation};
+}
+
+static std::string shared_image_name(const std::string &name,
+                                     const std::uint64_t generation) {
+  return name + '.' + std::to_string(generation);
+}
+
+[[noreturn]] static void throw_shared_config_error(const int error,
+                                                   const std::string &name,
+                                                   const std::string &what) {
+  throw std::system_error{error, std::generic_category(),
+                          "shared memory object \"" + name + "\" " + what};
+}
+
+static void *map_shared_control(const std::string &name, const int fd,
+                                const bool is_writable) {
+  void *ret_val{mmap(nullptr, sizeof(shared_config_control),
+                     ((is_writable == true) ? (PROT_READ | PROT_WRITE)
+                                            : (PROT_READ)),
+                     MAP_SHARED, fd, 0)};
+  if (ret_val == MAP_FAILED) {
+    const int error{errno};
+    close(fd);
+    throw_shared_config_error(error, name, "could not be mapped");
+  }
+  close(fd);
+  return ret_val;
+}
+
+static const void *open_shared_control(const std::string &name) {
+  const int fd{shm_open(name.c_str(), O_RDONLY, 0)};
+  if (fd == -1) {
+    throw_shared_config_error(errno, name, "could not be opened");
+  }
+
+  struct stat status{};
+  if (fstat(fd, &status) == -1) {
+    const int error{errno};
+    close(fd);
+    throw_shared_config_error(error, name, "could not be examined");
+  } else if (static_cast<std::size_t>(status.st_size) <
+             sizeof(shared_config_control)) {
+    close(fd);
+    throw std::runtime_error{"nothing has been published to shared config \"" +
+                             name + "\""};
+  }
+  return map_shared_control(name, fd, false);
+}
+
+static bool is_shared_config_control(const void *control) {
+  const shared_config_control *header{
+      static_cast<const shared_config_control *>(control)};
+  return ((std::memcmp(header->magic, k_shared_config_magic,
+                       sizeof(header->magic)) == 0) &&
+          (header->version == k_shared_config_version));
+}
+
+static void write_shared_image(const std::string &image_name,
+                               const std::filesystem::perms permissions,
+                               const std::string_view image) {
+  int fd{shm_open(image_name.c_str(), O_RDWR | O_CREAT | O_EXCL,
+                  static_cast<mode_t>(permissions))};
+  if ((fd == -1) && (errno == EEXIST)) {
+    // Left behind by a publisher that died before publishing it.
+    shm_unlink(image_name.c_str());
+    fd = shm_open(image_name.c_str(), O_RDWR | O_CREAT | O_EXCL,
+                  static_cast<mode_t>(permissions));
+  }
+  if (fd == -1) {
+    throw_shared_config_error(errno, image_name, "could not be created");
+  }
+
+  // Reserving the memory up front turns running out of it into an error
+  // here rather than a SIGBUS while copying.
+  int error{0};
+  if (ftruncate(fd, static_cast<off_t>(image.size())) == -1) {
+    error = errno;
+  } else if (const int fallocate_error{posix_fallocate(
+                 fd, 0, static_cast<off_t>(image.size()))};
+             (fallocate_error != 0) && (fallocate_error != EINVAL) &&
+             (fallocate_error != EOPNOTSUPP)) {
+    error = fallocate_error;
+  }
+
+  void *mapping{MAP_FAILED};
+  if (error == 0) {
+    mapping = mmap(nullptr, image.size(), PROT_READ | PROT_WRITE, MAP_SHARED,
+                   fd, 0);
+    if (mapping == MAP_FAILED) {
+      error = errno;
+    }
+  }
+  close(fd);
+  if (error != 0) {
+    shm_unlink(image_name.c_str());
+    throw_shared_config_error(error, image_name, "could not be written");
+  }
+
+  std::memcpy(mapping, image.data(), image.size());
+  munmap(mapping, image.size());
+}
+} // namespace impl
+} // namespace libconfigfile
+
+libconfigfile::shared_config_publisher::shared_config_publisher(
+    const std::string &name,
+    const std::filesystem::perms permissions /*= k_default_permissions*/)
+    : m_name{name}, m_permissions{permissions}, m_control{nullptr} {
+  const int fd{shm_open(m_name.c_str(), O_RDWR | O_CREAT,
+                        static_cast<mode_t>(m_permissions))};
+  if (fd == -1) {
+    impl::throw_shared_config_error(errno, m_name, "could not be opened");
+  }
+
+  struct stat status{};
+  if (fstat(fd, &status) == -1) {
+    const int error{errno};
+    close(fd);
+    impl::throw_shared_config_error(error, m_name, "could not be examined");
+  }
+  const bool is_new{status.st_size == 0};
+  if ((is_new == true) &&
+      (ftruncate(fd, sizeof(impl::shared_config_control)) == -1)) {
+    const int error{errno};
+    close(fd);
+    impl::throw_shared_config_error(error, m_name, "could not be resized");
+  } else if ((is_new == false) &&
+             (static_cast<std::size_t>(status.st_size) <
+              sizeof(impl::shared_config_control))) {
+    close(fd);
+    throw std::runtime_error{"shared memory object \"" + m_name +
+                             "\" is not a shared config"};
+  }
+  m_control = impl::map_shared_control(m_name, fd, true);
+
+  if (is_new == true) {
+    impl::shared_config_control *control{
+        static_cast<impl::shared_config_control *>(m_control)};
+    std::memcpy(control->magic, impl::k_shared_config_magic,
+                sizeof(control->magic));
+    control->version = impl::k_shared_config_version;
+  } else if (impl::is_shared_config_control(m_control) == false) {
+    munmap(m_control, sizeof(impl::shared_config_control));
+    throw std::runtime_error{"shared memory object \"" + m_name +
+                             "\" is not a shared config"};
+  }
+}
+
+libconfigfile::shared_config_publisher::shared_config_publisher(
+    shared_config_publisher &&other) noexcept
+    : m_name{std::move(other.m_name)}, m_permissions{other.m_permissions},
+      m_control{std::exchange(other.m_control, nullptr)} {}
+
+libconfigfile::shared_config_publisher::~shared_config_publisher() {
+  if (m_control != nullptr) {
+    munmap(m_control, sizeof(impl::shared_config_control));
+  }
+}
+
+libconfigfile::shared_config_publisher &
+libconfigfile::shared_config_publisher::operator=(
+    shared_config_publisher &&other) noexcept {
+  if (this != &other) {
+    if (m_control != nullptr) {
+      munmap(m_control, sizeof(impl::shared_config_control));
+    }
+    m_name = std::move(other.m_name);
+    m_permissions = other.m_permissions;
+    m_control = std::exchange(other.m_control, nullptr);
+  }
+  return *this;
+}
+
+std::uint64_t
+libconfigfile::shared_config_publisher::publish(const map_node &root) {
+  const std::uint64_t generation{get_generation() + 1};
+  impl::write_shared_image(impl::shared_image_name(m_name, generation),
+                           m_permissions, compile_image(root));
+  impl::shared_generation(m_control).store(generation,
+                                           std::memory_order_release);
+
+  // The previous generation is kept so that a reader which has just read its
+  // number can still open it.
+  if (generation > 2) {
+    shm_unlink(impl::shared_image_name(m_name, generation - 2).c_str());
+  }
+  return generation;
+}
+
+std::uint64_t libconfigfile::shared_config_publisher::get_generation() const {
+  return impl::shared_generation(m_control).load(std::memory_order_acquire);
+}
+
+libconfigfile::shared_config::shared_config(const std::string &name)
+    : m_name{name}, m_control{impl::open_shared_control(name)},
+      m_generation{0}, m_image{} {
+  try {
+    // The header is written before the first generation is published.
+    if (impl::shared_generation(m_control).load(std::memory_order_acquire) ==
+        0) {
+      throw std::runtime_error{
+          "nothing has been published to shared config \"" + m_name + "\""};
+    } else if (impl::is_shared_config_control(m_control) == false) {
+      throw std::runtime_error{"shared memory object \"" + m_name +
+                               "\" is not a shared config"};
+    }
+    refresh();
+  } catch (...) {
+    munmap(const_cast<void *>(m_control), sizeof(impl::shared_config_control));
+    throw;
+  }
+}
+
+libconfigfile::shared_config::shared_config(shared_config &&other) noexcept
+    : m_name{std::move(other.m_name)},
+      m_control{std::exchange(other.m_control, nullptr)},
+      m_generation{std::exchange(other.m_generation, 0)},
+      m_image{std::move(other.m_image)} {}
+
+libconfigfile::shared_config::~shared_config() {
+  if (m_control != nullptr) {
+    munmap(const_cast<void *>(m_control), sizeof(impl::shared_config_control));
+  }
+}
+
+libconfigfile::shared_config &
+libconfigfile::shared_config::operator=(shared_config &&other) noexcept {
+  if (this != &other) {
+    if (m_control != nullptr) {
+      munmap(const_cast<void *>(m_control),
+             sizeof(impl::shared_config_control));
+    }
+    m_name = std::move(other.m_name);
+    m_control = std::exchange(other.m_control, nullptr);
+    m_generation = std::exchange(other.m_generation, 0);
+    m_image = std::move(other.m_image);
+  }
+  return *this;
+}
+
+std::string_view libconfigfile::shared_config::bytes() const {
+  return m_image.bytes();
+}
+
+libconfigfile::image_view libconfigfile::shared_config::root() const {
+  return m_image.root();
+}
+
+std::uint64_t libconfigfile::shared_config::get_generation() const {
+  return m_generation;
+}
+
+bool libconfigfile::shared_config::is_stale() const {
+  return (impl::shared_generation(m_control).load(
+              std::memory_order_acquire) != m_generation);
+}
+
+bool libconfigfile::shared_config::refresh() {
+  while (true) {
+    const std::uint64_t generation{
+        impl::shared_generation(m_control).load(std::memory_order_acquire)};
+    if (generation == m_generation) {
+      return false;
+    }
+
+    const std::string image_name{impl::shared_image_name(m_name, generation)};
+    const int fd{shm_open(image_name.c_str(), O_RDONLY, 0)};
+    if (fd == -1) {
+      const int error{errno};
+      // Two more generations were published in the meantime.
+      if ((error == ENOENT) &&
+          (impl::shared_generation(m_control).load(
+               std::memory_order_acquire) != generation)) {
+        continue;
+      }
+      impl::throw_shared_config_error(error, image_name,
+                                      "could not be opened");
+    }
+
+    try {
+      m_image = config_image{fd, image_name};
+    } catch (...) {
+      close(fd);
+      throw;
+    }
+    close(fd);
+    m_generation = generation;
+    return true;
+  }
+}
+
+void libconfigfile::remove_shared_config(const std::string &name) {
+  const void *control{impl::open_shared_control(name)};
+  const std::uint64_t generation{
+      impl::shared_generation(control).load(std::memory_order_acquire)};
+  munmap(const_cast<void *>(control), sizeof(impl::shared_config_control));
+
+  shm_unlink(name.c_str());
+  for (std::uint64_t i{0}; (i < 2) && (i < generation); ++i) {
+    shm_unlink(impl::shared_image_name(name, generation - i).c_str());
+  }
+}
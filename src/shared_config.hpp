@@ -0,0 +1,94 @@
+#ifndef LIBCONFIGFILE_SHARED_CONFIG_HPP
+#define LIBCONFIGFILE_SHARED_CONFIG_HPP
+
+#include "config_image.hpp"
+#include "map_node.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace libconfigfile {
+// Publication of config images in POSIX shared memory, so that every process
+// on a host reads the same single copy of a tree.
+//
+// A shared config named "/name" consists of a small control object "/name"
+// holding the current generation number, and one object "/name.<generation>"
+// holding the image of each published tree. Publishing writes a new object
+// and then atomically updates the generation, so readers never see a partly
+// written tree. Objects are unlinked two generations later, but the memory of
+// an unlinked object stays valid for as long as a reader still maps it.
+// Names must follow the rules for shm_open(): a leading '/' and no other.
+class shared_config_publisher {
+private:
+  std::string m_name;
+  std::filesystem::perms m_permissions;
+  void *m_control;
+
+public:
+  static constexpr std::filesystem::perms k_default_permissions{
+      std::filesystem::perms::owner_read | std::filesystem::perms::owner_write |
+      std::filesystem::perms::group_read | std::filesystem::perms::others_read};
+
+public:
+  // Creates the control object, or continues from the generation of an
+  // existing one. There must be at most one publisher for a name at a time.
+  explicit shared_config_publisher(
+      const std::string &name,
+      const std::filesystem::perms permissions = k_default_permissions);
+  shared_config_publisher(const shared_config_publisher &other) = delete;
+  shared_config_publisher(shared_config_publisher &&other) noexcept;
+
+  ~shared_config_publisher();
+
+public:
+  shared_config_publisher &
+  operator=(const shared_config_publisher &other) = delete;
+  shared_config_publisher &operator=(shared_config_publisher &&other) noexcept;
+
+public:
+  // Returns the generation of the published tree.
+  std::uint64_t publish(const map_node &root);
+  std::uint64_t get_generation() const;
+};
+
+// A read-only attachment to the current generation of a shared config. Views
+// into it remain valid until refresh() moves it to a newer generation.
+class shared_config {
+private:
+  std::string m_name;
+  const void *m_control;
+  std::uint64_t m_generation;
+  config_image m_image;
+
+public:
+  // Throws std::runtime_error if nothing has been published under `name` yet.
+  explicit shared_config(const std::string &name);
+  shared_config(const shared_config &other) = delete;
+  shared_config(shared_config &&other) noexcept;
+
+  ~shared_config();
+
+public:
+  shared_config &operator=(const shared_config &other) = delete;
+  shared_config &operator=(shared_config &&other) noexcept;
+
+public:
+  std::string_view bytes() const;
+  image_view root() const;
+  std::uint64_t get_generation() const;
+
+  // Whether a newer generation has been published since attaching.
+  bool is_stale() const;
+  // Attaches to the newest generation if it isn't already, returning whether
+  // it did.
+  bool refresh();
+};
+
+// Unlinks the objects of a shared config. Processes still attached to it are
+// unaffected.
+void remove_shared_config(const std::string &name);
+} // namespace libconfigfile
+
+#endif
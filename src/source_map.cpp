@@ -0,0 +1,223 @@
+#include "source_map.hpp"
+
+#include "array_node.hpp"
+#include "map_node.hpp"
+#include "newline_index.hpp"
+#include "node.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+libconfigfile::source_map::source_map()
+    : m_files{}, m_nodes{}, m_spans{}, m_is_sorted{true} {}
+
+libconfigfile::source_map::source_map(const source_map &other)
+    : m_files{other.m_files}, m_nodes{other.m_nodes}, m_spans{other.m_spans},
+      m_is_sorted{other.m_is_sorted} {}
+
+libconfigfile::source_map::source_map(source_map &&other) noexcept
+    : m_files{std::move(other.m_files)}, m_nodes{std::move(other.m_nodes)},
+      m_spans{std::move(other.m_spans)},
+      m_is_sorted{std::move(other.m_is_sorted)} {}
+
+libconfigfile::source_map::~source_map() {}
+
+libconfigfile::source_map &
+libconfigfile::source_map::operator=(const source_map &other) {
+  if (this != &other) {
+    m_files = other.m_files;
+    m_nodes = other.m_nodes;
+    m_spans = other.m_spans;
+    m_is_sorted = other.m_is_sorted;
+  }
+  return *this;
+}
+
+libconfigfile::source_map &
+libconfigfile::source_map::operator=(source_map &&other) noexcept {
+  if (this != &other) {
+    m_files = std::move(other.m_files);
+    m_nodes = std::move(other.m_nodes);
+    m_spans = std::move(other.m_spans);
+    m_is_sorted = std::move(other.m_is_sorted);
+  }
+  return *this;
+}
+
+std::uint32_t
+libconfigfile::source_map::add_file(const std::string &identifier) {
+  m_files.push_back(file{identifier, std::string{}, newline_index{}});
+  return static_cast<std::uint32_t>(m_files.size() - 1);
+}
+
+void libconfigfile::source_map::set_file_text(const std::uint32_t file_id,
+                                              std::string &&text) {
+  file &f{m_files.at(file_id)};
+  f.text = std::move(text);
+  f.newlines.clear();
+}
+
+void libconfigfile::source_map::insert(const node *value,
+                                       const source_span &span) {
+  m_nodes.push_back(value);
+  m_spans.push_back(span);
+  m_is_sorted = false;
+}
+
+void libconfigfile::source_map::erase(const node *value) {
+  if (value == nullptr) {
+    return;
+  }
+
+  std::vector<const node *> erased{};
+  std::vector<const node *> pending{value};
+  while (pending.empty() == false) {
+    const node *cur{pending.back()};
+    pending.pop_back();
+    erased.push_back(cur);
+
+    if (cur->get_node_type() == node_type::Map) {
+      const map_node *map{static_cast<const map_node *>(cur)};
+      if (map->is_materialized() == true) {
+        for (const auto &member : *map) {
+          if (member.second.get() != nullptr) {
+            pending.push_back(member.second.get());
+          }
+        }
+      }
+    } else if (cur->get_node_type() == node_type::Array) {
+      const array_node *array{static_cast<const array_node *>(cur)};
+      if (array->is_materialized() == true) {
+        for (const auto &element : *array) {
+          if (element.get() != nullptr) {
+            pending.push_back(element.get());
+          }
+        }
+      }
+    }
+  }
+  std::sort(erased.begin(), erased.end(), std::less<const node *>{});
+
+  std::size_t kept{0};
+  for (std::size_t i{0}; i < m_nodes.size(); ++i) {
+    if (std::binary_search(erased.begin(), erased.end(), m_nodes[i],
+                           std::less<const node *>{}) == false) {
+      m_nodes[kept] = m_nodes[i];
+      m_spans[kept] = m_spans[i];
+      ++kept;
+    }
+  }
+  m_nodes.resize(kept);
+  m_spans.resize(kept);
+}
+
+void libconfigfile::source_map::erase_files_from(
+    const std::uint32_t first_file_id) {
+  std::size_t kept{0};
+  for (std::size_t i{0}; i < m_nodes.size(); ++i) {
+    if (m_spans[i].file_id < first_file_id) {
+      m_nodes[kept] = m_nodes[i];
+      m_spans[kept] = m_spans[i];
+      ++kept;
+    }
+  }
+  m_nodes.resize(kept);
+  m_spans.resize(kept);
+}
+
+const libconfigfile::source_span *
+libconfigfile::source_map::find(const node *value) const {
+  sort();
+  const auto pos{std::lower_bound(m_nodes.begin(), m_nodes.end(), value,
+                                  std::less<const node *>{})};
+  if ((pos == m_nodes.end()) || (*pos != value)) {
+    return nullptr;
+  } else {
+    return &m_spans[static_cast<std::size_t>(pos - m_nodes.begin())];
+  }
+}
+
+bool libconfigfile::source_map::contains(const node *value) const {
+  return (find(value) != nullptr);
+}
+
+std::size_t libconfigfile::source_map::size() const {
+  sort();
+  return m_nodes.size();
+}
+
+bool libconfigfile::source_map::empty() const { return m_nodes.empty(); }
+
+std::size_t libconfigfile::source_map::file_count() const {
+  return m_files.size();
+}
+
+const std::string &
+libconfigfile::source_map::file_identifier(const std::uint32_t file_id) const {
+  return m_files.at(file_id).identifier;
+}
+
+std::string_view
+libconfigfile::source_map::file_text(const std::uint32_t file_id) const {
+  return m_files.at(file_id).text;
+}
+
+std::pair<long long, long long>
+libconfigfile::source_map::begin_position(const source_span &span) const {
+  const file &f{m_files.at(span.file_id)};
+  return f.newlines.position(f.text, span.begin_offset + 1);
+}
+
+std::pair<long long, long long>
+libconfigfile::source_map::end_position(const source_span &span) const {
+  const file &f{m_files.at(span.file_id)};
+  return f.newlines.position(f.text, span.end_offset);
+}
+
+void libconfigfile::source_map::clear() {
+  m_files.clear();
+  m_nodes.clear();
+  m_spans.clear();
+  m_is_sorted = true;
+}
+
+void libconfigfile::source_map::sort() const {
+  if (m_is_sorted == true) {
+    return;
+  }
+
+  std::vector<std::size_t> order(m_nodes.size());
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::stable_sort(order.begin(), order.end(),
+                   [this](const std::size_t lhs, const std::size_t rhs) {
+                     return std::less<const node *>{}(m_nodes[lhs],
+                                                      m_nodes[rhs]);
+                   });
+
+  // A node freed during parsing (e.g. a value discarded while recovering
+  // from an error) can have its address reused by a later one, so of the
+  // entries for an address only the most recently inserted is kept.
+  std::vector<const node *> nodes{};
+  std::vector<source_span> spans{};
+  nodes.reserve(order.size());
+  spans.reserve(order.size());
+  for (std::size_t i{0}; i < order.size(); ++i) {
+    if ((i + 1 < order.size()) &&
+        (m_nodes[order[i]] == m_nodes[order[i + 1]])) {
+      continue;
+    }
+    nodes.push_back(m_nodes[order[i]]);
+    spans.push_back(m_spans[order[i]]);
+  }
+
+  m_nodes = std::move(nodes);
+  m_spans = std::move(spans);
+  m_is_sorted = true;
+}
@@ -0,0 +1,89 @@
+#ifndef LIBCONFIGFILE_SOURCE_MAP_HPP
+#define LIBCONFIGFILE_SOURCE_MAP_HPP
+
+#include "newline_index.hpp"
+#include "node.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace libconfigfile {
+struct source_span {
+  std::uint32_t file_id;
+  std::size_t begin_offset;
+  std::size_t end_offset;
+};
+
+// Side table from parsed nodes to the bytes they were parsed from, filled in
+// by the parser when parse_options::spans points to one. Spans are kept in
+// arrays parallel to the node addresses rather than in the nodes themselves,
+// so nothing is stored when no source_map is given. Entries refer to the tree
+// as it was returned by the parser and are not updated if it is modified.
+//
+// Lookups sort the table and build newline indices on first use; they are not
+// safe to call concurrently on the same object before that.
+class source_map {
+private:
+  struct file {
+    std::string identifier;
+    std::string text;
+    mutable newline_index newlines;
+  };
+
+private:
+  std::vector<file> m_files;
+  mutable std::vector<const node *> m_nodes;
+  mutable std::vector<source_span> m_spans;
+  mutable bool m_is_sorted;
+
+public:
+  source_map();
+
+  source_map(const source_map &other);
+  source_map(source_map &&other) noexcept;
+
+  ~source_map();
+
+public:
+  source_map &operator=(const source_map &other);
+  source_map &operator=(source_map &&other) noexcept;
+
+public:
+  std::uint32_t add_file(const std::string &identifier);
+  void set_file_text(const std::uint32_t file_id, std::string &&text);
+  void insert(const node *value, const source_span &span);
+  // Removes the spans of value and of the nodes nested in it, e.g. when it is
+  // discarded. Containers that haven't been materialized are not descended
+  // into, as no spans are recorded for their contents.
+  void erase(const node *value);
+  // Removes the spans recorded from file first_file_id and from the files
+  // added after it, i.e. those of a parse that was abandoned.
+  void erase_files_from(const std::uint32_t first_file_id);
+
+  const source_span *find(const node *value) const;
+  bool contains(const node *value) const;
+
+  std::size_t size() const;
+  bool empty() const;
+  std::size_t file_count() const;
+  const std::string &file_identifier(const std::uint32_t file_id) const;
+  std::string_view file_text(const std::uint32_t file_id) const;
+
+  // (line, character) of the first and last character of the span, numbered
+  // as in syntax_error.
+  std::pair<long long, long long>
+  begin_position(const source_span &span) const;
+  std::pair<long long, long long> end_position(const source_span &span) const;
+
+  void clear();
+
+private:
+  void sort() const;
+};
+} // namespace libconfigfile
+
+#endif
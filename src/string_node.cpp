@@ -40,7 +40,7 @@ libconfigfile::node_type libconfigfile::string_node::get_node_type() const {
 bool libconfigfile::string_node::polymorphic_value_compare(
     const node *other) const {
   if ((other->get_node_type()) == (node_type::String)) {
-    return ((*(dynamic_cast<const string_node *>(other))) == (*this));
+    return ((*(static_cast<const string_node *>(other))) == (*this));
   } else {
     return false;
   }
@@ -0,0 +1,126 @@
+#include "struct_decoder.hpp"
+
+#include "error_messages.hpp"
+#include "event_parser.hpp"
+#include "node_types.hpp"
+#include "numeral_system.hpp"
+#include "parse_error.hpp"
+#include "parser.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace libconfigfile {
+namespace impl {
+// Passes the values read by an event_parser to the frames of the objects
+// being decoded.
+class struct_decoder {
+private:
+  decode_frame m_root;
+  // The maps and arrays being parsed, innermost last.
+  std::vector<decode_frame> m_frames;
+
+public:
+  explicit struct_decoder(const decode_frame &root)
+      : m_root{root}, m_frames{} {}
+
+public:
+  const error_messages::error_message *
+  begin_map(const std::size_t /*offset*/) {
+    if (m_frames.empty() == true) {
+      m_frames.push_back(m_root);
+      return nullptr;
+    }
+    return begin_container(decode_event{node_type::Map, {}, 0, 0.0});
+  }
+
+  const error_messages::error_message *end_map(const std::size_t /*offset*/) {
+    m_frames.pop_back();
+    return nullptr;
+  }
+
+  const error_messages::error_message *
+  begin_array(const std::size_t /*offset*/) {
+    return begin_container(decode_event{node_type::Array, {}, 0, 0.0});
+  }
+
+  const error_messages::error_message *
+  end_array(const std::size_t /*offset*/) {
+    m_frames.pop_back();
+    return nullptr;
+  }
+
+  const error_messages::error_message *key(const std::string_view key,
+                                           const std::size_t /*offset*/) {
+    decode_frame &frame{m_frames.back()};
+    if (frame.ops != nullptr) {
+      frame.field = frame.ops->select(key);
+    }
+    return nullptr;
+  }
+
+  const error_messages::error_message *
+  string_value(const std::string_view value, const std::size_t /*offset*/) {
+    decode_frame child{};
+    return decode(decode_event{node_type::String, value, 0, 0.0}, child);
+  }
+
+  const error_messages::error_message *
+  integer_value(const std::int64_t value, const numeral_system & /*num_sys*/,
+                const std::size_t /*offset*/) {
+    decode_frame child{};
+    return decode(decode_event{node_type::Integer, {}, value, 0.0}, child);
+  }
+
+  const error_messages::error_message *
+  float_value(const double value, const std::size_t /*offset*/) {
+    decode_frame child{};
+    return decode(decode_event{node_type::Float, {}, 0, value}, child);
+  }
+
+private:
+  const error_messages::error_message *decode(const decode_event &event,
+                                              decode_frame &child) {
+    const decode_frame &frame{m_frames.back()};
+    if ((frame.ops == nullptr) || (frame.field == std::string_view::npos)) {
+      return nullptr;
+    }
+    return frame.ops->decode(frame.object, frame.field, event, child);
+  }
+
+  const error_messages::error_message *
+  begin_container(const decode_event &event) {
+    decode_frame child{nullptr, nullptr, std::string_view::npos};
+    const error_messages::error_message *ret_val{decode(event, child)};
+    m_frames.push_back(child);
+    return ret_val;
+  }
+};
+} // namespace impl
+} // namespace libconfigfile
+
+std::expected<void, libconfigfile::parse_error>
+libconfigfile::impl::decode_into(const std::string &identifier,
+                                 std::istream &input_stream,
+                                 const bool identifier_is_file_path,
+                                 const decode_frame &root) {
+  struct_decoder decoder{root};
+  return parse_events(decoder, identifier, input_stream,
+                      identifier_is_file_path,
+                      parse_options::k_default_max_nesting_depth);
+}
+
+std::expected<void, libconfigfile::parse_error>
+libconfigfile::impl::decode_file_into(const std::filesystem::path &file_path,
+                                      const decode_frame &root) {
+  std::ifstream input_stream{file_path};
+  return decode_into(file_path.string(), input_stream, true, root);
+}
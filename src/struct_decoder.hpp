@@ -0,0 +1,315 @@
+#ifndef LIBCONFIGFILE_STRUCT_DECODER_HPP
+#define LIBCONFIGFILE_STRUCT_DECODER_HPP
+
+#include "error_messages.hpp"
+#include "node_types.hpp"
+#include "parse_error.hpp"
+#include "parser.hpp"
+#include "perfect_hash.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace libconfigfile {
+// Decoding of a config straight into a struct, without building any nodes.
+//
+// The members to decode are described by specializing decode_schema, e.g.
+//   struct server { std::string host; int port{80}; };
+//   template <> struct libconfigfile::decode_schema<server> {
+//     static constexpr auto fields{libconfigfile::decode_fields(
+//         libconfigfile::decode_field<&server::host>{"host"},
+//         libconfigfile::decode_field<&server::port>{"port"})};
+//   };
+// Members may be std::strings, integers, floating-point numbers, structs with
+// a schema of their own (for maps), and std::vectors (for arrays) and
+// std::optionals of any of these. Integers and floats must be written as
+// such. Members whose keys don't appear keep the values the struct was
+// constructed with, and keys without a member are skipped.
+template <auto t_member> struct decode_field {
+  std::string_view name;
+
+  constexpr explicit decode_field(const std::string_view field_name)
+      : name{field_name} {}
+};
+
+template <auto... t_members> struct decode_field_list {
+  std::array<std::string_view, sizeof...(t_members)> names;
+};
+
+template <auto... t_members>
+constexpr decode_field_list<t_members...>
+decode_fields(const decode_field<t_members>... fields) {
+  return decode_field_list<t_members...>{{fields.name...}};
+}
+
+template <typename t_struct> struct decode_schema;
+
+namespace impl {
+// A value read from the config, as seen by a decode_frame_ops.
+struct decode_event {
+  node_type type;
+  std::string_view string;
+  std::int64_t integer;
+  double floating;
+};
+
+struct decode_frame_ops;
+
+// An object being decoded from a map or an array. Skipped values have no ops.
+struct decode_frame {
+  void *object;
+  const decode_frame_ops *ops;
+  // The member of a struct that the current key selected.
+  std::size_t field;
+};
+
+struct decode_frame_ops {
+  // Returns the field named by a key, or npos if there is none; only set for
+  // structs.
+  std::size_t (*select)(const std::string_view key);
+  // Decodes a value into the field of a struct or the next element of a
+  // vector. A map or array value sets `child` to the frame of its members.
+  const error_messages::error_message *(*decode)(void *object,
+                                                 const std::size_t field,
+                                                 const decode_event &event,
+                                                 decode_frame &child);
+};
+
+// The field names of a struct, in a perfect hash table built at compile time.
+template <std::size_t t_count> class decode_key_table {
+private:
+  std::array<std::uint32_t, perfect_hash_bucket_count(t_count)> m_pilots;
+  std::array<std::size_t, perfect_hash_slot_count(t_count)> m_slots;
+
+public:
+  consteval explicit decode_key_table(
+      const std::array<std::string_view, t_count> &names)
+      : m_pilots{}, m_slots{} {
+    for (std::size_t i{0}; i < t_count; ++i) {
+      for (std::size_t j{i + 1}; j < t_count; ++j) {
+        if (names[i] == names[j]) {
+          throw "decode_schema has two fields with the same name";
+        }
+      }
+    }
+    if (build_perfect_hash(names, m_pilots, m_slots) == false) {
+      throw "no perfect hash was found for the fields of a decode_schema";
+    }
+  }
+
+public:
+  constexpr std::size_t
+  find(const std::string_view key,
+       const std::array<std::string_view, t_count> &names) const {
+    const std::size_t field{find_perfect_hash(key, m_pilots, m_slots)};
+    return (((field != std::string_view::npos) && (names[field] == key))
+                ? (field)
+                : (std::string_view::npos));
+  }
+};
+
+template <typename t_value> struct is_optional : std::false_type {};
+
+template <typename t_value>
+struct is_optional<std::optional<t_value>> : std::true_type {};
+
+template <typename t_value> struct is_vector : std::false_type {};
+
+template <typename t_value>
+struct is_vector<std::vector<t_value>> : std::true_type {};
+
+template <typename t_value> struct is_decodable : std::false_type {};
+
+template <typename t_value>
+  requires(requires { decode_schema<t_value>::fields; })
+struct is_decodable<t_value> : std::true_type {};
+
+template <> struct is_decodable<std::string> : std::true_type {};
+
+template <std::integral t_value>
+  requires(!(std::same_as<t_value, bool>))
+struct is_decodable<t_value> : std::true_type {};
+
+template <std::floating_point t_value>
+struct is_decodable<t_value> : std::true_type {};
+
+template <typename t_value>
+struct is_decodable<std::vector<t_value>> : is_decodable<t_value> {};
+
+template <typename t_value>
+struct is_decodable<std::optional<t_value>> : is_decodable<t_value> {};
+} // namespace impl
+
+template <typename t_value>
+concept concept_decodable = impl::is_decodable<t_value>::value;
+
+namespace impl {
+template <typename t_struct,
+          typename t_field_list =
+              std::remove_cv_t<decltype(decode_schema<t_struct>::fields)>>
+struct struct_decoding;
+
+template <typename t_value> struct vector_decoding;
+
+template <concept_decodable t_value>
+constexpr const error_messages::error_message *
+decode_value(t_value &value, const decode_event &event, decode_frame &child) {
+  if constexpr (std::same_as<t_value, std::string>) {
+    if (event.type != node_type::String) {
+      return &error_messages::err_msg_2_1_1;
+    }
+    value.assign(event.string);
+  } else if constexpr (std::integral<t_value>) {
+    if (event.type != node_type::Integer) {
+      return &error_messages::err_msg_2_1_1;
+    } else if (std::in_range<t_value>(event.integer) == false) {
+      return &error_messages::err_msg_2_2_1;
+    }
+    value = static_cast<t_value>(event.integer);
+  } else if constexpr (std::floating_point<t_value>) {
+    if (event.type != node_type::Float) {
+      return &error_messages::err_msg_2_1_1;
+    }
+    value = static_cast<t_value>(event.floating);
+  } else if constexpr (is_optional<t_value>::value == true) {
+    return decode_value(value.emplace(), event, child);
+  } else if constexpr (is_vector<t_value>::value == true) {
+    if (event.type != node_type::Array) {
+      return &error_messages::err_msg_2_1_1;
+    }
+    value.clear();
+    child = decode_frame{&value,
+                         &vector_decoding<typename t_value::value_type>::k_ops,
+                         0};
+  } else {
+    if (event.type != node_type::Map) {
+      return &error_messages::err_msg_2_1_1;
+    }
+    child = decode_frame{&value, &struct_decoding<t_value>::k_ops,
+                         std::string_view::npos};
+  }
+  return nullptr;
+}
+
+template <typename t_struct, auto... t_members>
+struct struct_decoding<t_struct, decode_field_list<t_members...>> {
+  static constexpr decode_key_table<sizeof...(t_members)> k_key_table{
+      decode_schema<t_struct>::fields.names};
+
+  template <auto t_member>
+  static const error_messages::error_message *
+  decode_member(void *object, const decode_event &event,
+                decode_frame &child) {
+    return decode_value(static_cast<t_struct *>(object)->*t_member, event,
+                        child);
+  }
+
+  static constexpr std::array<const error_messages::error_message *(*)(
+                                  void *, const decode_event &, decode_frame &),
+                              sizeof...(t_members)>
+      k_members{&decode_member<t_members>...};
+
+  static std::size_t select(const std::string_view key) {
+    return k_key_table.find(key, decode_schema<t_struct>::fields.names);
+  }
+
+  static const error_messages::error_message *
+  decode(void *object, const std::size_t field, const decode_event &event,
+         decode_frame &child) {
+    return k_members[field](object, event, child);
+  }
+
+  static constexpr decode_frame_ops k_ops{&select, &decode};
+};
+
+template <typename t_value> struct vector_decoding {
+  static const error_messages::error_message *
+  decode(void *object, const std::size_t /*field*/, const decode_event &event,
+         decode_frame &child) {
+    return decode_value(
+        static_cast<std::vector<t_value> *>(object)->emplace_back(), event,
+        child);
+  }
+
+  static constexpr decode_frame_ops k_ops{nullptr, &decode};
+};
+
+std::expected<void, parse_error>
+decode_into(const std::string &identifier, std::istream &input_stream,
+            const bool identifier_is_file_path, const decode_frame &root);
+std::expected<void, parse_error>
+decode_file_into(const std::filesystem::path &file_path,
+                 const decode_frame &root);
+} // namespace impl
+
+// Decodes a config into a value-initialized t_struct. Failures are reported
+// like those of parse() and try_parse(), with values of the wrong type or out
+// of range as errors in the /error/semantic/ categories. `@include` is not
+// supported.
+template <typename t_struct>
+  requires(requires { decode_schema<t_struct>::fields; })
+std::expected<t_struct, parse_error>
+try_decode(const std::string &identifier, std::istream &input_stream,
+           const bool identifier_is_file_path = false) {
+  t_struct ret_val{};
+  std::expected<void, parse_error> result{impl::decode_into(
+      identifier, input_stream, identifier_is_file_path,
+      impl::decode_frame{&ret_val, &impl::struct_decoding<t_struct>::k_ops,
+                         std::string_view::npos})};
+  if (result.has_value() == false) {
+    return std::unexpected{std::move(result.error())};
+  }
+  return ret_val;
+}
+
+template <typename t_struct>
+  requires(requires { decode_schema<t_struct>::fields; })
+std::expected<t_struct, parse_error>
+try_decode_file(const std::filesystem::path &file_path) {
+  t_struct ret_val{};
+  std::expected<void, parse_error> result{impl::decode_file_into(
+      file_path,
+      impl::decode_frame{&ret_val, &impl::struct_decoding<t_struct>::k_ops,
+                         std::string_view::npos})};
+  if (result.has_value() == false) {
+    return std::unexpected{std::move(result.error())};
+  }
+  return ret_val;
+}
+
+template <typename t_struct>
+  requires(requires { decode_schema<t_struct>::fields; })
+t_struct decode(const std::string &identifier, std::istream &input_stream,
+                const bool identifier_is_file_path = false) {
+  std::expected<t_struct, parse_error> result{try_decode<t_struct>(
+      identifier, input_stream, identifier_is_file_path)};
+  if (result.has_value() == false) {
+    parser::impl::throw_parse_error(std::move(result.error()));
+  }
+  return std::move(result.value());
+}
+
+template <typename t_struct>
+  requires(requires { decode_schema<t_struct>::fields; })
+t_struct decode_file(const std::filesystem::path &file_path) {
+  std::expected<t_struct, parse_error> result{
+      try_decode_file<t_struct>(file_path)};
+  if (result.has_value() == false) {
+    parser::impl::throw_parse_error(std::move(result.error()));
+  }
+  return std::move(result.value());
+}
+} // namespace libconfigfile
+
+#endif
@@ -1,49 +1,92 @@
 #include "syntax_error.hpp"
 
+#include "error_messages.hpp"
+#include "parse_error.hpp"
+
 #include <exception>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 
-libconfigfile::syntax_error::syntax_error(const std::string &message,
-                                          const std::string &category,
+libconfigfile::syntax_error::syntax_error(const error_code code,
                                           const std::string &file_path,
                                           const long long pos_line,
                                           const long long pos_char)
-    : base_t{file_path + m_k_separator_char + std::to_string(pos_line) +
-             m_k_separator_char + std::to_string(pos_char) +
-             m_k_separator_char + m_k_whitespace_char + category +
-             m_k_separator_char + m_k_whitespace_char + message},
-      m_message{message}, m_category{category}, m_file_path{file_path},
-      m_pos_line{pos_line}, m_pos_char{pos_char} {}
+    : base_t{""}, m_code{code}, m_file_path{file_path}, m_pos_line{pos_line},
+      m_pos_char{pos_char}, m_what{} {}
+
+libconfigfile::syntax_error::syntax_error(
+    const error_messages::error_message &error, const std::string &file_path,
+    const long long pos_line, const long long pos_char)
+    : syntax_error{error.code, file_path, pos_line, pos_char} {}
+
+libconfigfile::syntax_error::syntax_error(const parse_error &error)
+    : syntax_error{error.m_code, error.m_file_path, error.m_pos_line,
+                   error.m_pos_char} {}
+
+libconfigfile::syntax_error::syntax_error(parse_error &&error)
+    : base_t{""}, m_code{error.m_code},
+      m_file_path{std::move(error.m_file_path)},
+      m_pos_line{error.m_pos_line}, m_pos_char{error.m_pos_char}, m_what{} {}
 
 libconfigfile::syntax_error::syntax_error(const syntax_error &other)
-    : std::runtime_error{other} {}
+    : base_t{other}, m_code{other.m_code}, m_file_path{other.m_file_path},
+      m_pos_line{other.m_pos_line}, m_pos_char{other.m_pos_char},
+      m_what{other.m_what} {}
 
 libconfigfile::syntax_error::~syntax_error() {}
 
 libconfigfile::syntax_error &
 libconfigfile::syntax_error::operator=(const syntax_error &other) {
   if (this != &other) {
-    std::runtime_error::operator=(other);
-    m_message = other.m_message;
-    m_category = other.m_category;
+    base_t::operator=(other);
+    m_code = other.m_code;
     m_file_path = other.m_file_path;
     m_pos_line = other.m_pos_line;
     m_pos_char = other.m_pos_char;
+    m_what = other.m_what;
   }
   return *this;
 }
 
 const char *libconfigfile::syntax_error::what() const noexcept {
-  return std::runtime_error::what();
+  if (m_what.empty() == true) {
+    try {
+      const error_messages::error_message *const error{
+          error_messages::find_error_message(m_code)};
+      m_what.append(m_file_path)
+          .append(1, m_k_separator_char)
+          .append(std::to_string(m_pos_line))
+          .append(1, m_k_separator_char)
+          .append(std::to_string(m_pos_char))
+          .append(1, m_k_separator_char)
+          .append(1, m_k_whitespace_char)
+          .append(error->category)
+          .append(1, m_k_separator_char)
+          .append(1, m_k_whitespace_char)
+          .append(error->message);
+    } catch (...) {
+      m_what.clear();
+      return error_messages::find_error_message(m_code)->message.data();
+    }
+  }
+  return m_what.c_str();
 }
 
-std::string libconfigfile::syntax_error::message() const { return m_message; }
+libconfigfile::error_code libconfigfile::syntax_error::code() const {
+  return m_code;
+}
+
+std::string_view libconfigfile::syntax_error::message() const {
+  return error_messages::find_error_message(m_code)->message;
+}
 
-std::string libconfigfile::syntax_error::category() const { return m_category; }
+std::string_view libconfigfile::syntax_error::category() const {
+  return error_messages::find_error_message(m_code)->category;
+}
 
-std::string libconfigfile::syntax_error::file_path() const {
+const std::string &libconfigfile::syntax_error::file_path() const {
   return m_file_path;
 }
 
@@ -1,9 +1,13 @@
 #ifndef LIBCONFIGFILE_SYNTAX_ERROR_HPP
 #define LIBCONFIGFILE_SYNTAX_ERROR_HPP
 
+#include "error_messages.hpp"
+#include "parse_error.hpp"
+
 #include <exception>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 namespace libconfigfile {
 class syntax_error : public std::runtime_error {
@@ -15,16 +19,22 @@ private:
   static constexpr char m_k_whitespace_char{' '};
 
 private:
-  std::string m_message;
-  std::string m_category;
+  error_code m_code;
   std::string m_file_path;
   long long m_pos_line;
   long long m_pos_char;
+  // Formatted by what() on first call; not safe to call concurrently on the
+  // same object before that.
+  mutable std::string m_what;
 
 public:
-  explicit syntax_error(const std::string &message, const std::string &category,
+  explicit syntax_error(const error_code code, const std::string &file_path,
+                        const long long pos_line, const long long pos_char);
+  explicit syntax_error(const error_messages::error_message &error,
                         const std::string &file_path, const long long pos_line,
                         const long long pos_char);
+  explicit syntax_error(const parse_error &error);
+  explicit syntax_error(parse_error &&error);
 
   syntax_error(const syntax_error &other);
 
@@ -35,9 +45,10 @@ public:
 
 public:
   virtual const char *what() const noexcept override;
-  std::string message() const;
-  std::string category() const;
-  std::string file_path() const;
+  error_code code() const;
+  std::string_view message() const;
+  std::string_view category() const;
+  const std::string &file_path() const;
   long long pos_line() const;
   long long pos_char() const;
 };
@@ -0,0 +1,490 @@
+#include "wire_format.hpp"
+
+#include "array_node.hpp"
+#include "float_node.hpp"
+#include "integer_node.hpp"
+#include "map_node.hpp"
+#include "node.hpp"
+#include "node_ptr.hpp"
+#include "node_types.hpp"
+#include "numeral_system.hpp"
+#include "string_node.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace libconfigfile {
+namespace impl {
+// Counts read from the wire aren't trusted any further than this when
+// reserving space; larger containers and strings grow as their data arrives.
+static constexpr std::uint64_t k_wire_max_reserve{4096};
+static constexpr std::size_t k_wire_chunk_size{65536};
+
+[[noreturn]] static void throw_malformed_wire_data() {
+  throw std::runtime_error{"wire data is malformed"};
+}
+
+static std::uint8_t wire_num_sys_code(const numeral_system *num_sys) {
+  switch (num_sys->base) {
+  case 2: {
+    return wire_format::k_num_sys_binary;
+  } break;
+  case 8: {
+    return wire_format::k_num_sys_octal;
+  } break;
+  case 16: {
+    return wire_format::k_num_sys_hexadecimal;
+  } break;
+  default: {
+    return wire_format::k_num_sys_decimal;
+  } break;
+  }
+}
+
+static const numeral_system *wire_num_sys(const std::uint8_t num_sys) {
+  switch (num_sys) {
+  case wire_format::k_num_sys_decimal: {
+    return &numeral_system_decimal;
+  } break;
+  case wire_format::k_num_sys_binary: {
+    return &numeral_system_binary;
+  } break;
+  case wire_format::k_num_sys_octal: {
+    return &numeral_system_octal;
+  } break;
+  case wire_format::k_num_sys_hexadecimal: {
+    return &numeral_system_hexadecimal;
+  } break;
+  default: {
+    throw_malformed_wire_data();
+  } break;
+  }
+}
+} // namespace impl
+} // namespace libconfigfile
+
+libconfigfile::wire_encoder::wire_encoder(const map_node &root)
+    : m_root{&root}, m_stack{}, m_token{}, m_token_pos{0}, m_token_size{0},
+      m_bytes{}, m_is_started{false} {}
+
+libconfigfile::wire_encoder::~wire_encoder() {}
+
+std::size_t libconfigfile::wire_encoder::encode(char *buffer,
+                                                const std::size_t buffer_size) {
+  std::size_t written{0};
+  while (written < buffer_size) {
+    if (m_token_pos < m_token_size) {
+      const std::size_t count{
+          std::min(m_token_size - m_token_pos, buffer_size - written)};
+      std::memcpy(buffer + written, m_token.data() + m_token_pos, count);
+      m_token_pos += count;
+      written += count;
+    } else if (m_bytes.empty() == false) {
+      const std::size_t count{std::min(m_bytes.size(), buffer_size - written)};
+      std::memcpy(buffer + written, m_bytes.data(), count);
+      m_bytes.remove_prefix(count);
+      written += count;
+    } else if (next_token() == false) {
+      break;
+    }
+  }
+  return written;
+}
+
+bool libconfigfile::wire_encoder::is_complete() const {
+  return ((m_is_started == true) && (m_stack.empty() == true) &&
+          (m_token_pos == m_token_size) && (m_bytes.empty() == true));
+}
+
+bool libconfigfile::wire_encoder::next_token() {
+  m_token_pos = 0;
+  m_token_size = 0;
+
+  if (m_is_started == false) {
+    m_is_started = true;
+    put_byte(wire_format::k_version);
+    begin_value(m_root);
+    return true;
+  }
+
+  while (m_stack.empty() == false) {
+    frame &top{m_stack.back()};
+    if (top.container->get_node_type() == node_type::Array) {
+      const array_node &array{
+          *(static_cast<const array_node *>(top.container))};
+      if (top.array_pos < array.size()) {
+        begin_value(array[top.array_pos++].get());
+        return true;
+      }
+    } else {
+      const map_node &map{*(static_cast<const map_node *>(top.container))};
+      if (top.map_pos != map.end()) {
+        if (top.is_key_written == false) {
+          put_varint(top.map_pos->first.size());
+          m_bytes = top.map_pos->first;
+          top.is_key_written = true;
+        } else {
+          const node *value{top.map_pos->second.get()};
+          ++top.map_pos;
+          top.is_key_written = false;
+          begin_value(value);
+        }
+        return true;
+      }
+    }
+    m_stack.pop_back();
+  }
+  return false;
+}
+
+void libconfigfile::wire_encoder::begin_value(const node *value) {
+  if (value == nullptr) {
+    put_byte(static_cast<std::uint8_t>(node_type::Null));
+    return;
+  }
+
+  switch (value->get_node_type()) {
+  case node_type::String: {
+    const std::string_view str{*(static_cast<const string_node *>(value))};
+    put_byte(static_cast<std::uint8_t>(node_type::String));
+    put_varint(str.size());
+    m_bytes = str;
+  } break;
+
+  case node_type::Integer: {
+    const integer_node *integer{static_cast<const integer_node *>(value)};
+    const std::uint64_t bits{std::bit_cast<std::uint64_t>(integer->get())};
+    put_byte(static_cast<std::uint8_t>(
+        static_cast<std::uint8_t>(node_type::Integer) |
+        (impl::wire_num_sys_code(integer->get_num_sys()) << 4)));
+    put_varint((bits << 1) ^ (0 - (bits >> 63)));
+  } break;
+
+  case node_type::Float: {
+    const std::uint64_t bits{std::bit_cast<std::uint64_t>(
+        static_cast<const float_node *>(value)->get())};
+    put_byte(static_cast<std::uint8_t>(node_type::Float));
+    for (std::size_t i{0}; i < sizeof(bits); ++i) {
+      put_byte(static_cast<std::uint8_t>(bits >> (i * 8)));
+    }
+  } break;
+
+  case node_type::Array: {
+    put_byte(static_cast<std::uint8_t>(node_type::Array));
+    put_varint(static_cast<const array_node *>(value)->size());
+    m_stack.push_back(frame{value, 0, map_node::const_iterator{}, false});
+  } break;
+
+  case node_type::Map: {
+    const map_node &map{*(static_cast<const map_node *>(value))};
+    put_byte(static_cast<std::uint8_t>(node_type::Map));
+    put_varint(map.size());
+    m_stack.push_back(frame{value, 0, map.begin(), false});
+  } break;
+
+  default: {
+    put_byte(static_cast<std::uint8_t>(node_type::Null));
+  } break;
+  }
+}
+
+void libconfigfile::wire_encoder::put_byte(const std::uint8_t byte) {
+  m_token[m_token_size++] = static_cast<char>(byte);
+}
+
+void libconfigfile::wire_encoder::put_varint(std::uint64_t value) {
+  while (value >= 0x80) {
+    put_byte(static_cast<std::uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  put_byte(static_cast<std::uint8_t>(value));
+}
+
+libconfigfile::wire_decoder::wire_decoder(
+    const std::size_t max_nesting_depth /*=
+        parser::parse_options::k_default_max_nesting_depth*/)
+    : m_max_nesting_depth{max_nesting_depth}, m_root{nullptr}, m_stack{},
+      m_state{state::version}, m_tag{0},
+      m_varint_target{varint_target::integer}, m_varint{0}, m_varint_shift{0},
+      m_float_bytes{}, m_float_byte_count{0}, m_string{},
+      m_string_target{nullptr}, m_string_remaining{0} {}
+
+libconfigfile::wire_decoder::~wire_decoder() {}
+
+std::size_t libconfigfile::wire_decoder::decode(const std::string_view data) {
+  std::size_t pos{0};
+  while ((pos < data.size()) && (m_state != state::complete)) {
+    switch (m_state) {
+    case state::version: {
+      if (static_cast<std::uint8_t>(data[pos]) != wire_format::k_version) {
+        throw std::runtime_error{"wire data version is not supported"};
+      }
+      ++pos;
+      m_state = state::tag;
+    } break;
+
+    case state::tag: {
+      m_tag = static_cast<std::uint8_t>(data[pos]);
+      ++pos;
+      begin_value();
+    } break;
+
+    case state::varint: {
+      const std::uint8_t byte{static_cast<std::uint8_t>(data[pos])};
+      ++pos;
+      if ((m_varint_shift == 63) && (byte > 1)) {
+        impl::throw_malformed_wire_data();
+      }
+      m_varint |= (std::uint64_t{byte} & 0x7f) << m_varint_shift;
+      if ((byte & 0x80) != 0) {
+        m_varint_shift += 7;
+      } else {
+        end_varint();
+      }
+    } break;
+
+    case state::float_bytes: {
+      const std::size_t count{std::min(
+          m_float_bytes.size() - m_float_byte_count, data.size() - pos)};
+      std::memcpy(m_float_bytes.data() + m_float_byte_count, data.data() + pos,
+                  count);
+      m_float_byte_count += count;
+      pos += count;
+      if (m_float_byte_count == m_float_bytes.size()) {
+        std::uint64_t bits{0};
+        for (std::size_t i{0}; i < m_float_bytes.size(); ++i) {
+          bits |= std::uint64_t{static_cast<std::uint8_t>(m_float_bytes[i])}
+                  << (i * 8);
+        }
+        end_value(make_node_ptr<float_node>(std::bit_cast<double>(bits)));
+      }
+    } break;
+
+    case state::string_bytes: {
+      const std::size_t count{static_cast<std::size_t>(
+          std::min<std::uint64_t>(m_string_remaining, data.size() - pos))};
+      m_string_target->append(data.data() + pos, count);
+      m_string_remaining -= count;
+      pos += count;
+      if (m_string_remaining == 0) {
+        end_string();
+      }
+    } break;
+
+    default: {
+    } break;
+    }
+  }
+  return pos;
+}
+
+bool libconfigfile::wire_decoder::is_complete() const {
+  return (m_state == state::complete);
+}
+
+libconfigfile::node_ptr<libconfigfile::map_node>
+libconfigfile::wire_decoder::take_root() {
+  if (is_complete() == false) {
+    throw std::logic_error{"wire_decoder::take_root"};
+  }
+  node_ptr<map_node> ret_val{std::move(m_root)};
+  reset();
+  return ret_val;
+}
+
+void libconfigfile::wire_decoder::reset() {
+  m_root = node_ptr<map_node>{nullptr};
+  m_stack.clear();
+  m_state = state::version;
+  m_string.clear();
+  m_string_target = nullptr;
+}
+
+void libconfigfile::wire_decoder::begin_value() {
+  const node_type type{static_cast<node_type>(m_tag & 0x0f)};
+  if (((type != node_type::Integer) && ((m_tag >> 4) != 0)) ||
+      ((m_stack.empty() == true) && (type != node_type::Map))) {
+    impl::throw_malformed_wire_data();
+  }
+
+  switch (type) {
+  case node_type::String: {
+    begin_varint(varint_target::string_length);
+  } break;
+
+  case node_type::Integer: {
+    begin_varint(varint_target::integer);
+  } break;
+
+  case node_type::Float: {
+    m_state = state::float_bytes;
+    m_float_byte_count = 0;
+  } break;
+
+  case node_type::Array: {
+    begin_varint(varint_target::array_count);
+  } break;
+
+  case node_type::Map: {
+    begin_varint(varint_target::map_count);
+  } break;
+
+  case node_type::Null: {
+    end_value(node_ptr<node>{nullptr});
+  } break;
+
+  default: {
+    impl::throw_malformed_wire_data();
+  } break;
+  }
+}
+
+void libconfigfile::wire_decoder::begin_varint(const varint_target target) {
+  m_state = state::varint;
+  m_varint_target = target;
+  m_varint = 0;
+  m_varint_shift = 0;
+}
+
+void libconfigfile::wire_decoder::end_varint() {
+  switch (m_varint_target) {
+  case varint_target::string_length: {
+    begin_string(&m_string, m_varint);
+  } break;
+
+  case varint_target::key_length: {
+    begin_string(&(m_stack.back().key), m_varint);
+  } break;
+
+  case varint_target::integer: {
+    end_value(make_node_ptr<integer_node>(
+        std::bit_cast<std::int64_t>((m_varint >> 1) ^ (0 - (m_varint & 1))),
+        impl::wire_num_sys(static_cast<std::uint8_t>(m_tag >> 4))));
+  } break;
+
+  case varint_target::array_count: {
+    node_ptr<array_node> array{make_node_ptr<array_node>()};
+    array->reserve(static_cast<std::size_t>(
+        std::min(m_varint, impl::k_wire_max_reserve)));
+    begin_container(std::move(array), m_varint);
+  } break;
+
+  case varint_target::map_count: {
+    node_ptr<map_node> map{make_node_ptr<map_node>()};
+    map->reserve(static_cast<std::size_t>(
+        std::min(m_varint, impl::k_wire_max_reserve)));
+    begin_container(std::move(map), m_varint);
+  } break;
+  }
+}
+
+void libconfigfile::wire_decoder::begin_string(std::string *target,
+                                               const std::uint64_t length) {
+  target->clear();
+  target->reserve(
+      static_cast<std::size_t>(std::min(length, impl::k_wire_max_reserve)));
+  m_string_target = target;
+  m_string_remaining = length;
+  m_state = state::string_bytes;
+  if (length == 0) {
+    end_string();
+  }
+}
+
+void libconfigfile::wire_decoder::end_string() {
+  if (m_string_target == &m_string) {
+    end_value(make_node_ptr<string_node>(std::move(m_string)));
+    m_string.clear();
+  } else {
+    m_stack.back().is_key_read = true;
+    m_state = state::tag;
+  }
+}
+
+void libconfigfile::wire_decoder::attach_value(node_ptr<node> value) {
+  frame &top{m_stack.back()};
+  if (top.container->get_node_type() == node_type::Array) {
+    static_cast<array_node *>(top.container)->push_back(std::move(value));
+  } else {
+    if (static_cast<map_node *>(top.container)
+            ->insert({std::move(top.key), std::move(value)})
+            .second == false) {
+      impl::throw_malformed_wire_data();
+    }
+    top.is_key_read = false;
+  }
+  --top.remaining;
+}
+
+void libconfigfile::wire_decoder::end_value(node_ptr<node> value) {
+  attach_value(std::move(value));
+  pop_complete_frames();
+  expect_next();
+}
+
+void libconfigfile::wire_decoder::begin_container(node_ptr<node> container,
+                                                  const std::uint64_t count) {
+  if (m_stack.size() >= m_max_nesting_depth) {
+    throw std::runtime_error{"wire data is nested too deeply"};
+  }
+
+  node *const raw_container{container.get()};
+  if (m_stack.empty() == true) {
+    m_root = node_ptr_cast<map_node>(std::move(container));
+    m_root->set_is_root_map(true);
+  } else {
+    attach_value(std::move(container));
+  }
+
+  if (count > 0) {
+    m_stack.push_back(frame{raw_container, count, std::string{}, false});
+  }
+  pop_complete_frames();
+  expect_next();
+}
+
+void libconfigfile::wire_decoder::pop_complete_frames() {
+  while ((m_stack.empty() == false) && (m_stack.back().remaining == 0)) {
+    m_stack.pop_back();
+  }
+}
+
+void libconfigfile::wire_decoder::expect_next() {
+  if (m_stack.empty() == true) {
+    m_state = state::complete;
+  } else if ((m_stack.back().container->get_node_type() == node_type::Map) &&
+             (m_stack.back().is_key_read == false)) {
+    begin_varint(varint_target::key_length);
+  } else {
+    m_state = state::tag;
+  }
+}
+
+std::string libconfigfile::encode_wire(const map_node &root) {
+  wire_encoder encoder{root};
+  std::string ret_val{};
+  while (encoder.is_complete() == false) {
+    const std::size_t old_size{ret_val.size()};
+    ret_val.resize(old_size + impl::k_wire_chunk_size);
+    ret_val.resize(old_size + encoder.encode(ret_val.data() + old_size,
+                                             impl::k_wire_chunk_size));
+  }
+  return ret_val;
+}
+
+libconfigfile::node_ptr<libconfigfile::map_node>
+libconfigfile::decode_wire(const std::string_view data) {
+  wire_decoder decoder{};
+  if ((decoder.decode(data) != data.size()) ||
+      (decoder.is_complete() == false)) {
+    impl::throw_malformed_wire_data();
+  }
+  return decoder.take_root();
+}
@@ -0,0 +1,175 @@
+#ifndef LIBCONFIGFILE_WIRE_FORMAT_HPP
+#define LIBCONFIGFILE_WIRE_FORMAT_HPP
+
+#include "map_node.hpp"
+#include "node.hpp"
+#include "node_ptr.hpp"
+#include "parser.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libconfigfile {
+// A compact encoding of a node tree for sending it to another process.
+//
+// A message is a version byte followed by the root map. Every value starts
+// with a tag byte whose low nibble is its node_type; for integers, the high
+// nibble is the numeral system (see k_num_sys_*). The tag is followed by:
+//  - String: the length as a varint, then the bytes
+//  - Integer: the value zigzag-encoded as a varint
+//  - Float: the 8 bytes of the IEEE double, little-endian
+//  - Array: the element count as a varint, then the elements
+//  - Map: the member count as a varint, then for each member the key's length
+//    as a varint, the key's bytes and the value
+//  - Null: nothing
+// Varints are unsigned LEB128: 7 bits per byte, least significant first, with
+// the high bit set on every byte but the last.
+namespace wire_format {
+static constexpr std::uint8_t k_version{1};
+
+static constexpr std::uint8_t k_num_sys_decimal{0};
+static constexpr std::uint8_t k_num_sys_binary{1};
+static constexpr std::uint8_t k_num_sys_octal{2};
+static constexpr std::uint8_t k_num_sys_hexadecimal{3};
+
+// A version byte, a tag and a varint.
+static constexpr std::size_t k_max_token_size{12};
+} // namespace wire_format
+
+// Encodes a tree into buffers of any size, e.g. as a socket becomes writable.
+// The tree must not be modified or destroyed while it is being encoded.
+class wire_encoder {
+private:
+  struct frame {
+    const node *container;
+    std::size_t array_pos;
+    map_node::const_iterator map_pos;
+    bool is_key_written;
+  };
+
+private:
+  const map_node *m_root;
+  std::vector<frame> m_stack;
+  std::array<char, wire_format::k_max_token_size> m_token;
+  std::size_t m_token_pos;
+  std::size_t m_token_size;
+  // The bytes of the string or key following the token, if any.
+  std::string_view m_bytes;
+  bool m_is_started;
+
+public:
+  explicit wire_encoder(const map_node &root);
+  wire_encoder(const wire_encoder &other) = delete;
+  wire_encoder(wire_encoder &&other) = delete;
+
+  ~wire_encoder();
+
+public:
+  wire_encoder &operator=(const wire_encoder &other) = delete;
+  wire_encoder &operator=(wire_encoder &&other) = delete;
+
+public:
+  // Writes up to `buffer_size` bytes of the message and returns how many were
+  // written, which is less than `buffer_size` only once the message is done.
+  std::size_t encode(char *buffer, const std::size_t buffer_size);
+  bool is_complete() const;
+
+private:
+  bool next_token();
+  void begin_value(const node *value);
+  void put_byte(const std::uint8_t byte);
+  void put_varint(std::uint64_t value);
+};
+
+// Decodes a message from buffers of any size, e.g. as they arrive from a
+// socket. Bytes are consumed as they are fed, so no more than one value's
+// token is ever buffered, and strings are copied straight into their nodes.
+// std::runtime_error is thrown if the data is malformed.
+class wire_decoder {
+private:
+  enum class state {
+    version,
+    tag,
+    varint,
+    float_bytes,
+    string_bytes,
+    complete,
+  };
+
+  enum class varint_target {
+    string_length,
+    key_length,
+    integer,
+    array_count,
+    map_count,
+  };
+
+  struct frame {
+    node *container;
+    std::uint64_t remaining;
+    std::string key;
+    bool is_key_read;
+  };
+
+private:
+  std::size_t m_max_nesting_depth;
+  node_ptr<map_node> m_root;
+  std::vector<frame> m_stack;
+  state m_state;
+  std::uint8_t m_tag;
+  varint_target m_varint_target;
+  std::uint64_t m_varint;
+  unsigned m_varint_shift;
+  std::array<char, sizeof(double)> m_float_bytes;
+  std::size_t m_float_byte_count;
+  std::string m_string;
+  std::string *m_string_target;
+  std::uint64_t m_string_remaining;
+
+public:
+  explicit wire_decoder(
+      const std::size_t max_nesting_depth =
+          parser::parse_options::k_default_max_nesting_depth);
+  wire_decoder(const wire_decoder &other) = delete;
+  wire_decoder(wire_decoder &&other) = delete;
+
+  ~wire_decoder();
+
+public:
+  wire_decoder &operator=(const wire_decoder &other) = delete;
+  wire_decoder &operator=(wire_decoder &&other) = delete;
+
+public:
+  // Consumes bytes of the message and returns how many were consumed, which is
+  // less than `data.size()` only once the message is complete; the rest
+  // belongs to whatever follows it.
+  std::size_t decode(const std::string_view data);
+  bool is_complete() const;
+  // Returns the decoded root map and makes the decoder ready for another
+  // message. Throws std::logic_error if the message isn't complete.
+  node_ptr<map_node> take_root();
+
+private:
+  void reset();
+  void begin_value();
+  void begin_varint(const varint_target target);
+  void end_varint();
+  void begin_string(std::string *target, const std::uint64_t length);
+  void end_string();
+  void attach_value(node_ptr<node> value);
+  void end_value(node_ptr<node> value);
+  void begin_container(node_ptr<node> container, const std::uint64_t count);
+  void pop_complete_frames();
+  void expect_next();
+};
+
+std::string encode_wire(const map_node &root);
+// Throws std::runtime_error if `data` isn't exactly one complete message.
+node_ptr<map_node> decode_wire(const std::string_view data);
+} // namespace libconfigfile
+
+#endif